@@ -291,6 +291,7 @@ void AddrManImpl::Unserialize(Stream& s_)
         mapAddr[info] = n;
         info.nRandomPos = vRandom.size();
         vRandom.push_back(n);
+        m_size = vRandom.size();
     }
     nIdCount = nNew;
 
@@ -306,6 +307,7 @@ void AddrManImpl::Unserialize(Stream& s_)
             info.nRandomPos = vRandom.size();
             info.fInTried = true;
             vRandom.push_back(nIdCount);
+            m_size = vRandom.size();
             mapInfo[nIdCount] = info;
             mapAddr[info] = nIdCount;
             vvTried[nKBucket][nKBucketPos] = nIdCount;
@@ -425,6 +427,7 @@ AddrInfo* AddrManImpl::Create(const CAddress& addr, const CNetAddr& addrSource,
     mapAddr[addr] = nId;
     mapInfo[nId].nRandomPos = vRandom.size();
     vRandom.push_back(nId);
+    m_size = vRandom.size();
     if (pnId)
         *pnId = nId;
     return &mapInfo[nId];
@@ -465,6 +468,7 @@ void AddrManImpl::Delete(int nId)
 
     SwapRandom(info.nRandomPos, vRandom.size() - 1);
     vRandom.pop_back();
+    m_size = vRandom.size();
     mapAddr.erase(info);
     mapInfo.erase(nId);
     nNew--;
@@ -543,7 +547,28 @@ void AddrManImpl::MakeTried(AddrInfo& info, int nId)
     info.fInTried = true;
 }
 
-bool AddrManImpl::AddSingle(const CAddress& addr, const CNetAddr& source, std::chrono::seconds time_penalty)
+std::vector<std::optional<AddrManImpl::NewPosition>> AddrManImpl::GetNewPositions(const std::vector<CAddress>& vAddr, const CNetAddr& source) const
+{
+    AssertLockNotHeld(cs);
+
+    std::vector<std::optional<NewPosition>> ret;
+    ret.reserve(vAddr.size());
+    for (const CAddress& addr : vAddr) {
+        if (!addr.IsRoutable()) {
+            ret.emplace_back(std::nullopt);
+            continue;
+        }
+        // An AddrInfo created from addr (see Create()) would hash identically, as
+        // the bucketing functions only look at the address, port and source.
+        const AddrInfo info{addr, source};
+        const int bucket{info.GetNewBucket(nKey, source, m_netgroupman)};
+        ret.push_back(NewPosition{bucket, info.GetBucketPosition(nKey, true, bucket)});
+    }
+    return ret;
+}
+
+bool AddrManImpl::AddSingle(const CAddress& addr, const CNetAddr& source, std::chrono::seconds time_penalty,
+                            const NewPosition& new_pos)
 {
     AssertLockHeld(cs);
 
@@ -594,8 +619,8 @@ bool AddrManImpl::AddSingle(const CAddress& addr, const CNetAddr& source, std::c
         nNew++;
     }
 
-    int nUBucket = pinfo->GetNewBucket(nKey, source, m_netgroupman);
-    int nUBucketPos = pinfo->GetBucketPosition(nKey, true, nUBucket);
+    const int nUBucket{new_pos.bucket};
+    const int nUBucketPos{new_pos.position};
     bool fInsert = vvNew[nUBucket][nUBucketPos] == -1;
     if (vvNew[nUBucket][nUBucketPos] != nId) {
         if (!fInsert) {
@@ -674,11 +699,14 @@ bool AddrManImpl::Good_(const CService& addr, bool test_before_evict, NodeSecond
     }
 }
 
-bool AddrManImpl::Add_(const std::vector<CAddress>& vAddr, const CNetAddr& source, std::chrono::seconds time_penalty)
+bool AddrManImpl::Add_(const std::vector<CAddress>& vAddr, const CNetAddr& source, std::chrono::seconds time_penalty,
+                       const std::vector<std::optional<NewPosition>>& new_positions)
 {
+    Assume(new_positions.size() == vAddr.size());
     int added{0};
-    for (std::vector<CAddress>::const_iterator it = vAddr.begin(); it != vAddr.end(); it++) {
-        added += AddSingle(*it, source, time_penalty) ? 1 : 0;
+    for (size_t i = 0; i < vAddr.size(); ++i) {
+        if (!new_positions[i]) continue;
+        added += AddSingle(vAddr[i], source, time_penalty, *new_positions[i]) ? 1 : 0;
     }
     if (added > 0) {
         LogPrint(BCLog::ADDRMAN, "Added %i addresses (of %i) from %s: %i tried, %i new\n", added, vAddr.size(), source.ToString(), nTried, nNew);
@@ -1070,15 +1098,18 @@ int AddrManImpl::CheckAddrman() const
 
 size_t AddrManImpl::size() const
 {
-    LOCK(cs); // TODO: Cache this in an atomic to avoid this overhead
-    return vRandom.size();
+    return m_size;
 }
 
 bool AddrManImpl::Add(const std::vector<CAddress>& vAddr, const CNetAddr& source, std::chrono::seconds time_penalty)
 {
+    // Hashing addresses into buckets is the bulk of the work for gossiped
+    // addresses, so do it before taking the lock that Select/GetAddr also need.
+    const auto new_positions{GetNewPositions(vAddr, source)};
+
     LOCK(cs);
     Check();
-    auto ret = Add_(vAddr, source, time_penalty);
+    auto ret = Add_(vAddr, source, time_penalty, new_positions);
     Check();
     return ret;
 }
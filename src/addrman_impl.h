@@ -15,6 +15,7 @@
 #include <uint256.h>
 #include <util/time.h>
 
+#include <atomic>
 #include <cstdint>
 #include <optional>
 #include <set>
@@ -191,6 +192,10 @@ private:
     //! changes to it (even in const methods) are also unobservable.
     mutable std::vector<int> vRandom GUARDED_BY(cs);
 
+    //! Number of entries in vRandom, readable without taking cs (it is
+    //! polled frequently, e.g. by the connection-opening logic).
+    std::atomic<size_t> m_size{0};
+
     // number of "tried" entries
     int nTried GUARDED_BY(cs){0};
 
@@ -233,13 +238,28 @@ private:
     //! Move an entry from the "new" table(s) to the "tried" table
     void MakeTried(AddrInfo& info, int nId) EXCLUSIVE_LOCKS_REQUIRED(cs);
 
+    //! Position of an address in the "new" table, as computed by GetNewBucket() and GetBucketPosition().
+    struct NewPosition {
+        int bucket;
+        int position;
+    };
+
+    /** Compute the "new" table position of each routable address in vAddr
+     *  (std::nullopt for others). This only depends on nKey, the netgroup
+     *  manager and the addresses, so it is done without holding cs. */
+    std::vector<std::optional<NewPosition>> GetNewPositions(const std::vector<CAddress>& vAddr, const CNetAddr& source) const
+        EXCLUSIVE_LOCKS_REQUIRED(!cs);
+
     /** Attempt to add a single address to addrman's new table.
-     *  @see AddrMan::Add() for parameters. */
-    bool AddSingle(const CAddress& addr, const CNetAddr& source, std::chrono::seconds time_penalty) EXCLUSIVE_LOCKS_REQUIRED(cs);
+     *  @see AddrMan::Add() for parameters.
+     *  @param[in] new_pos  The address' position in the new table, as returned by GetNewPositions(). */
+    bool AddSingle(const CAddress& addr, const CNetAddr& source, std::chrono::seconds time_penalty,
+                   const NewPosition& new_pos) EXCLUSIVE_LOCKS_REQUIRED(cs);
 
     bool Good_(const CService& addr, bool test_before_evict, NodeSeconds time) EXCLUSIVE_LOCKS_REQUIRED(cs);
 
-    bool Add_(const std::vector<CAddress>& vAddr, const CNetAddr& source, std::chrono::seconds time_penalty) EXCLUSIVE_LOCKS_REQUIRED(cs);
+    bool Add_(const std::vector<CAddress>& vAddr, const CNetAddr& source, std::chrono::seconds time_penalty,
+              const std::vector<std::optional<NewPosition>>& new_positions) EXCLUSIVE_LOCKS_REQUIRED(cs);
 
     void Attempt_(const CService& addr, bool fCountFailure, NodeSeconds time) EXCLUSIVE_LOCKS_REQUIRED(cs);
 
@@ -9,7 +9,9 @@
 #include <util/check.h>
 #include <util/time.h>
 
+#include <atomic>
 #include <optional>
+#include <thread>
 #include <vector>
 
 /* A "source" is a source address from which we have received a bunch of other addresses. */
@@ -133,7 +135,33 @@ static void AddrManAddThenGood(benchmark::Bench& bench)
     });
 }
 
+static void AddrManAddWithConcurrentSelect(benchmark::Bench& bench)
+{
+    // Model a node that processes gossiped addresses on the message handler
+    // thread while the connection-opening thread keeps calling Select() and
+    // size(), which contend for the same lock.
+    CreateAddresses();
+
+    AddrMan addrman{EMPTY_NETGROUPMAN, /*deterministic=*/false, ADDRMAN_CONSISTENCY_CHECK_RATIO};
+    AddAddressesToAddrMan(addrman);
+
+    std::atomic<bool> stop{false};
+    std::thread selector{[&] {
+        while (!stop) {
+            if (addrman.size() > 0) (void)addrman.Select();
+        }
+    }};
+
+    bench.run([&] {
+        AddAddressesToAddrMan(addrman);
+    });
+
+    stop = true;
+    selector.join();
+}
+
 BENCHMARK(AddrManAdd);
+BENCHMARK(AddrManAddWithConcurrentSelect);
 BENCHMARK(AddrManSelect);
 BENCHMARK(AddrManGetAddr);
 BENCHMARK(AddrManAddThenGood);
@@ -150,6 +150,20 @@ static void MuHashPrecompute(benchmark::Bench& bench)
     });
 }
 
+static void MuHashFinalize(benchmark::Bench& bench)
+{
+    FastRandomContext rng(true);
+    MuHash3072 acc{rng.randbytes(32)};
+    acc /= MuHash3072(rng.rand256());
+
+    bench.run([&] {
+        // Finalizing divides by the denominator, which requires a modular inversion.
+        uint256 out;
+        acc.Finalize(out);
+        acc /= MuHash3072(out);
+    });
+}
+
 BENCHMARK(RIPEMD160);
 BENCHMARK(SHA1);
 BENCHMARK(SHA256);
@@ -166,3 +180,4 @@ BENCHMARK(MuHash);
 BENCHMARK(MuHashMul);
 BENCHMARK(MuHashDiv);
 BENCHMARK(MuHashPrecompute);
+BENCHMARK(MuHashFinalize);
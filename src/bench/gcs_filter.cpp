@@ -81,8 +81,34 @@ static void GCSFilterMatch(benchmark::Bench& bench)
         filter.Match(GCSFilter::Element());
     });
 }
+static void GCSFilterMatchAny(benchmark::Bench& bench)
+{
+    // A filter of a full block and the scripts of a moderately sized wallet,
+    // none of which match, so that the whole filter is decoded every time.
+    GCSFilter::ElementSet block_elements;
+    for (int i = 0; i < 5000; ++i) {
+        GCSFilter::Element element(25);
+        element[0] = static_cast<unsigned char>(i);
+        element[1] = static_cast<unsigned char>(i >> 8);
+        block_elements.insert(std::move(element));
+    }
+    GCSFilter::ElementSet wallet_elements;
+    for (int i = 0; i < 1000; ++i) {
+        GCSFilter::Element element(22, 0xff);
+        element[0] = static_cast<unsigned char>(i);
+        element[1] = static_cast<unsigned char>(i >> 8);
+        wallet_elements.insert(std::move(element));
+    }
+
+    GCSFilter filter({0, 0, BASIC_FILTER_P, BASIC_FILTER_M}, block_elements);
+
+    bench.run([&] {
+        filter.MatchAny(wallet_elements);
+    });
+}
 BENCHMARK(GCSBlockFilterGetHash);
 BENCHMARK(GCSFilterConstruct);
 BENCHMARK(GCSFilterDecode);
 BENCHMARK(GCSFilterDecodeSkipCheck);
 BENCHMARK(GCSFilterMatch);
+BENCHMARK(GCSFilterMatchAny);
@@ -0,0 +1,80 @@
+// Copyright (c) 2022 The Garikcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <arith_uint256.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <headerssync.h>
+#include <primitives/block.h>
+#include <uint256.h>
+#include <util/system.h>
+
+#include <cassert>
+#include <vector>
+
+//! Number of headers in a single (full) headers message.
+static constexpr size_t HEADERS_PER_MESSAGE{2000};
+
+//! Length of the synthetic chain, roughly that of mainnet.
+static constexpr size_t NUM_HEADERS{800000};
+
+/** Run a HeadersSyncState through both the PRESYNC and REDOWNLOAD phases of a
+ * synthetic regtest chain, feeding it full headers messages the way
+ * net_processing does. HeadersSyncState does not check proof of work itself
+ * (the caller does), so the headers are not ground. */
+static void HeadersSyncPresyncAndRedownload(benchmark::Bench& bench)
+{
+    ArgsManager bench_args;
+    const auto chain_params = CreateChainParams(bench_args, CBaseChainParams::REGTEST);
+    const CBlockHeader genesis{chain_params->GenesisBlock().GetBlockHeader()};
+
+    const uint256 genesis_hash{genesis.GetHash()};
+    CBlockIndex chain_start{genesis};
+    chain_start.phashBlock = &genesis_hash;
+    chain_start.nChainWork = GetBlockProof(chain_start);
+
+    std::vector<std::vector<CBlockHeader>> messages;
+    messages.reserve(NUM_HEADERS / HEADERS_PER_MESSAGE);
+    uint256 prev_hash{genesis_hash};
+    uint32_t prev_time{genesis.nTime};
+    for (size_t i = 0; i < NUM_HEADERS; ++i) {
+        if (i % HEADERS_PER_MESSAGE == 0) {
+            messages.emplace_back();
+            messages.back().reserve(HEADERS_PER_MESSAGE);
+        }
+        CBlockHeader header;
+        header.nVersion = 0x20000000;
+        header.hashPrevBlock = prev_hash;
+        header.hashMerkleRoot = ArithToUint256(i);
+        header.nTime = ++prev_time;
+        header.nBits = genesis.nBits;
+        prev_hash = header.GetHash();
+        messages.back().push_back(header);
+    }
+
+    // Require exactly the work of the full chain, so that PRESYNC ends on the
+    // last header and REDOWNLOAD releases everything in the final message.
+    const arith_uint256 minimum_work{chain_start.nChainWork + GetBlockProof(genesis.nBits) * NUM_HEADERS};
+
+    bench.batch(NUM_HEADERS).unit("header").run([&] {
+        HeadersSyncState hss{0, chain_params->GetConsensus(), &chain_start, minimum_work};
+        size_t accepted{0};
+        for (const auto& headers : messages) {
+            const auto result{hss.ProcessNextHeaders(headers, headers.size() == HEADERS_PER_MESSAGE)};
+            assert(result.success);
+        }
+        assert(hss.GetState() == HeadersSyncState::State::REDOWNLOAD);
+        for (const auto& headers : messages) {
+            const auto result{hss.ProcessNextHeaders(headers, headers.size() == HEADERS_PER_MESSAGE)};
+            assert(result.success);
+            accepted += result.pow_validated_headers.size();
+        }
+        assert(hss.GetState() == HeadersSyncState::State::FINAL);
+        assert(accepted == NUM_HEADERS);
+    });
+}
+
+BENCHMARK(HeadersSyncPresyncAndRedownload);
@@ -0,0 +1,112 @@
+// Copyright (c) 2022 The Garikcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <bench/data.h>
+
+#include <chain.h>
+#include <chainparams.h>
+#include <node/blockstorage.h>
+#include <primitives/block.h>
+#include <streams.h>
+#include <test/util/setup_common.h>
+#include <util/lz.h>
+#include <validation.h>
+
+#include <cassert>
+
+using node::ReadBlockFromDisk;
+using node::ReadRawBlockFromDisk;
+
+// Serving a block from a compressed block file costs its decompression on top
+// of reading it. These benchmarks compare reading the same block from an
+// uncompressed and a compressed block file.
+
+namespace {
+
+struct BlockFiles {
+    const std::unique_ptr<const TestingSetup> testing_setup{MakeNoLogFileContext<const TestingSetup>(CBaseChainParams::REGTEST, {"-fastprune"})};
+    CBlock block{};
+    FlatFilePos uncompressed_pos{};
+    FlatFilePos compressed_pos{};
+
+    BlockFiles()
+    {
+        CDataStream stream(benchmark::data::block413567, SER_NETWORK, PROTOCOL_VERSION);
+        stream >> block;
+
+        // With -fastprune, each block gets a file of its own
+        ChainstateManager& chainman{*testing_setup->m_node.chainman};
+        LOCK(::cs_main);
+        CChain& chain{chainman.ActiveChain()};
+        compressed_pos = chainman.m_blockman.SaveBlockToDisk(block, 1, chain, Params(), nullptr);
+        uncompressed_pos = chainman.m_blockman.SaveBlockToDisk(block, 1, chain, Params(), nullptr);
+        assert(compressed_pos.nFile != uncompressed_pos.nFile);
+        CBlockIndex* index{chainman.m_blockman.AddToBlockIndex(block, chainman.m_best_header)};
+        index->nFile = compressed_pos.nFile;
+        index->nDataPos = compressed_pos.nPos;
+        index->nStatus |= BLOCK_HAVE_DATA;
+    }
+
+    void Compress() const
+    {
+        assert(testing_setup->m_node.chainman->m_blockman.CompressBlockFile(compressed_pos.nFile));
+    }
+};
+
+} // namespace
+
+static void ReadBlockFromDiskBench(benchmark::Bench& bench, bool compressed)
+{
+    const BlockFiles files;
+    files.Compress();
+    const FlatFilePos& pos{compressed ? files.compressed_pos : files.uncompressed_pos};
+    bench.unit("block").run([&] {
+        CBlock block;
+        const bool read{ReadBlockFromDisk(block, pos, Params().GetConsensus())};
+        assert(read);
+    });
+}
+
+static void ReadRawBlockFromDiskBench(benchmark::Bench& bench, bool compressed)
+{
+    const BlockFiles files;
+    files.Compress();
+    const FlatFilePos& pos{compressed ? files.compressed_pos : files.uncompressed_pos};
+    bench.unit("block").run([&] {
+        std::vector<uint8_t> block_data;
+        const bool read{ReadRawBlockFromDisk(block_data, pos, Params().MessageStart())};
+        assert(read);
+    });
+}
+
+static void ReadBlockFromDiskTest(benchmark::Bench& bench) { ReadBlockFromDiskBench(bench, /*compressed=*/false); }
+static void ReadCompressedBlockFromDiskTest(benchmark::Bench& bench) { ReadBlockFromDiskBench(bench, /*compressed=*/true); }
+static void ReadRawBlockFromDiskTest(benchmark::Bench& bench) { ReadRawBlockFromDiskBench(bench, /*compressed=*/false); }
+static void ReadRawCompressedBlockFromDiskTest(benchmark::Bench& bench) { ReadRawBlockFromDiskBench(bench, /*compressed=*/true); }
+
+static void CompressBlockTest(benchmark::Bench& bench)
+{
+    bench.unit("block").run([&] {
+        const auto compressed{LZCompress(benchmark::data::block413567)};
+        ankerl::nanobench::doNotOptimizeAway(compressed);
+    });
+}
+
+static void DecompressBlockTest(benchmark::Bench& bench)
+{
+    const auto compressed{LZCompress(benchmark::data::block413567)};
+    std::vector<uint8_t> decompressed(benchmark::data::block413567.size());
+    bench.unit("block").run([&] {
+        const bool ok{LZDecompress(compressed, decompressed)};
+        assert(ok);
+    });
+}
+
+BENCHMARK(ReadBlockFromDiskTest);
+BENCHMARK(ReadCompressedBlockFromDiskTest);
+BENCHMARK(ReadRawBlockFromDiskTest);
+BENCHMARK(ReadRawCompressedBlockFromDiskTest);
+BENCHMARK(CompressBlockTest);
+BENCHMARK(DecompressBlockTest);
@@ -0,0 +1,70 @@
+// Copyright (c) 2022 The Garikcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <index/txindex.h>
+#include <interfaces/chain.h>
+#include <random.h>
+#include <test/util/mining.h>
+#include <test/util/script.h>
+#include <test/util/setup_common.h>
+#include <util/time.h>
+#include <validationinterface.h>
+
+#include <cassert>
+#include <vector>
+
+// Look up random transactions of the chain, one at a time or all at once,
+// from disk or from the cache of recently looked up transactions.
+
+static void TxIndexLookup(benchmark::Bench& bench, bool batch, size_t tx_cache_size)
+{
+    const auto testing_setup = MakeNoLogFileContext<TestingSetup>();
+
+    constexpr size_t NUM_BLOCKS{200};
+    std::vector<uint256> txids;
+    for (size_t i{0}; i < NUM_BLOCKS; ++i) {
+        txids.push_back(MineBlock(testing_setup->m_node, P2WSH_OP_TRUE).prevout.hash);
+    }
+
+    TxIndex txindex{interfaces::MakeChain(testing_setup->m_node), 1 << 20, /*f_memory=*/true, /*f_wipe=*/false, tx_cache_size};
+    assert(txindex.Start());
+    while (!txindex.BlockUntilSyncedToCurrentChain()) {
+        UninterruptibleSleep(std::chrono::milliseconds{10});
+    }
+
+    constexpr size_t NUM_LOOKUPS{100};
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<uint256> lookups;
+    for (size_t i{0}; i < NUM_LOOKUPS; ++i) {
+        lookups.push_back(txids[rng.randrange(txids.size())]);
+    }
+
+    std::vector<uint256> block_hashes;
+    std::vector<CTransactionRef> txs;
+    bench.batch(NUM_LOOKUPS).unit("tx").run([&] {
+        if (batch) {
+            const size_t found{txindex.FindTxs(lookups, block_hashes, txs)};
+            assert(found == NUM_LOOKUPS);
+        } else {
+            uint256 block_hash;
+            CTransactionRef tx;
+            for (const uint256& txid : lookups) {
+                const bool found{txindex.FindTx(txid, block_hash, tx)};
+                assert(found);
+            }
+        }
+    });
+
+    txindex.Stop();
+    SyncWithValidationInterfaceQueue();
+}
+
+static void TxIndexLookupOneByOne(benchmark::Bench& bench) { TxIndexLookup(bench, /*batch=*/false, /*tx_cache_size=*/0); }
+static void TxIndexLookupBatch(benchmark::Bench& bench) { TxIndexLookup(bench, /*batch=*/true, /*tx_cache_size=*/0); }
+static void TxIndexLookupCached(benchmark::Bench& bench) { TxIndexLookup(bench, /*batch=*/false, DEFAULT_TX_CACHE_SIZE); }
+
+BENCHMARK(TxIndexLookupOneByOne);
+BENCHMARK(TxIndexLookupBatch);
+BENCHMARK(TxIndexLookupCached);
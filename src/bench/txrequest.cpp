@@ -0,0 +1,62 @@
+// Copyright (c) 2022 The Garikcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <net.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <txrequest.h>
+#include <uint256.h>
+
+#include <chrono>
+#include <vector>
+
+//! Number of simulated peers.
+static constexpr int NUM_PEERS{1000};
+
+//! Number of distinct transactions announced per round.
+static constexpr int TXS_PER_ROUND{500};
+
+//! Number of peers announcing each transaction.
+static constexpr int ANNOUNCERS_PER_TX{16};
+
+/** Simulate a relay node with many peers announcing overlapping sets of
+ * txids. Every round, each transaction is announced by a random subset of
+ * peers, then GetRequestable is called for every peer (as SendMessages does),
+ * the returned transactions are requested, and responses are processed. */
+static void TxRequestManyPeers(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    TxRequestTracker tracker{/*deterministic=*/true};
+    std::chrono::microseconds now{1};
+    std::vector<std::pair<NodeId, GenTxid>> expired;
+    std::vector<std::pair<NodeId, uint256>> in_flight;
+
+    bench.batch(NUM_PEERS).unit("GetRequestable").run([&] {
+        for (int i = 0; i < TXS_PER_ROUND; ++i) {
+            const GenTxid gtxid{GenTxid::Wtxid(rng.rand256())};
+            for (int j = 0; j < ANNOUNCERS_PER_TX; ++j) {
+                const NodeId peer = rng.randrange(NUM_PEERS);
+                tracker.ReceivedInv(peer, gtxid, /*preferred=*/peer % 8 == 0, now + std::chrono::microseconds{rng.randrange(2000000)});
+            }
+        }
+        now += std::chrono::seconds{1};
+
+        for (NodeId peer = 0; peer < NUM_PEERS; ++peer) {
+            for (const GenTxid& gtxid : tracker.GetRequestable(peer, now, &expired)) {
+                tracker.RequestedTx(peer, gtxid.GetHash(), now + std::chrono::seconds{60});
+                in_flight.emplace_back(peer, gtxid.GetHash());
+            }
+        }
+
+        for (const auto& [peer, txhash] : in_flight) {
+            tracker.ReceivedResponse(peer, txhash);
+            tracker.ForgetTxHash(txhash);
+        }
+        in_flight.clear();
+    });
+}
+
+BENCHMARK(TxRequestManyPeers);
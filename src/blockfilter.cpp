@@ -63,11 +63,11 @@ GCSFilter::GCSFilter(const Params& params, std::vector<unsigned char> encoded_fi
 
     // Verify that the encoded filter contains exactly N elements. If it has too much or too little
     // data, a std::ios_base::failure exception will be raised.
-    BitStreamReader<SpanReader> bitreader{stream};
+    GolombRiceDecoder decoder{Span{m_encoded}.last(stream.size())};
     for (uint64_t i = 0; i < m_N; ++i) {
-        GolombRiceDecode(bitreader, m_params.m_P);
+        decoder.Decode(m_params.m_P);
     }
-    if (!stream.empty()) {
+    if (decoder.RemainingBytes() != 0) {
         throw std::ios_base::failure("encoded_filter contains excess data");
     }
 }
@@ -90,16 +90,16 @@ GCSFilter::GCSFilter(const Params& params, const ElementSet& elements)
         return;
     }
 
-    BitStreamWriter<CVectorWriter> bitwriter(stream);
+    GolombRiceEncoder encoder{m_encoded};
 
     uint64_t last_value = 0;
     for (uint64_t value : BuildHashedSet(elements)) {
         uint64_t delta = value - last_value;
-        GolombRiceEncode(bitwriter, m_params.m_P, delta);
+        encoder.Encode(m_params.m_P, delta);
         last_value = value;
     }
 
-    bitwriter.Flush();
+    encoder.Flush();
 }
 
 bool GCSFilter::MatchInternal(const uint64_t* element_hashes, size_t size) const
@@ -110,12 +110,12 @@ bool GCSFilter::MatchInternal(const uint64_t* element_hashes, size_t size) const
     uint64_t N = ReadCompactSize(stream);
     assert(N == m_N);
 
-    BitStreamReader<SpanReader> bitreader{stream};
+    GolombRiceDecoder decoder{Span{m_encoded}.last(stream.size())};
 
     uint64_t value = 0;
     size_t hashes_index = 0;
     for (uint32_t i = 0; i < m_N; ++i) {
-        uint64_t delta = GolombRiceDecode(bitreader, m_params.m_P);
+        uint64_t delta = decoder.Decode(m_params.m_P);
         value += delta;
 
         while (true) {
@@ -129,11 +129,16 @@ void CBlockIndex::BuildSkip()
 }
 
 arith_uint256 GetBlockProof(const CBlockIndex& block)
+{
+    return GetBlockProof(block.nBits);
+}
+
+arith_uint256 GetBlockProof(uint32_t nBits)
 {
     arith_uint256 bnTarget;
     bool fNegative;
     bool fOverflow;
-    bnTarget.SetCompact(block.nBits, &fNegative, &fOverflow);
+    bnTarget.SetCompact(nBits, &fNegative, &fOverflow);
     if (fNegative || fOverflow || bnTarget == 0)
         return 0;
     // We need to compute 2**256 / (bnTarget+1), but we can't represent 2**256
@@ -358,6 +358,8 @@ public:
 };
 
 arith_uint256 GetBlockProof(const CBlockIndex& block);
+/** Compute the amount of work implied by a compact difficulty target. */
+arith_uint256 GetBlockProof(uint32_t nBits);
 /** Return the time it would take to redo the work difference between from and to, assuming the current hashrate corresponds to the difficulty at tip, in seconds. */
 int64_t GetBlockProofEquivalentTime(const CBlockIndex& to, const CBlockIndex& from, const CBlockIndex& tip, const Consensus::Params&);
 /** Find the forking point between two chain tips. */
@@ -440,6 +440,10 @@ public:
                 200,
                 {AssumeutxoHash{uint256S("0x51c8d11d8b5c1de51543c579736e786aa2736206d1e11e627568029ce092cf62")}, 200},
             },
+            {
+                299,
+                {AssumeutxoHash{uint256S("0xaa6b0043c9e4ef331cf2fbd05e98827767c9b00aa767eb1c3753194022994ec7")}, 300},
+            },
         };
 
         chainTxData = ChainTxData{
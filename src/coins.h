@@ -181,6 +181,11 @@ public:
     //! Get a cursor to iterate over the whole state
     virtual std::unique_ptr<CCoinsViewCursor> Cursor() const;
 
+    //! Get cursors over consecutive, disjoint ranges of the state that together cover all of it,
+    //! all reading the same state, so that the ranges can be iterated concurrently. At most
+    //! num_ranges cursors are returned; views that cannot be split return just Cursor().
+    virtual std::vector<std::unique_ptr<CCoinsViewCursor>> Cursors(size_t num_ranges) const;
+
     //! As we use CCoinsViews polymorphically, have a virtual destructor
     virtual ~CCoinsView() {}
 
@@ -204,6 +209,7 @@ public:
     void SetBackend(CCoinsView &viewIn);
     bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
     std::unique_ptr<CCoinsViewCursor> Cursor() const override;
+    std::vector<std::unique_ptr<CCoinsViewCursor>> Cursors(size_t num_ranges) const override;
     size_t EstimateSize() const override;
 };
 
@@ -222,6 +228,10 @@ protected:
     /* Cached dynamic memory usage for the inner Coin objects. */
     mutable size_t cachedCoinsUsage;
 
+    /* Number of coin lookups served from cacheCoins, and that had to query the base view. */
+    mutable uint64_t m_cache_hits{0};
+    mutable uint64_t m_cache_misses{0};
+
 public:
     CCoinsViewCache(CCoinsView *baseIn);
 
@@ -239,6 +249,9 @@ public:
     std::unique_ptr<CCoinsViewCursor> Cursor() const override {
         throw std::logic_error("CCoinsViewCache cursor iteration not supported.");
     }
+    std::vector<std::unique_ptr<CCoinsViewCursor>> Cursors(size_t num_ranges) const override {
+        throw std::logic_error("CCoinsViewCache cursor iteration not supported.");
+    }
 
     /**
      * Check if we have the given utxo already loaded in this cache.
@@ -300,9 +313,21 @@ public:
     //! Calculate the size of the cache (in bytes)
     size_t DynamicMemoryUsage() const;
 
+    //! Number of coin lookups served from the cache
+    uint64_t GetCacheHits() const { return m_cache_hits; }
+
+    //! Number of coin lookups that had to query the base view
+    uint64_t GetCacheMisses() const { return m_cache_misses; }
+
     //! Check whether all prevouts of the transaction are present in the UTXO set represented by this view
     bool HaveInputs(const CTransaction& tx) const;
 
+    /**
+     * Call fn for every coin that Flush() would write to the base, along with whether it is
+     * FRESH (i.e. the base is known not to hold an unspent version of it).
+     */
+    void ForEachDirtyCoin(const std::function<void(const COutPoint&, const Coin&, bool fresh)>& fn) const;
+
     //! Force a reallocation of the cache map. This is required when downsizing
     //! the cache because the map's allocator may be hanging onto a lot of
     //! memory despite having called .clear().
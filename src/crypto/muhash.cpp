@@ -20,33 +20,29 @@ constexpr int LIMB_SIZE = Num3072::LIMB_SIZE;
 /** 2^3072 - 1103717, the largest 3072-bit safe prime number, is used as the modulus. */
 constexpr limb_t MAX_PRIME_DIFF = 1103717;
 
-/** Extract the lowest limb of [c0,c1,c2] into n, and left shift the number by 1 limb. */
-inline void extract3(limb_t& c0, limb_t& c1, limb_t& c2, limb_t& n)
+/** Extract the lowest limb of [c01,c2] into n, and left shift the number by 1 limb. */
+inline void extract3(double_limb_t& c01, limb_t& c2, limb_t& n)
 {
-    n = c0;
-    c0 = c1;
-    c1 = c2;
+    n = c01;
+    c01 = (c01 >> LIMB_SIZE) | ((double_limb_t)c2 << LIMB_SIZE);
     c2 = 0;
 }
 
-/** [c0,c1] = a * b */
-inline void mul(limb_t& c0, limb_t& c1, const limb_t& a, const limb_t& b)
+/** [c01,c2] += a * b */
+inline void muladd3(double_limb_t& c01, limb_t& c2, const limb_t& a, const limb_t& b)
 {
     double_limb_t t = (double_limb_t)a * b;
-    c1 = t >> LIMB_SIZE;
-    c0 = t;
+    c01 += t;
+    c2 += (c01 < t) ? 1 : 0;
 }
 
-/* [c0,c1,c2] += n * [d0,d1,d2]. c2 is 0 initially */
-inline void mulnadd3(limb_t& c0, limb_t& c1, limb_t& c2, limb_t& d0, limb_t& d1, limb_t& d2, const limb_t& n)
+/** [c01,c2] += 2 * [d01,d2] */
+inline void dbladd3(double_limb_t& c01, limb_t& c2, const double_limb_t& d01, const limb_t& d2)
 {
-    double_limb_t t = (double_limb_t)d0 * n + c0;
-    c0 = t;
-    t >>= LIMB_SIZE;
-    t += (double_limb_t)d1 * n + c1;
-    c1 = t;
-    t >>= LIMB_SIZE;
-    c2 = t + d2 * n;
+    c2 += (d2 << 1) | (d01 >> (2 * LIMB_SIZE - 1));
+    const double_limb_t t = d01 << 1;
+    c01 += t;
+    c2 += (c01 < t) ? 1 : 0;
 }
 
 /* [c0,c1] *= n */
@@ -59,36 +55,6 @@ inline void muln2(limb_t& c0, limb_t& c1, const limb_t& n)
     c1 = t;
 }
 
-/** [c0,c1,c2] += a * b */
-inline void muladd3(limb_t& c0, limb_t& c1, limb_t& c2, const limb_t& a, const limb_t& b)
-{
-    double_limb_t t = (double_limb_t)a * b;
-    limb_t th = t >> LIMB_SIZE;
-    limb_t tl = t;
-
-    c0 += tl;
-    th += (c0 < tl) ? 1 : 0;
-    c1 += th;
-    c2 += (c1 < th) ? 1 : 0;
-}
-
-/** [c0,c1,c2] += 2 * a * b */
-inline void muldbladd3(limb_t& c0, limb_t& c1, limb_t& c2, const limb_t& a, const limb_t& b)
-{
-    double_limb_t t = (double_limb_t)a * b;
-    limb_t th = t >> LIMB_SIZE;
-    limb_t tl = t;
-
-    c0 += tl;
-    limb_t tt = th + ((c0 < tl) ? 1 : 0);
-    c1 += tt;
-    c2 += (c1 < tt) ? 1 : 0;
-    c0 += tl;
-    th += (c0 < tl) ? 1 : 0;
-    c1 += th;
-    c2 += (c1 < th) ? 1 : 0;
-}
-
 /**
  * Add limb a to [c0,c1]: [c0,c1] += a. Then extract the lowest
  * limb of [c0,c1] into n, and left shift the number by 1 limb.
@@ -113,6 +79,35 @@ inline void addnextract2(limb_t& c0, limb_t& c1, const limb_t& a, limb_t& n)
     c1 = c2;
 }
 
+/**
+ * Reduce the double-width number in into out. As 2^3072 is congruent to MAX_PRIME_DIFF modulo
+ * the prime, the upper half is folded into the lower half by multiplying it with MAX_PRIME_DIFF,
+ * which leaves a carry of a few bits that is folded in a second time. Returns the final carry,
+ * which is 0 or 1.
+ */
+inline limb_t reduce(Num3072& out, const limb_t (&in)[2 * Num3072::LIMBS])
+{
+    constexpr int LIMBS = Num3072::LIMBS;
+    limb_t c0 = 0, c1 = 0;
+
+    /* Perform the first reduction. */
+    for (int j = 0; j < LIMBS; ++j) {
+        double_limb_t t = (double_limb_t)in[LIMBS + j] * MAX_PRIME_DIFF + in[j] + c0;
+        out.limbs[j] = t;
+        c0 = t >> LIMB_SIZE;
+    }
+
+    /* Perform a second reduction. */
+    muln2(c0, c1, MAX_PRIME_DIFF);
+    for (int j = 0; j < LIMBS; ++j) {
+        addnextract2(c0, c1, out.limbs[j], out.limbs[j]);
+    }
+
+    assert(c1 == 0);
+    assert(c0 == 0 || c0 == 1);
+    return c0;
+}
+
 /** in_out = in_out^(2^sq) * mul */
 inline void square_n_mul(Num3072& in_out, const int sq, const Num3072& mul)
 {
@@ -180,76 +175,58 @@ Num3072 Num3072::GetInverse() const
 
 void Num3072::Multiply(const Num3072& a)
 {
-    limb_t c0 = 0, c1 = 0, c2 = 0;
-    Num3072 tmp;
-
-    /* Compute limbs 0..N-2 of this*a into tmp, including one reduction. */
-    for (int j = 0; j < LIMBS - 1; ++j) {
-        limb_t d0 = 0, d1 = 0, d2 = 0;
-        mul(d0, d1, this->limbs[1 + j], a.limbs[LIMBS + j - (1 + j)]);
-        for (int i = 2 + j; i < LIMBS; ++i) muladd3(d0, d1, d2, this->limbs[i], a.limbs[LIMBS + j - i]);
-        mulnadd3(c0, c1, c2, d0, d1, d2, MAX_PRIME_DIFF);
-        for (int i = 0; i < j + 1; ++i) muladd3(c0, c1, c2, this->limbs[i], a.limbs[j - i]);
-        extract3(c0, c1, c2, tmp.limbs[j]);
-    }
-
-    /* Compute limb N-1 of a*b into tmp. */
-    assert(c2 == 0);
-    for (int i = 0; i < LIMBS; ++i) muladd3(c0, c1, c2, this->limbs[i], a.limbs[LIMBS - 1 - i]);
-    extract3(c0, c1, c2, tmp.limbs[LIMBS - 1]);
-
-    /* Perform a second reduction. */
-    muln2(c0, c1, MAX_PRIME_DIFF);
-    for (int j = 0; j < LIMBS; ++j) {
-        addnextract2(c0, c1, tmp.limbs[j], this->limbs[j]);
+    double_limb_t c01 = 0;
+    limb_t c2 = 0;
+    limb_t tmp[2 * LIMBS];
+
+    /* Compute the full double-width product this*a into tmp, one column at a time. */
+    for (int j = 0; j < 2 * LIMBS - 1; ++j) {
+        const int lo = j < LIMBS ? 0 : j - (LIMBS - 1);
+        const int hi = j < LIMBS ? j : LIMBS - 1;
+        for (int i = lo; i <= hi; ++i) muladd3(c01, c2, this->limbs[i], a.limbs[j - i]);
+        extract3(c01, c2, tmp[j]);
     }
+    assert(c2 == 0 && (c01 >> LIMB_SIZE) == 0);
+    tmp[2 * LIMBS - 1] = c01;
 
-    assert(c1 == 0);
-    assert(c0 == 0 || c0 == 1);
+    const limb_t carry = reduce(*this, tmp);
 
     /* Perform up to two more reductions if the internal state has already
      * overflown the MAX of Num3072 or if it is larger than the modulus or
      * if both are the case.
      * */
     if (this->IsOverflow()) this->FullReduce();
-    if (c0) this->FullReduce();
+    if (carry) this->FullReduce();
 }
 
 void Num3072::Square()
 {
-    limb_t c0 = 0, c1 = 0, c2 = 0;
-    Num3072 tmp;
-
-    /* Compute limbs 0..N-2 of this*this into tmp, including one reduction. */
-    for (int j = 0; j < LIMBS - 1; ++j) {
-        limb_t d0 = 0, d1 = 0, d2 = 0;
-        for (int i = 0; i < (LIMBS - 1 - j) / 2; ++i) muldbladd3(d0, d1, d2, this->limbs[i + j + 1], this->limbs[LIMBS - 1 - i]);
-        if ((j + 1) & 1) muladd3(d0, d1, d2, this->limbs[(LIMBS - 1 - j) / 2 + j + 1], this->limbs[LIMBS - 1 - (LIMBS - 1 - j) / 2]);
-        mulnadd3(c0, c1, c2, d0, d1, d2, MAX_PRIME_DIFF);
-        for (int i = 0; i < (j + 1) / 2; ++i) muldbladd3(c0, c1, c2, this->limbs[i], this->limbs[j - i]);
-        if ((j + 1) & 1) muladd3(c0, c1, c2, this->limbs[(j + 1) / 2], this->limbs[j - (j + 1) / 2]);
-        extract3(c0, c1, c2, tmp.limbs[j]);
-    }
-
-    assert(c2 == 0);
-    for (int i = 0; i < LIMBS / 2; ++i) muldbladd3(c0, c1, c2, this->limbs[i], this->limbs[LIMBS - 1 - i]);
-    extract3(c0, c1, c2, tmp.limbs[LIMBS - 1]);
-
-    /* Perform a second reduction. */
-    muln2(c0, c1, MAX_PRIME_DIFF);
-    for (int j = 0; j < LIMBS; ++j) {
-        addnextract2(c0, c1, tmp.limbs[j], this->limbs[j]);
+    double_limb_t c01 = 0;
+    limb_t c2 = 0;
+    limb_t tmp[2 * LIMBS];
+
+    /* Compute the full double-width square into tmp, one column at a time. Each cross product
+     * appears twice in a column, so it is summed once and the sum is doubled. */
+    for (int j = 0; j < 2 * LIMBS - 1; ++j) {
+        double_limb_t d01 = 0;
+        limb_t d2 = 0;
+        int i = j < LIMBS ? 0 : j - (LIMBS - 1);
+        for (; i < j - i; ++i) muladd3(d01, d2, this->limbs[i], this->limbs[j - i]);
+        dbladd3(c01, c2, d01, d2);
+        if (i == j - i) muladd3(c01, c2, this->limbs[i], this->limbs[i]);
+        extract3(c01, c2, tmp[j]);
     }
+    assert(c2 == 0 && (c01 >> LIMB_SIZE) == 0);
+    tmp[2 * LIMBS - 1] = c01;
 
-    assert(c1 == 0);
-    assert(c0 == 0 || c0 == 1);
+    const limb_t carry = reduce(*this, tmp);
 
     /* Perform up to two more reductions if the internal state has already
      * overflown the MAX of Num3072 or if it is larger than the modulus or
      * if both are the case.
      * */
     if (this->IsOverflow()) this->FullReduce();
-    if (c0) this->FullReduce();
+    if (carry) this->FullReduce();
 }
 
 void Num3072::SetToOne()
@@ -7,15 +7,19 @@
 #include <fs.h>
 #include <logging.h>
 #include <random.h>
+#include <sync.h>
 #include <tinyformat.h>
 #include <util/strencodings.h>
 #include <util/system.h>
+#include <util/time.h>
+#include <util/translation.h>
 
 #include <algorithm>
 #include <cassert>
 #include <cstdarg>
 #include <cstdint>
 #include <cstdio>
+#include <limits>
 #include <leveldb/cache.h>
 #include <leveldb/db.h>
 #include <leveldb/env.h>
@@ -26,6 +30,7 @@
 #include <leveldb/status.h>
 #include <memory>
 #include <optional>
+#include <set>
 
 class CGarikcoinLevelDBLogger : public leveldb::Logger {
 public:
@@ -110,13 +115,15 @@ static void SetMaxOpenFiles(leveldb::Options *options) {
              options->max_open_files, default_open_files);
 }
 
-static leveldb::Options GetOptions(size_t nCacheSize)
+static leveldb::Options GetOptions(size_t nCacheSize, const DBOptions& db_options)
 {
     leveldb::Options options;
-    options.block_cache = leveldb::NewLRUCache(nCacheSize / 2);
-    options.write_buffer_size = nCacheSize / 4; // up to two write buffers may be held in memory simultaneously
-    options.filter_policy = leveldb::NewBloomFilterPolicy(10);
+    options.block_cache = leveldb::NewLRUCache(nCacheSize * db_options.block_cache_percent / 100);
+    options.write_buffer_size = nCacheSize * db_options.write_buffer_percent / 100; // up to two write buffers may be held in memory simultaneously
+    options.filter_policy = db_options.bloom_bits > 0 ? leveldb::NewBloomFilterPolicy(db_options.bloom_bits) : nullptr;
     options.compression = leveldb::kNoCompression;
+    options.block_size = db_options.block_size;
+    options.max_file_size = db_options.max_file_size;
     options.info_log = new CGarikcoinLevelDBLogger();
     if (leveldb::kMajorVersion > 1 || (leveldb::kMajorVersion == 1 && leveldb::kMinorVersion >= 16)) {
         // LevelDB versions before 1.16 consider short writes to be corruption. Only trigger error
@@ -124,18 +131,85 @@ static leveldb::Options GetOptions(size_t nCacheSize)
         options.paranoid_checks = true;
     }
     SetMaxOpenFiles(&options);
+    if (db_options.max_open_files > 0) options.max_open_files = db_options.max_open_files;
     return options;
 }
 
+util::Result<DBOptions> ReadDBOptions(const ArgsManager& args, const std::string& name)
+{
+    DBOptions options;
+    for (const std::string& arg : args.GetArgs("-dboption")) {
+        // <database>:<option>=<value>
+        const size_t colon{arg.rfind(':')};
+        const size_t equals{arg.find('=', colon == std::string::npos ? 0 : colon)};
+        if (colon == std::string::npos || equals == std::string::npos) {
+            return util::Error{strprintf(_("Invalid -dboption '%s', expected <database>:<option>=<value>"), arg)};
+        }
+        const std::string db{arg.substr(0, colon)};
+        const std::string option{arg.substr(colon + 1, equals - colon - 1)};
+        const auto value{ToIntegral<int64_t>(arg.substr(equals + 1))};
+        if (!value || *value < 0) {
+            return util::Error{strprintf(_("Invalid value in -dboption '%s'"), arg)};
+        }
+        const bool applies{db == "*" || db == name};
+        if (option == "blockcache" || option == "writebuffer") {
+            if (*value > 100) return util::Error{strprintf(_("Invalid value in -dboption '%s', %s is a percentage of the cache"), arg, option)};
+            if (applies) (option == "blockcache" ? options.block_cache_percent : options.write_buffer_percent) = *value;
+        } else if (option == "bloombits") {
+            if (*value > 64) return util::Error{strprintf(_("Invalid value in -dboption '%s', at most 64 bloom filter bits per key are supported"), arg)};
+            if (applies) options.bloom_bits = *value;
+        } else if (option == "blocksize" || option == "maxfilesize") {
+            // In KiB, bounded so that the sizes in bytes can't overflow
+            if (*value == 0 || *value > 1 << 20) return util::Error{strprintf(_("Invalid value in -dboption '%s', %s must be between 1 and %d KiB"), arg, option, 1 << 20)};
+            if (applies) (option == "blocksize" ? options.block_size : options.max_file_size) = size_t(*value) << 10;
+        } else if (option == "maxopenfiles") {
+            if (*value > std::numeric_limits<int>::max()) return util::Error{strprintf(_("Invalid value in -dboption '%s'"), arg)};
+            if (applies) options.max_open_files = *value;
+        } else {
+            return util::Error{strprintf(_("Unknown option in -dboption '%s'"), arg)};
+        }
+    }
+    return options;
+}
+
+//! Name a database by its path relative to the data directory, such as
+//! "chainstate" or "indexes/txindex", or by its directory name if it lives
+//! elsewhere.
+static std::string DatabaseName(const fs::path& path)
+{
+    const fs::path relative{path.lexically_relative(gArgs.GetDataDirNet())};
+    if (relative.empty() || *relative.begin() == "..") return fs::PathToString(path.stem());
+    std::string name;
+    for (const fs::path& part : relative) {
+        if (!name.empty()) name += '/';
+        name += fs::PathToString(part);
+    }
+    return name;
+}
+
+static GlobalMutex g_dbwrappers_mutex;
+static std::set<CDBWrapper*> g_dbwrappers GUARDED_BY(g_dbwrappers_mutex);
+
+void ForEachDBWrapper(const std::function<void(CDBWrapper&)>& fn)
+{
+    LOCK(g_dbwrappers_mutex);
+    for (CDBWrapper* db : g_dbwrappers) fn(*db);
+}
+
 CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate)
-    : m_name{fs::PathToString(path.stem())}
+    : m_name{DatabaseName(path)}
 {
+    if (auto db_options{ReadDBOptions(gArgs, m_name)}) {
+        m_db_options = *db_options;
+    } else {
+        throw dbwrapper_error(util::ErrorString(db_options).original);
+    }
     penv = nullptr;
     readoptions.verify_checksums = true;
     iteroptions.verify_checksums = true;
     iteroptions.fill_cache = false;
     syncoptions.sync = true;
-    options = GetOptions(nCacheSize);
+    options = GetOptions(nCacheSize, m_db_options);
     options.create_if_missing = true;
     if (fMemory) {
         penv = leveldb::NewMemEnv(leveldb::Env::Default());
@@ -181,10 +255,17 @@ CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bo
     }
 
     LogPrintf("Using obfuscation key for %s: %s\n", fs::PathToString(path), HexStr(obfuscate_key));
+
+    LOCK(g_dbwrappers_mutex);
+    g_dbwrappers.insert(this);
 }
 
 CDBWrapper::~CDBWrapper()
 {
+    WITH_LOCK(g_dbwrappers_mutex, g_dbwrappers.erase(this));
+    // Wait for a running compaction, which uses pdb
+    if (auto done{WITH_LOCK(m_compaction_mutex, return std::move(m_compaction_done))}; done.valid()) done.wait();
+
     delete pdb;
     pdb = nullptr;
     delete options.filter_policy;
@@ -251,6 +332,67 @@ bool CDBWrapper::IsEmpty()
     return !(it->Valid());
 }
 
+std::vector<std::unique_ptr<CDBIterator>> CDBWrapper::NewIterators(size_t count)
+{
+    leveldb::DB* db{pdb};
+    const std::shared_ptr<const leveldb::Snapshot> snapshot{pdb->GetSnapshot(), [db](const leveldb::Snapshot* s) { db->ReleaseSnapshot(s); }};
+    leveldb::ReadOptions options{iteroptions};
+    options.snapshot = snapshot.get();
+
+    std::vector<std::unique_ptr<CDBIterator>> iterators;
+    iterators.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        iterators.push_back(std::make_unique<CDBIterator>(*this, pdb->NewIterator(options), snapshot));
+    }
+    return iterators;
+}
+
+std::optional<std::string> CDBWrapper::GetProperty(const std::string& property) const
+{
+    std::string value;
+    if (!pdb->GetProperty(property, &value)) return std::nullopt;
+    return value;
+}
+
+//! A key past every key the databases use, which all start with a small prefix byte
+static const std::string DB_KEY_END(DBWRAPPER_PREALLOC_KEY_SIZE, '\xff');
+
+size_t CDBWrapper::EstimateRawSize(Span<const unsigned char> begin, Span<const unsigned char> end) const
+{
+    const leveldb::Range range{leveldb::Slice{(const char*)begin.data(), begin.size()},
+                               end.empty() ? leveldb::Slice{DB_KEY_END} : leveldb::Slice{(const char*)end.data(), end.size()}};
+    uint64_t size{0};
+    pdb->GetApproximateSizes(&range, 1, &size);
+    return size;
+}
+
+bool CDBWrapper::StartCompaction(std::vector<unsigned char> begin, std::vector<unsigned char> end)
+{
+    LOCK(m_compaction_mutex);
+    if (m_compaction.running) return false;
+    m_compaction = DBCompactionStatus{.running = true, .begin = std::move(begin), .end = std::move(end), .start_time = GetTime()};
+    m_compaction_done = std::async(std::launch::async, [this] {
+        const auto start{SteadyClock::now()};
+        const std::vector<unsigned char> begin{WITH_LOCK(m_compaction_mutex, return m_compaction.begin)};
+        const std::vector<unsigned char> end{WITH_LOCK(m_compaction_mutex, return m_compaction.end)};
+        const leveldb::Slice begin_key{(const char*)begin.data(), begin.size()};
+        const leveldb::Slice end_key{(const char*)end.data(), end.size()};
+        LogPrintf("Starting database compaction of %s\n", m_name);
+        pdb->CompactRange(begin.empty() ? nullptr : &begin_key, end.empty() ? nullptr : &end_key);
+        LOCK(m_compaction_mutex);
+        m_compaction.running = false;
+        m_compaction.duration = std::chrono::duration_cast<std::chrono::milliseconds>(SteadyClock::now() - start);
+        LogPrintf("Finished database compaction of %s in %dms\n", m_name, count_milliseconds(*m_compaction.duration));
+    });
+    return true;
+}
+
+DBCompactionStatus CDBWrapper::GetCompactionStatus() const
+{
+    LOCK(m_compaction_mutex);
+    return m_compaction;
+}
+
 CDBIterator::~CDBIterator() { delete piter; }
 bool CDBIterator::Valid() const { return piter->Valid(); }
 void CDBIterator::SeekToFirst() { piter->SeekToFirst(); }
@@ -11,16 +11,23 @@
 #include <serialize.h>
 #include <span.h>
 #include <streams.h>
+#include <sync.h>
+#include <util/result.h>
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <exception>
+#include <functional>
+#include <future>
 #include <leveldb/db.h>
 #include <leveldb/iterator.h>
 #include <leveldb/options.h>
 #include <leveldb/slice.h>
 #include <leveldb/status.h>
 #include <leveldb/write_batch.h>
+#include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -28,6 +35,8 @@ namespace leveldb {
 class Env;
 }
 
+class ArgsManager;
+
 static const size_t DBWRAPPER_PREALLOC_KEY_SIZE = 64;
 static const size_t DBWRAPPER_PREALLOC_VALUE_SIZE = 1024;
 
@@ -39,6 +48,45 @@ public:
 
 class CDBWrapper;
 
+/** LevelDB settings of a database, see -dboption. */
+struct DBOptions {
+    //! Share of the database cache given to LevelDB's block cache, in percent
+    int block_cache_percent{50};
+    //! Share of the database cache given to each write buffer, in percent. Up
+    //! to two write buffers may be held in memory simultaneously.
+    int write_buffer_percent{25};
+    //! Bits per key of the bloom filter kept for each table, 0 to disable it
+    int bloom_bits{10};
+    //! Approximate size of the data read from disk at once, in bytes
+    size_t block_size{4 << 10};
+    //! Size at which LevelDB switches to a new table file, in bytes
+    size_t max_file_size{2 << 20};
+    //! Maximum number of open table files, 0 for the platform default
+    int max_open_files{0};
+};
+
+/**
+ * Read the -dboption settings that apply to the database called `name` on
+ * top of the defaults. Settings for other databases are checked too, so this
+ * fails on any malformed -dboption.
+ */
+util::Result<DBOptions> ReadDBOptions(const ArgsManager& args, const std::string& name);
+
+/** State of the most recent compaction started with CDBWrapper::StartCompaction(). */
+struct DBCompactionStatus {
+    bool running{false};
+    //! Compacted key range; an empty key leaves that end of the range open
+    std::vector<unsigned char> begin;
+    std::vector<unsigned char> end;
+    //! When the compaction started, as a UNIX timestamp
+    int64_t start_time{0};
+    //! How long the compaction took, once it has finished
+    std::optional<std::chrono::milliseconds> duration;
+};
+
+/** Call fn for every open database. None of them is closed while fn runs. */
+void ForEachDBWrapper(const std::function<void(CDBWrapper&)>& fn);
+
 /** These should be considered an implementation detail of the specific database.
  */
 namespace dbwrapper_private {
@@ -131,15 +179,18 @@ class CDBIterator
 private:
     const CDBWrapper &parent;
     leveldb::Iterator *piter;
+    //! Snapshot piter reads from, if any. Released once all iterators sharing it are gone.
+    std::shared_ptr<const leveldb::Snapshot> m_snapshot;
 
 public:
 
     /**
      * @param[in] _parent          Parent CDBWrapper instance.
      * @param[in] _piter           The original leveldb iterator.
+     * @param[in] snapshot         The snapshot _piter was created on, if any.
      */
-    CDBIterator(const CDBWrapper &_parent, leveldb::Iterator *_piter) :
-        parent(_parent), piter(_piter) { };
+    CDBIterator(const CDBWrapper &_parent, leveldb::Iterator *_piter, std::shared_ptr<const leveldb::Snapshot> snapshot = nullptr) :
+        parent(_parent), piter(_piter), m_snapshot(std::move(snapshot)) { };
     ~CDBIterator();
 
     bool Valid() const;
@@ -205,9 +256,16 @@ private:
     //! the database itself
     leveldb::DB* pdb;
 
-    //! the name of this database
+    //! the name of this database, its path relative to the data directory
     std::string m_name;
 
+    //! the LevelDB settings this database was opened with
+    DBOptions m_db_options;
+
+    mutable Mutex m_compaction_mutex;
+    DBCompactionStatus m_compaction GUARDED_BY(m_compaction_mutex);
+    std::future<void> m_compaction_done GUARDED_BY(m_compaction_mutex);
+
     //! a key used for optional XOR-obfuscation of the database
     std::vector<unsigned char> obfuscate_key;
 
@@ -305,11 +363,40 @@ public:
         return new CDBIterator(*this, pdb->NewIterator(iteroptions));
     }
 
+    /**
+     * Return count iterators that all read the database as it is at the time
+     * of the call, so that they can scan different parts of it concurrently
+     * and still see one consistent state.
+     */
+    std::vector<std::unique_ptr<CDBIterator>> NewIterators(size_t count);
+
     /**
      * Return true if the database managed by this class contains no entries.
      */
     bool IsEmpty();
 
+    const std::string& GetName() const { return m_name; }
+
+    const DBOptions& GetDBOptions() const { return m_db_options; }
+
+    //! Get a LevelDB property such as "leveldb.stats", or nullopt if it is unknown.
+    std::optional<std::string> GetProperty(const std::string& property) const;
+
+    //! Estimate the on-disk size of the raw keys in [begin, end). An empty
+    //! end covers all keys from begin on.
+    size_t EstimateRawSize(Span<const unsigned char> begin, Span<const unsigned char> end) const;
+
+    /**
+     * Compact the raw keys in [begin, end] in a separate thread, so that reads
+     * of them go through fewer table files. Empty keys leave the range open at
+     * that end. Only one compaction runs at a time.
+     *
+     * @returns false if a compaction is already running.
+     */
+    bool StartCompaction(std::vector<unsigned char> begin, std::vector<unsigned char> end) EXCLUSIVE_LOCKS_REQUIRED(!m_compaction_mutex);
+
+    DBCompactionStatus GetCompactionStatus() const EXCLUSIVE_LOCKS_REQUIRED(!m_compaction_mutex);
+
     template<typename K>
     size_t EstimateSize(const K& key_begin, const K& key_end) const
     {
@@ -205,7 +205,7 @@ bool HeadersSyncState::ValidateAndProcessSingleHeader(const CBlockHeader& curren
         }
     }
 
-    m_current_chain_work += GetBlockProof(CBlockIndex(current));
+    m_current_chain_work += GetHeaderProof(current.nBits);
     m_last_header_received = current;
     m_current_height = next_height;
 
@@ -219,6 +219,10 @@ bool HeadersSyncState::ValidateAndStoreRedownloadedHeader(const CBlockHeader& he
 
     int64_t next_height = m_redownload_buffer_last_height + 1;
 
+    // Every header is hashed exactly once here; the result is used both for
+    // the commitment check and to link the next header.
+    const uint256 hash{header.GetHash()};
+
     // Ensure that we're working on a header that connects to the chain we're
     // downloading.
     if (header.hashPrevBlock != m_redownload_buffer_last_hash) {
@@ -241,7 +245,7 @@ bool HeadersSyncState::ValidateAndStoreRedownloadedHeader(const CBlockHeader& he
     }
 
     // Track work on the redownloaded chain
-    m_redownload_chain_work += GetBlockProof(CBlockIndex(header));
+    m_redownload_chain_work += GetHeaderProof(header.nBits);
 
     if (m_redownload_chain_work >= m_minimum_required_work) {
         m_process_all_remaining_headers = true;
@@ -260,7 +264,7 @@ bool HeadersSyncState::ValidateAndStoreRedownloadedHeader(const CBlockHeader& he
             // we've run out of commitments.
             return false;
         }
-        bool commitment = m_hasher(header.GetHash()) & 1;
+        bool commitment = m_hasher(hash) & 1;
         bool expected_commitment = m_header_commitments.front();
         m_header_commitments.pop_front();
         if (commitment != expected_commitment) {
@@ -272,7 +276,7 @@ bool HeadersSyncState::ValidateAndStoreRedownloadedHeader(const CBlockHeader& he
     // Store this header for later processing.
     m_redownloaded_headers.push_back(header);
     m_redownload_buffer_last_height = next_height;
-    m_redownload_buffer_last_hash = header.GetHash();
+    m_redownload_buffer_last_hash = hash;
 
     return true;
 }
@@ -293,6 +297,18 @@ std::vector<CBlockHeader> HeadersSyncState::PopHeadersReadyForAcceptance()
     return ret;
 }
 
+const arith_uint256& HeadersSyncState::GetHeaderProof(uint32_t nBits)
+{
+    // GetBlockProof() performs a 256-bit division, which dominates the cost of
+    // processing a header once the hash is known. Consecutive headers almost
+    // always share the same target, so a single cached entry suffices.
+    if (nBits != m_cached_proof_nbits) {
+        m_cached_proof = GetBlockProof(nBits);
+        m_cached_proof_nbits = nBits;
+    }
+    return m_cached_proof;
+}
+
 CBlockLocator HeadersSyncState::NextHeadersRequestLocator() const
 {
     Assume(m_download_state != State::FINAL);
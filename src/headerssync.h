@@ -200,6 +200,10 @@ private:
     /** Return a set of headers that satisfy our proof-of-work threshold */
     std::vector<CBlockHeader> PopHeadersReadyForAcceptance();
 
+    /** Return the work implied by nBits, reusing the previous result when the
+     * target is unchanged (it only changes at retarget boundaries). */
+    const arith_uint256& GetHeaderProof(uint32_t nBits);
+
 private:
     /** NodeId of the peer (used for log messages) **/
     const NodeId m_id;
@@ -270,6 +274,10 @@ private:
      */
     bool m_process_all_remaining_headers{false};
 
+    /** nBits and corresponding work of the last GetHeaderProof() call. */
+    uint32_t m_cached_proof_nbits{0};
+    arith_uint256 m_cached_proof;
+
     /** Current state of our headers sync. */
     State m_download_state{State::PRESYNC};
 };
@@ -0,0 +1,278 @@
+// Copyright (c) 2022 The Garikcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/addressindex.h>
+
+#include <chainparams.h>
+#include <compressor.h>
+#include <crypto/sha256.h>
+#include <node/blockstorage.h>
+#include <primitives/block.h>
+#include <script/script.h>
+#include <serialize.h>
+#include <tinyformat.h>
+#include <undo.h>
+#include <util/strencodings.h>
+#include <util/string.h>
+#include <util/system.h>
+#include <validation.h>
+
+using node::ReadBlockFromDisk;
+using node::UndoReadFromDisk;
+
+constexpr uint8_t DB_ADDRESS_HISTORY{'h'};
+constexpr uint8_t DB_ADDRESS_UNSPENT{'u'};
+
+std::unique_ptr<AddressIndex> g_address_index;
+
+std::string AddressHistoryPosition::ToString() const
+{
+    return strprintf("%d:%u:%s:%u", height, tx_pos, is_output ? "out" : "in", index);
+}
+
+std::optional<AddressHistoryPosition> AddressHistoryPosition::FromString(const std::string& str)
+{
+    const std::vector<std::string> parts{SplitString(str, ':')};
+    if (parts.size() != 4 || (parts[2] != "in" && parts[2] != "out")) return std::nullopt;
+    const auto height{ToIntegral<int>(parts[0])};
+    const auto tx_pos{ToIntegral<uint32_t>(parts[1])};
+    const auto index{ToIntegral<uint32_t>(parts[3])};
+    if (!height || *height < 0 || !tx_pos || !index) return std::nullopt;
+    return AddressHistoryPosition{*height, *tx_pos, parts[2] == "out", *index};
+}
+
+namespace {
+
+uint256 HashScript(const CScript& script)
+{
+    uint256 hash;
+    CSHA256().Write(script.data(), script.size()).Finalize(hash.begin());
+    return hash;
+}
+
+struct DBHistoryKey {
+    uint256 script_hash;
+    AddressHistoryPosition pos;
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_ADDRESS_HISTORY);
+        s << script_hash;
+        ser_writedata32be(s, pos.height);
+        ser_writedata32be(s, pos.tx_pos);
+        ser_writedata8(s, pos.is_output);
+        ser_writedata32be(s, pos.index);
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        const uint8_t prefix{ser_readdata8(s)};
+        if (prefix != DB_ADDRESS_HISTORY) {
+            throw std::ios_base::failure("Invalid format for addressindex DB history key");
+        }
+        s >> script_hash;
+        pos.height = ser_readdata32be(s);
+        pos.tx_pos = ser_readdata32be(s);
+        pos.is_output = ser_readdata8(s);
+        pos.index = ser_readdata32be(s);
+    }
+};
+
+struct DBHistoryValue {
+    //! Not serialized: whether the value belongs to an output, as recorded in the key
+    bool is_output;
+    uint256 txid;
+    CAmount amount;
+    COutPoint prevout;
+
+    SERIALIZE_METHODS(DBHistoryValue, obj)
+    {
+        READWRITE(obj.txid, Using<AmountCompression>(obj.amount));
+        if (!obj.is_output) READWRITE(obj.prevout);
+    }
+};
+
+struct DBUnspentKey {
+    uint256 script_hash;
+    COutPoint outpoint;
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_ADDRESS_UNSPENT);
+        s << script_hash << outpoint.hash;
+        ser_writedata32be(s, outpoint.n);
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        const uint8_t prefix{ser_readdata8(s)};
+        if (prefix != DB_ADDRESS_UNSPENT) {
+            throw std::ios_base::failure("Invalid format for addressindex DB unspent key");
+        }
+        s >> script_hash >> outpoint.hash;
+        outpoint.n = ser_readdata32be(s);
+    }
+};
+
+struct DBUnspentValue {
+    int height;
+    CAmount amount;
+
+    SERIALIZE_METHODS(DBUnspentValue, obj)
+    {
+        READWRITE(VARINT_MODE(obj.height, VarIntMode::NONNEGATIVE_SIGNED), Using<AmountCompression>(obj.amount));
+    }
+};
+
+} // namespace
+
+/** Access to the addressindex database (indexes/addressindex/) */
+class AddressIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+};
+
+AddressIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "addressindex", n_cache_size, f_memory, f_wipe)
+{}
+
+AddressIndex::AddressIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "addressindex"), m_db(std::make_unique<AddressIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+AddressIndex::~AddressIndex() = default;
+
+BaseIndex::DB& AddressIndex::GetDB() const { return *m_db; }
+
+bool AddressIndex::WriteBlock(const CBlock& block, const CBlockUndo& block_undo, int height, bool connect)
+{
+    if (block_undo.vtxundo.size() + 1 != block.vtx.size()) {
+        return error("%s: undo data of block at height %d doesn't match the block", __func__, height);
+    }
+
+    CDBBatch batch(*m_db);
+    // Disconnect the transactions in reverse order, so that outputs spent in the
+    // same block are restored as unspent before they are removed.
+    for (size_t k = 0; k < block.vtx.size(); ++k) {
+        const uint32_t i = connect ? k : block.vtx.size() - 1 - k;
+        const CTransaction& tx{*block.vtx[i]};
+        const uint256& txid{tx.GetHash()};
+
+        if (!connect) {
+            for (uint32_t j = 0; j < tx.vout.size(); ++j) {
+                if (tx.vout[j].scriptPubKey.IsUnspendable()) continue;
+                const uint256 script_hash{HashScript(tx.vout[j].scriptPubKey)};
+                batch.Erase(DBHistoryKey{script_hash, {height, i, true, j}});
+                batch.Erase(DBUnspentKey{script_hash, {txid, j}});
+            }
+        }
+
+        // The coinbase tx has no undo data since no former output is spent
+        if (!tx.IsCoinBase()) {
+            const CTxUndo& tx_undo{block_undo.vtxundo[i - 1]};
+            if (tx_undo.vprevout.size() != tx.vin.size()) {
+                return error("%s: undo data of transaction %s doesn't match its inputs", __func__, txid.ToString());
+            }
+            for (uint32_t j = 0; j < tx.vin.size(); ++j) {
+                const Coin& coin{tx_undo.vprevout[j]};
+                const COutPoint& prevout{tx.vin[j].prevout};
+                const uint256 script_hash{HashScript(coin.out.scriptPubKey)};
+                const DBHistoryKey key{script_hash, {height, i, false, j}};
+                if (connect) {
+                    batch.Write(key, DBHistoryValue{false, txid, coin.out.nValue, prevout});
+                    batch.Erase(DBUnspentKey{script_hash, prevout});
+                } else {
+                    batch.Erase(key);
+                    batch.Write(DBUnspentKey{script_hash, prevout}, DBUnspentValue{int(coin.nHeight), coin.out.nValue});
+                }
+            }
+        }
+
+        if (connect) {
+            for (uint32_t j = 0; j < tx.vout.size(); ++j) {
+                const CTxOut& out{tx.vout[j]};
+                if (out.scriptPubKey.IsUnspendable()) continue;
+                const uint256 script_hash{HashScript(out.scriptPubKey)};
+                batch.Write(DBHistoryKey{script_hash, {height, i, true, j}}, DBHistoryValue{true, txid, out.nValue, {}});
+                batch.Write(DBUnspentKey{script_hash, {txid, j}}, DBUnspentValue{height, out.nValue});
+            }
+        }
+    }
+    return m_db->WriteBatch(batch);
+}
+
+bool AddressIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    // Exclude genesis block transaction because outputs are not spendable.
+    if (block.height == 0) return true;
+
+    assert(block.data);
+    CBlockUndo block_undo_read;
+    if (!block.undo_data) {
+        const CBlockIndex* pindex = WITH_LOCK(cs_main, return m_chainstate->m_blockman.LookupBlockIndex(block.hash));
+        if (!UndoReadFromDisk(block_undo_read, pindex)) {
+            return false;
+        }
+    }
+    return WriteBlock(*block.data, block.undo_data ? *block.undo_data : block_undo_read, block.height, /*connect=*/true);
+}
+
+bool AddressIndex::CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip)
+{
+    LOCK(cs_main);
+    const CBlockIndex* iter_tip{m_chainstate->m_blockman.LookupBlockIndex(current_tip.hash)};
+    const CBlockIndex* new_tip_index{m_chainstate->m_blockman.LookupBlockIndex(new_tip.hash)};
+    const auto& consensus_params{Params().GetConsensus()};
+
+    while (iter_tip != new_tip_index) {
+        CBlock block;
+        CBlockUndo block_undo;
+        if (!ReadBlockFromDisk(block, iter_tip, consensus_params) || !UndoReadFromDisk(block_undo, iter_tip)) {
+            return error("%s: Failed to read block %s from disk",
+                         __func__, iter_tip->GetBlockHash().ToString());
+        }
+        if (!WriteBlock(block, block_undo, iter_tip->nHeight, /*connect=*/false)) {
+            return false;
+        }
+        iter_tip = iter_tip->pprev;
+    }
+    return true;
+}
+
+bool AddressIndex::FindHistory(const CScript& script, const AddressHistoryPosition& start, size_t max_entries, std::vector<AddressHistoryEntry>& entries) const
+{
+    const uint256 script_hash{HashScript(script)};
+    std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+    DBHistoryKey key{script_hash, start};
+    for (db_it->Seek(key); db_it->Valid() && entries.size() < max_entries; db_it->Next()) {
+        if (!db_it->GetKey(key) || key.script_hash != script_hash) break;
+        DBHistoryValue value{key.pos.is_output, {}, 0, {}};
+        if (!db_it->GetValue(value)) {
+            return error("%s: unable to read value in %s at height %d", __func__, GetName(), key.pos.height);
+        }
+        entries.push_back({key.pos, value.txid, value.amount, value.prevout});
+    }
+    return true;
+}
+
+bool AddressIndex::FindUnspent(const CScript& script, const COutPoint& start, size_t max_entries, std::vector<AddressUnspentEntry>& entries) const
+{
+    const uint256 script_hash{HashScript(script)};
+    std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+    DBUnspentKey key{script_hash, start};
+    for (db_it->Seek(key); db_it->Valid() && entries.size() < max_entries; db_it->Next()) {
+        if (!db_it->GetKey(key) || key.script_hash != script_hash) break;
+        DBUnspentValue value;
+        if (!db_it->GetValue(value)) {
+            return error("%s: unable to read value in %s for %s", __func__, GetName(), key.outpoint.ToString());
+        }
+        entries.push_back({key.outpoint, value.height, value.amount});
+    }
+    return true;
+}
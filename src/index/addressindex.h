@@ -0,0 +1,117 @@
+// Copyright (c) 2022 The Garikcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_ADDRESSINDEX_H
+#define BITCOIN_INDEX_ADDRESSINDEX_H
+
+#include <consensus/amount.h>
+#include <index/base.h>
+#include <primitives/transaction.h>
+#include <uint256.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+class CBlock;
+class CBlockUndo;
+class CDBBatch;
+class CScript;
+
+static constexpr bool DEFAULT_ADDRESSINDEX{false};
+
+/** Position of an entry in the history of a script: an input or output of the
+ * transaction at position tx_pos in the block at the given height. */
+struct AddressHistoryPosition {
+    int height{0};
+    uint32_t tx_pos{0};
+    bool is_output{false};
+    uint32_t index{0};
+
+    /** Format as "<height>:<tx_pos>:<in|out>:<index>". */
+    std::string ToString() const;
+    static std::optional<AddressHistoryPosition> FromString(const std::string& str);
+};
+
+/** An output paying to a script, or an input spending such an output. */
+struct AddressHistoryEntry {
+    AddressHistoryPosition pos;
+    //! The transaction of the input or output
+    uint256 txid;
+    //! The amount received by the output, or spent by the input
+    CAmount amount{0};
+    //! The output spent by the input (inputs only)
+    COutPoint prevout;
+};
+
+/** An unspent output paying to a script. */
+struct AddressUnspentEntry {
+    COutPoint outpoint;
+    int height{0};
+    CAmount amount{0};
+};
+
+/**
+ * AddressIndex records for each scriptPubKey the inputs and outputs of the
+ * transactions in the active chain that pay to or spend from it, and the
+ * outputs paying to it that are still unspent.
+ *
+ * History entries are keyed by the SHA256 of the script, followed by the
+ * height, the position of the transaction in the block and the input or
+ * output index, so that the history of a script is one range of the database
+ * in chain order. Unspent outputs are keyed by the script hash and the
+ * outpoint, which the undo data of a spending block provides.
+ */
+class AddressIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+    /** Add the entries of a connected block, or remove them when it is disconnected. */
+    bool WriteBlock(const CBlock& block, const CBlockUndo& block_undo, int height, bool connect);
+
+    bool AllowPrune() const override { return true; }
+
+protected:
+    bool CustomAppend(const interfaces::BlockInfo& block) override;
+
+    bool CustomAppendNeedsUndo() const override { return true; }
+
+    bool CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit AddressIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~AddressIndex() override;
+
+    /// Look up the history of a script, in chain order.
+    ///
+    /// @param[in]   script  The scriptPubKey to look up.
+    /// @param[in]   start  The position of the first entry to return.
+    /// @param[in]   max_entries  The maximum number of entries to return.
+    /// @param[out]  entries  The entries found.
+    /// @return  false if the database could not be read
+    bool FindHistory(const CScript& script, const AddressHistoryPosition& start, size_t max_entries, std::vector<AddressHistoryEntry>& entries) const;
+
+    /// Look up the unspent outputs paying to a script, in outpoint order.
+    ///
+    /// @param[in]   script  The scriptPubKey to look up.
+    /// @param[in]   start  The first outpoint to return.
+    /// @param[in]   max_entries  The maximum number of entries to return.
+    /// @param[out]  entries  The entries found.
+    /// @return  false if the database could not be read
+    bool FindUnspent(const CScript& script, const COutPoint& start, size_t max_entries, std::vector<AddressUnspentEntry>& entries) const;
+};
+
+/// The global address index. May be null.
+extern std::unique_ptr<AddressIndex> g_address_index;
+
+#endif // BITCOIN_INDEX_ADDRESSINDEX_H
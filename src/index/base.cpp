@@ -11,6 +11,7 @@
 #include <node/interface_ui.h>
 #include <shutdown.h>
 #include <tinyformat.h>
+#include <undo.h>
 #include <util/syscall_sandbox.h>
 #include <util/system.h>
 #include <util/thread.h>
@@ -18,16 +19,23 @@
 #include <validation.h> // For g_chainman
 #include <warnings.h>
 
+#include <deque>
+#include <future>
 #include <string>
 #include <utility>
 
 using node::ReadBlockFromDisk;
+using node::UndoReadFromDisk;
 
 constexpr uint8_t DB_BEST_BLOCK{'B'};
 
 constexpr auto SYNC_LOG_INTERVAL{30s};
 constexpr auto SYNC_LOCATOR_WRITE_INTERVAL{30s};
 
+//! Number of blocks the sync thread keeps being read from disk in the
+//! background, including the one about to be indexed.
+constexpr size_t SYNC_READ_AHEAD_BLOCKS{8};
+
 template <typename... Args>
 static void FatalError(const char* fmt, const Args&... args)
 {
@@ -146,12 +154,37 @@ static const CBlockIndex* NextSyncBlock(const CBlockIndex* pindex_prev, CChain&
     return chain.Next(chain.FindFork(pindex_prev));
 }
 
+namespace {
+/** A block, and optionally its undo data, read from disk by the sync thread. */
+struct SyncBlockData {
+    bool ok{false};
+    CBlock block;
+    CBlockUndo undo;
+};
+} // namespace
+
+static SyncBlockData ReadSyncBlock(const CBlockIndex* pindex, bool read_undo, const Consensus::Params& consensus_params)
+{
+    SyncBlockData data;
+    data.ok = ReadBlockFromDisk(data.block, pindex, consensus_params) &&
+              (!read_undo || pindex->nHeight == 0 || UndoReadFromDisk(data.undo, pindex));
+    return data;
+}
+
 void BaseIndex::ThreadSync()
 {
     SetSyscallSandboxPolicy(SyscallSandboxPolicy::TX_INDEX);
     const CBlockIndex* pindex = m_best_block_index.load();
     if (!m_synced) {
         auto& consensus_params = Params().GetConsensus();
+        const bool read_undo{CustomAppendNeedsUndo()};
+
+        // Blocks following pindex on the active chain, read in the background
+        // so that disk reads overlap with CustomAppend.
+        std::deque<std::pair<const CBlockIndex*, std::future<SyncBlockData>>> read_ahead;
+        const auto read_block_async{[&](const CBlockIndex* block_index) {
+            read_ahead.emplace_back(block_index, std::async(std::launch::async, ReadSyncBlock, block_index, read_undo, std::cref(consensus_params)));
+        }};
 
         std::chrono::steady_clock::time_point last_log_time{0s};
         std::chrono::steady_clock::time_point last_locator_write_time{0s};
@@ -165,6 +198,9 @@ void BaseIndex::ThreadSync()
                 return;
             }
 
+            // Reads that are no longer needed after a reorg. Destroying them
+            // waits for the reads to finish, so do it without holding cs_main.
+            std::deque<std::pair<const CBlockIndex*, std::future<SyncBlockData>>> stale_reads;
             {
                 LOCK(cs_main);
                 const CBlockIndex* pindex_next = NextSyncBlock(pindex, m_chainstate->m_chain);
@@ -181,6 +217,16 @@ void BaseIndex::ThreadSync()
                     return;
                 }
                 pindex = pindex_next;
+
+                if (!read_ahead.empty() && read_ahead.front().first != pindex) {
+                    stale_reads.swap(read_ahead);
+                }
+                if (read_ahead.empty()) read_block_async(pindex);
+                while (read_ahead.size() < SYNC_READ_AHEAD_BLOCKS) {
+                    const CBlockIndex* block_index{m_chainstate->m_chain.Next(read_ahead.back().first)};
+                    if (!block_index) break;
+                    read_block_async(block_index);
+                }
             }
 
             auto current_time{std::chrono::steady_clock::now()};
@@ -197,14 +243,16 @@ void BaseIndex::ThreadSync()
                 Commit();
             }
 
-            CBlock block;
+            const SyncBlockData data{read_ahead.front().second.get()};
+            read_ahead.pop_front();
             interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex);
-            if (!ReadBlockFromDisk(block, pindex, consensus_params)) {
+            if (!data.ok) {
                 FatalError("%s: Failed to read block %s from disk",
                            __func__, pindex->GetBlockHash().ToString());
                 return;
             } else {
-                block_info.data = &block;
+                block_info.data = &data.block;
+                if (read_undo && pindex->nHeight > 0) block_info.undo_data = &data.undo;
             }
             if (!CustomAppend(block_info)) {
                 FatalError("%s: Failed to write block %s to index database",
@@ -25,6 +25,14 @@ struct IndexSummary {
     int best_block_height{0};
 };
 
+/** Counters describing the in-memory lookup cache of an index. */
+struct IndexCacheStats {
+    size_t entries{0};
+    size_t usage{0};
+    uint64_t hits{0};
+    uint64_t misses{0};
+};
+
 /**
  * Base class for indices of blockchain data. This implements
  * CValidationInterface and ensures blocks are indexed sequentially according
@@ -109,6 +117,12 @@ protected:
     /// Write update index entries for a newly connected block.
     [[nodiscard]] virtual bool CustomAppend(const interfaces::BlockInfo& block) { return true; }
 
+    /// Whether CustomAppend needs the block's undo data. If so, the sync
+    /// thread reads it ahead together with the block and passes it in
+    /// BlockInfo::undo_data. Blocks connected after the index is in sync are
+    /// passed without undo data.
+    virtual bool CustomAppendNeedsUndo() const { return false; }
+
     /// Virtual method called internally by Commit that can be overridden to atomically
     /// commit more index state.
     virtual bool CustomCommit(CDBBatch& batch) { return true; }
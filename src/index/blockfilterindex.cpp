@@ -7,6 +7,7 @@
 #include <dbwrapper.h>
 #include <hash.h>
 #include <index/blockfilterindex.h>
+#include <memusage.h>
 #include <node/blockstorage.h>
 #include <util/system.h>
 #include <validation.h>
@@ -41,6 +42,10 @@ constexpr unsigned int FLTR_FILE_CHUNK_SIZE = 0x100000; // 1 MiB
  *  is big enough for a 2,000,000 length block chain, which
  *  we should be enough until ~2047. */
 constexpr size_t CF_HEADERS_CACHE_MAX_SZ{2000};
+/** Maximum memory used by the cache of recently served filters. Basic filters of recent mainnet
+ *  blocks are around 20 KiB, so this keeps the last several hundred of them, enough to answer a
+ *  getcfilters request for the tip range from memory. */
+constexpr size_t CF_FILTER_CACHE_MAX_USAGE{16 << 20};
 
 namespace {
 
@@ -217,16 +222,19 @@ size_t BlockFilterIndex::WriteFilterToDisk(FlatFilePos& pos, const BlockFilter&
 
 bool BlockFilterIndex::CustomAppend(const interfaces::BlockInfo& block)
 {
-    CBlockUndo block_undo;
+    CBlockUndo block_undo_read;
     uint256 prev_header;
 
-    if (block.height > 0) {
+    if (block.height > 0 && !block.undo_data) {
         // pindex variable gives indexing code access to node internals. It
         // will be removed in upcoming commit
         const CBlockIndex* pindex = WITH_LOCK(cs_main, return m_chainstate->m_blockman.LookupBlockIndex(block.hash));
-        if (!UndoReadFromDisk(block_undo, pindex)) {
+        if (!UndoReadFromDisk(block_undo_read, pindex)) {
             return false;
         }
+    }
+
+    if (block.height > 0) {
 
         std::pair<uint256, DBVal> read_out;
         if (!m_db->Read(DBHeightKey(block.height - 1), read_out)) {
@@ -242,7 +250,7 @@ bool BlockFilterIndex::CustomAppend(const interfaces::BlockInfo& block)
         prev_header = read_out.second.header;
     }
 
-    BlockFilter filter(m_filter_type, *Assert(block.data), block_undo);
+    BlockFilter filter(m_filter_type, *Assert(block.data), block.undo_data ? *block.undo_data : block_undo_read);
 
     size_t bytes_written = WriteFilterToDisk(m_next_filter_pos, filter);
     if (bytes_written == 0) return false;
@@ -381,14 +389,79 @@ static bool LookupRange(CDBWrapper& db, const std::string& index_name, int start
     return true;
 }
 
+static size_t FilterCacheEntryUsage(const BlockFilter& filter)
+{
+    // One list node holding the filter and one map node pointing at it.
+    return memusage::MallocUsage(sizeof(BlockFilter) + 2 * sizeof(void*)) +
+           memusage::DynamicUsage(filter.GetEncodedFilter()) +
+           memusage::MallocUsage(sizeof(uint256) + 2 * sizeof(void*));
+}
+
+bool BlockFilterIndex::GetCachedFilter(const uint256& block_hash, BlockFilter& filter_out) const
+{
+    LOCK(m_cs_filter_cache);
+    auto it = m_filter_cache_map.find(block_hash);
+    if (it == m_filter_cache_map.end()) {
+        ++m_filter_cache_misses;
+        return false;
+    }
+    m_filter_cache.splice(m_filter_cache.begin(), m_filter_cache, it->second);
+    filter_out = *it->second;
+    ++m_filter_cache_hits;
+    return true;
+}
+
+void BlockFilterIndex::CacheFilter(const BlockFilter& filter) const
+{
+    const size_t usage{FilterCacheEntryUsage(filter)};
+    if (usage > CF_FILTER_CACHE_MAX_USAGE) return;
+
+    LOCK(m_cs_filter_cache);
+    // Another lookup may have raced us to reading the same filter.
+    if (m_filter_cache_map.count(filter.GetBlockHash())) return;
+
+    // A block hash commits to the block contents and thus to its filter, so entries never need to
+    // be invalidated on reorgs; they simply age out.
+    while (!m_filter_cache.empty() && m_filter_cache_usage + usage > CF_FILTER_CACHE_MAX_USAGE) {
+        const BlockFilter& oldest{m_filter_cache.back()};
+        m_filter_cache_usage -= FilterCacheEntryUsage(oldest);
+        m_filter_cache_map.erase(oldest.GetBlockHash());
+        m_filter_cache.pop_back();
+    }
+    m_filter_cache.push_front(filter);
+    m_filter_cache_map.emplace(filter.GetBlockHash(), m_filter_cache.begin());
+    m_filter_cache_usage += usage;
+}
+
+IndexCacheStats BlockFilterIndex::GetFilterCacheStats() const
+{
+    IndexCacheStats stats;
+    {
+        LOCK(m_cs_filter_cache);
+        stats.entries = m_filter_cache.size();
+        stats.usage = m_filter_cache_usage;
+    }
+    stats.hits = m_filter_cache_hits;
+    stats.misses = m_filter_cache_misses;
+    return stats;
+}
+
 bool BlockFilterIndex::LookupFilter(const CBlockIndex* block_index, BlockFilter& filter_out) const
 {
+    if (GetCachedFilter(block_index->GetBlockHash(), filter_out)) {
+        return true;
+    }
+
     DBVal entry;
     if (!LookupOne(*m_db, block_index, entry)) {
         return false;
     }
 
-    return ReadFilterFromDisk(entry.pos, entry.hash, filter_out);
+    if (!ReadFilterFromDisk(entry.pos, entry.hash, filter_out)) {
+        return false;
+    }
+    CacheFilter(filter_out);
+    return true;
 }
 
 bool BlockFilterIndex::LookupFilterHeader(const CBlockIndex* block_index, uint256& header_out)
@@ -429,13 +502,17 @@ bool BlockFilterIndex::LookupFilterRange(int start_height, const CBlockIndex* st
         return false;
     }
 
+    // Entries are ordered by height, so fill the output backwards while walking from stop_index
+    // to find the block hash each of them belongs to.
     filters_out.resize(entries.size());
-    auto filter_pos_it = filters_out.begin();
-    for (const auto& entry : entries) {
-        if (!ReadFilterFromDisk(entry.pos, entry.hash, *filter_pos_it)) {
+    const CBlockIndex* block_index = stop_index;
+    for (size_t i = entries.size(); i-- > 0; block_index = block_index->pprev) {
+        BlockFilter& filter = filters_out[i];
+        if (GetCachedFilter(block_index->GetBlockHash(), filter)) continue;
+        if (!ReadFilterFromDisk(entries[i].pos, entries[i].hash, filter)) {
             return false;
         }
-        ++filter_pos_it;
+        CacheFilter(filter);
     }
 
     return true;
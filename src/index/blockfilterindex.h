@@ -12,6 +12,9 @@
 #include <index/base.h>
 #include <util/hasher.h>
 
+#include <atomic>
+#include <list>
+
 static const char* const DEFAULT_BLOCKFILTERINDEX = "0";
 
 /** Interval between compact filter checkpoints. See BIP 157. */
@@ -40,6 +43,21 @@ private:
     /** cache of block hash to filter header, to avoid disk access when responding to getcfcheckpt. */
     std::unordered_map<uint256, uint256, FilterHeaderHasher> m_headers_cache GUARDED_BY(m_cs_headers_cache);
 
+    using FilterCacheList = std::list<BlockFilter>;
+    mutable Mutex m_cs_filter_cache;
+    /** Recently served filters in least-recently-used order (front is most recent), shared by all
+     * lookups so that many peers requesting the same filters only read them from disk once. */
+    mutable FilterCacheList m_filter_cache GUARDED_BY(m_cs_filter_cache);
+    /** Block hash to position in m_filter_cache. */
+    mutable std::unordered_map<uint256, FilterCacheList::iterator, FilterHeaderHasher> m_filter_cache_map GUARDED_BY(m_cs_filter_cache);
+    /** Approximate memory used by the entries of m_filter_cache. */
+    mutable size_t m_filter_cache_usage GUARDED_BY(m_cs_filter_cache){0};
+    mutable std::atomic<uint64_t> m_filter_cache_hits{0};
+    mutable std::atomic<uint64_t> m_filter_cache_misses{0};
+
+    bool GetCachedFilter(const uint256& block_hash, BlockFilter& filter_out) const EXCLUSIVE_LOCKS_REQUIRED(!m_cs_filter_cache);
+    void CacheFilter(const BlockFilter& filter) const EXCLUSIVE_LOCKS_REQUIRED(!m_cs_filter_cache);
+
     bool AllowPrune() const override { return true; }
 
 protected:
@@ -49,6 +67,8 @@ protected:
 
     bool CustomAppend(const interfaces::BlockInfo& block) override;
 
+    bool CustomAppendNeedsUndo() const override { return true; }
+
     bool CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip) override;
 
     BaseIndex::DB& GetDB() const LIFETIMEBOUND override { return *m_db; }
@@ -61,18 +81,21 @@ public:
     BlockFilterType GetFilterType() const { return m_filter_type; }
 
     /** Get a single filter by block. */
-    bool LookupFilter(const CBlockIndex* block_index, BlockFilter& filter_out) const;
+    bool LookupFilter(const CBlockIndex* block_index, BlockFilter& filter_out) const EXCLUSIVE_LOCKS_REQUIRED(!m_cs_filter_cache);
 
     /** Get a single filter header by block. */
     bool LookupFilterHeader(const CBlockIndex* block_index, uint256& header_out) EXCLUSIVE_LOCKS_REQUIRED(!m_cs_headers_cache);
 
     /** Get a range of filters between two heights on a chain. */
     bool LookupFilterRange(int start_height, const CBlockIndex* stop_index,
-                           std::vector<BlockFilter>& filters_out) const;
+                           std::vector<BlockFilter>& filters_out) const EXCLUSIVE_LOCKS_REQUIRED(!m_cs_filter_cache);
 
     /** Get a range of filter hashes between two heights on a chain. */
     bool LookupFilterHashRange(int start_height, const CBlockIndex* stop_index,
                                std::vector<uint256>& hashes_out) const;
+
+    /** Get the current size and hit counters of the filter cache. */
+    IndexCacheStats GetFilterCacheStats() const EXCLUSIVE_LOCKS_REQUIRED(!m_cs_filter_cache);
 };
 
 /**
@@ -4,12 +4,20 @@
 
 #include <index/txindex.h>
 
+#include <core_memusage.h>
 #include <index/disktxpos.h>
+#include <memusage.h>
 #include <node/blockstorage.h>
 #include <util/system.h>
 #include <validation.h>
 
+#include <algorithm>
+#include <optional>
+#include <tuple>
+
+using node::IsCompressedBlockFile;
 using node::OpenBlockFile;
+using node::ReadCompressedBlockRecord;
 
 constexpr uint8_t DB_TXINDEX{'t'};
 
@@ -48,12 +56,21 @@ bool TxIndex::DB::WriteTxs(const std::vector<std::pair<uint256, CDiskTxPos>>& v_
     return WriteBatch(batch);
 }
 
-TxIndex::TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
-    : BaseIndex(std::move(chain), "txindex"), m_db(std::make_unique<TxIndex::DB>(n_cache_size, f_memory, f_wipe))
+TxIndex::TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe, size_t tx_cache_size)
+    : BaseIndex(std::move(chain), "txindex"), m_db(std::make_unique<TxIndex::DB>(n_cache_size, f_memory, f_wipe)),
+      m_tx_cache_max_usage{tx_cache_size}
 {}
 
 TxIndex::~TxIndex() = default;
 
+static size_t TxCacheEntryUsage(const CTransactionRef& tx)
+{
+    // One list node holding the entry and one map node pointing at it.
+    return memusage::MallocUsage(sizeof(uint256) + sizeof(CTransactionRef) + 2 * sizeof(void*)) +
+           RecursiveDynamicUsage(tx) +
+           memusage::MallocUsage(sizeof(uint256) + 3 * sizeof(void*));
+}
+
 bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
 {
     // Exclude genesis block transaction because outputs are not spendable.
@@ -67,35 +84,188 @@ bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
         vPos.emplace_back(tx->GetHash(), pos);
         pos.nTxOffset += ::GetSerializeSize(*tx, CLIENT_VERSION);
     }
-    return m_db->WriteTxs(vPos);
+    if (!m_db->WriteTxs(vPos)) return false;
+
+    // A transaction that is included again after a reorg is now found in this block.
+    LOCK(m_cs_tx_cache);
+    if (m_tx_cache.empty()) return true;
+    for (const auto& tx : block.data->vtx) {
+        const auto it{m_tx_cache_map.find(tx->GetHash())};
+        if (it == m_tx_cache_map.end()) continue;
+        m_tx_cache_usage -= TxCacheEntryUsage(it->second->tx);
+        m_tx_cache.erase(it->second);
+        m_tx_cache_map.erase(it);
+    }
+    return true;
 }
 
 BaseIndex::DB& TxIndex::GetDB() const { return *m_db; }
 
-bool TxIndex::FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRef& tx) const
+namespace {
+/**
+ * Reads transactions from the block files, keeping the block file and the
+ * header of the block read last, so that reading transactions in the order
+ * they are stored opens each file and reads each header only once.
+ */
+class TxReader
 {
-    CDiskTxPos postx;
-    if (!m_db->ReadTxPos(tx_hash, postx)) {
+    std::optional<CAutoFile> m_file;
+    FlatFilePos m_block_pos;
+    bool m_compressed{false};
+    //! The record of the block in a compressed block file: the network magic and the size of the block, followed by the block
+    std::vector<uint8_t> m_record;
+    CBlockHeader m_header;
+
+public:
+    bool Read(const CDiskTxPos& pos, uint256& block_hash, CTransactionRef& tx)
+    {
+        try {
+            if (!m_file || pos.nFile != m_block_pos.nFile) {
+                // Files are only appended to, and OpenBlockFile() waits for all data queued for writing
+                // at or after pos, so the file stays good for reading any later position.
+                m_file.emplace(OpenBlockFile(pos, true), SER_DISK, CLIENT_VERSION);
+                if (m_file->IsNull()) {
+                    m_file.reset();
+                    return error("%s: OpenBlockFile failed", __func__);
+                }
+                m_compressed = IsCompressedBlockFile(m_file->Get(), pos);
+                m_block_pos.SetNull();
+            }
+            if (pos.nPos != m_block_pos.nPos) {
+                m_block_pos.SetNull();
+                if (m_compressed) {
+                    if (!ReadCompressedBlockRecord(m_file->Get(), pos, m_record)) return false;
+                    SpanReader{SER_DISK, CLIENT_VERSION, Span{m_record}.subspan(8)} >> m_header;
+                } else {
+                    if (fseek(m_file->Get(), pos.nPos, SEEK_SET)) {
+                        return error("%s: fseek(...) failed", __func__);
+                    }
+                    *m_file >> m_header;
+                }
+                m_block_pos = pos;
+            }
+            const size_t header_size{::GetSerializeSize(m_header, CLIENT_VERSION)};
+            if (m_compressed) {
+                const size_t tx_pos{8 + header_size + pos.nTxOffset};
+                if (tx_pos > m_record.size()) return error("%s: transaction is beyond the block", __func__);
+                SpanReader{SER_DISK, CLIENT_VERSION, Span{m_record}.subspan(tx_pos)} >> tx;
+            } else {
+                if (fseek(m_file->Get(), pos.nPos + header_size + pos.nTxOffset, SEEK_SET)) {
+                    return error("%s: fseek(...) failed", __func__);
+                }
+                *m_file >> tx;
+            }
+        } catch (const std::exception& e) {
+            m_block_pos.SetNull();
+            return error("%s: Deserialize or I/O error - %s", __func__, e.what());
+        }
+        block_hash = m_header.GetHash();
+        return true;
+    }
+};
+} // namespace
+
+bool TxIndex::GetCachedTx(const uint256& tx_hash, uint256& block_hash, CTransactionRef& tx) const
+{
+    LOCK(m_cs_tx_cache);
+    auto it = m_tx_cache_map.find(tx_hash);
+    if (it == m_tx_cache_map.end()) {
+        ++m_tx_cache_misses;
         return false;
     }
+    m_tx_cache.splice(m_tx_cache.begin(), m_tx_cache, it->second);
+    block_hash = it->second->block_hash;
+    tx = it->second->tx;
+    ++m_tx_cache_hits;
+    return true;
+}
+
+void TxIndex::CacheTx(const uint256& block_hash, const CTransactionRef& tx) const
+{
+    const size_t usage{TxCacheEntryUsage(tx)};
+    if (usage > m_tx_cache_max_usage) return;
+
+    LOCK(m_cs_tx_cache);
+    // Another lookup may have raced us to reading the same transaction.
+    if (m_tx_cache_map.count(tx->GetHash())) return;
+
+    while (!m_tx_cache.empty() && m_tx_cache_usage + usage > m_tx_cache_max_usage) {
+        const CachedTx& oldest{m_tx_cache.back()};
+        m_tx_cache_usage -= TxCacheEntryUsage(oldest.tx);
+        m_tx_cache_map.erase(oldest.tx->GetHash());
+        m_tx_cache.pop_back();
+    }
+    m_tx_cache.push_front({block_hash, tx});
+    m_tx_cache_map.emplace(tx->GetHash(), m_tx_cache.begin());
+    m_tx_cache_usage += usage;
+}
 
-    CAutoFile file(OpenBlockFile(postx, true), SER_DISK, CLIENT_VERSION);
-    if (file.IsNull()) {
-        return error("%s: OpenBlockFile failed", __func__);
+IndexCacheStats TxIndex::GetTxCacheStats() const
+{
+    IndexCacheStats stats;
+    {
+        LOCK(m_cs_tx_cache);
+        stats.entries = m_tx_cache.size();
+        stats.usage = m_tx_cache_usage;
     }
-    CBlockHeader header;
-    try {
-        file >> header;
-        if (fseek(file.Get(), postx.nTxOffset, SEEK_CUR)) {
-            return error("%s: fseek(...) failed", __func__);
+    stats.hits = m_tx_cache_hits;
+    stats.misses = m_tx_cache_misses;
+    return stats;
+}
+
+bool TxIndex::FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRef& tx) const
+{
+    std::vector<uint256> block_hashes;
+    std::vector<CTransactionRef> txs;
+    if (FindTxs(Span{&tx_hash, 1}, block_hashes, txs) == 0) {
+        return false;
+    }
+    block_hash = block_hashes[0];
+    tx = std::move(txs[0]);
+    return true;
+}
+
+size_t TxIndex::FindTxs(Span<const uint256> tx_hashes, std::vector<uint256>& block_hashes, std::vector<CTransactionRef>& txs) const
+{
+    block_hashes.assign(tx_hashes.size(), uint256{});
+    txs.assign(tx_hashes.size(), nullptr);
+    size_t found{0};
+
+    std::vector<size_t> misses;
+    for (size_t i = 0; i < tx_hashes.size(); ++i) {
+        if (GetCachedTx(tx_hashes[i], block_hashes[i], txs[i])) {
+            ++found;
+        } else {
+            misses.push_back(i);
         }
-        file >> tx;
-    } catch (const std::exception& e) {
-        return error("%s: Deserialize or I/O error - %s", __func__, e.what());
     }
-    if (tx->GetHash() != tx_hash) {
-        return error("%s: txid mismatch", __func__);
+    if (misses.empty()) return found;
+
+    // Neighbouring keys share LevelDB blocks
+    std::sort(misses.begin(), misses.end(), [&](size_t a, size_t b) { return tx_hashes[a] < tx_hashes[b]; });
+    std::vector<std::pair<CDiskTxPos, size_t>> positions;
+    positions.reserve(misses.size());
+    for (const size_t i : misses) {
+        CDiskTxPos pos;
+        if (m_db->ReadTxPos(tx_hashes[i], pos)) positions.emplace_back(pos, i);
+    }
+
+    std::sort(positions.begin(), positions.end(), [](const auto& a, const auto& b) {
+        return std::tie(a.first.nFile, a.first.nPos, a.first.nTxOffset) < std::tie(b.first.nFile, b.first.nPos, b.first.nTxOffset);
+    });
+    TxReader reader;
+    for (const auto& [pos, i] : positions) {
+        bool ok{reader.Read(pos, block_hashes[i], txs[i])};
+        if (ok && txs[i]->GetHash() != tx_hashes[i]) {
+            ok = error("%s: txid mismatch", __func__);
+        }
+        if (!ok) {
+            block_hashes[i].SetNull();
+            txs[i] = nullptr;
+            continue;
+        }
+        CacheTx(block_hashes[i], txs[i]);
+        ++found;
     }
-    block_hash = header.GetHash();
-    return true;
+    return found;
 }
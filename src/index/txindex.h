@@ -6,8 +6,20 @@
 #define BITCOIN_INDEX_TXINDEX_H
 
 #include <index/base.h>
+#include <primitives/transaction.h>
+#include <span.h>
+#include <sync.h>
+#include <uint256.h>
+#include <util/hasher.h>
+
+#include <atomic>
+#include <list>
+#include <unordered_map>
+#include <vector>
 
 static constexpr bool DEFAULT_TXINDEX{false};
+/** Default for the maximum memory used by the cache of recently looked up transactions. */
+static constexpr size_t DEFAULT_TX_CACHE_SIZE{16 << 20};
 
 /**
  * TxIndex is used to look up transactions included in the blockchain by hash.
@@ -22,16 +34,38 @@ protected:
 private:
     const std::unique_ptr<DB> m_db;
 
+    struct CachedTx {
+        uint256 block_hash;
+        CTransactionRef tx;
+    };
+    using TxCacheList = std::list<CachedTx>;
+    const size_t m_tx_cache_max_usage;
+    mutable Mutex m_cs_tx_cache;
+    /** Recently looked up transactions in least-recently-used order (front is most recent), so
+     * that transactions requested again and again are only read from disk once. */
+    mutable TxCacheList m_tx_cache GUARDED_BY(m_cs_tx_cache);
+    /** Txid to position in m_tx_cache. */
+    mutable std::unordered_map<uint256, TxCacheList::iterator, SaltedTxidHasher> m_tx_cache_map GUARDED_BY(m_cs_tx_cache);
+    /** Approximate memory used by the entries of m_tx_cache. */
+    mutable size_t m_tx_cache_usage GUARDED_BY(m_cs_tx_cache){0};
+    mutable std::atomic<uint64_t> m_tx_cache_hits{0};
+    mutable std::atomic<uint64_t> m_tx_cache_misses{0};
+
+    bool GetCachedTx(const uint256& tx_hash, uint256& block_hash, CTransactionRef& tx) const EXCLUSIVE_LOCKS_REQUIRED(!m_cs_tx_cache);
+    void CacheTx(const uint256& block_hash, const CTransactionRef& tx) const EXCLUSIVE_LOCKS_REQUIRED(!m_cs_tx_cache);
+
     bool AllowPrune() const override { return false; }
 
 protected:
-    bool CustomAppend(const interfaces::BlockInfo& block) override;
+    bool CustomAppend(const interfaces::BlockInfo& block) override EXCLUSIVE_LOCKS_REQUIRED(!m_cs_tx_cache);
 
     BaseIndex::DB& GetDB() const override;
 
 public:
-    /// Constructs the index, which becomes available to be queried.
-    explicit TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+    /// Constructs the index, which becomes available to be queried. Up to tx_cache_size bytes
+    /// of recently looked up transactions are kept in memory.
+    explicit TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false,
+                     size_t tx_cache_size = DEFAULT_TX_CACHE_SIZE);
 
     // Destructor is declared because this class contains a unique_ptr to an incomplete type.
     virtual ~TxIndex() override;
@@ -42,7 +76,21 @@ public:
     /// @param[out]  block_hash  The hash of the block the transaction is found in.
     /// @param[out]  tx  The transaction itself.
     /// @return  true if transaction is found, false otherwise
-    bool FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRef& tx) const;
+    bool FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRef& tx) const EXCLUSIVE_LOCKS_REQUIRED(!m_cs_tx_cache);
+
+    /// Look up many transactions by hash. The positions of the transactions
+    /// missing from the cache are read from the database in key order, and the
+    /// transactions are then read in the order they are stored in the block
+    /// files, opening each file and reading each block header only once.
+    ///
+    /// @param[in]   tx_hashes  The hashes of the transactions to be returned.
+    /// @param[out]  block_hashes  For each transaction, the hash of the block it is found in.
+    /// @param[out]  txs  For each transaction, the transaction itself, or nullptr if it is not found.
+    /// @return  the number of transactions found
+    size_t FindTxs(Span<const uint256> tx_hashes, std::vector<uint256>& block_hashes, std::vector<CTransactionRef>& txs) const EXCLUSIVE_LOCKS_REQUIRED(!m_cs_tx_cache);
+
+    /// Get the current size and hit counters of the transaction cache.
+    IndexCacheStats GetTxCacheStats() const EXCLUSIVE_LOCKS_REQUIRED(!m_cs_tx_cache);
 };
 
 /// The global transaction index, used in GetTransaction. May be null.
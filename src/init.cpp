@@ -19,11 +19,13 @@
 #include <chain.h>
 #include <chainparams.h>
 #include <consensus/amount.h>
+#include <dbwrapper.h>
 #include <deploymentstatus.h>
 #include <fs.h>
 #include <hash.h>
 #include <httprpc.h>
 #include <httpserver.h>
+#include <index/addressindex.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
 #include <index/txindex.h>
@@ -112,10 +114,15 @@ using kernel::ValidationCacheSizes;
 using node::ApplyArgsManOptions;
 using node::CacheSizes;
 using node::CalculateCacheSizes;
+using node::DEFAULT_BLOCK_COMPRESSION;
+using node::DEFAULT_BLOCK_WRITE_BUFFER;
 using node::DEFAULT_PERSIST_MEMPOOL;
 using node::DEFAULT_PRINTPRIORITY;
+using node::DEFAULT_PRUNE_BATCH;
+using node::DEFAULT_REINDEX_THREADS;
 using node::DEFAULT_STOPAFTERBLOCKIMPORT;
 using node::LoadChainstate;
+using node::MAX_REINDEX_THREADS;
 using node::MempoolPath;
 using node::ShouldPersistMempool;
 using node::NodeContext;
@@ -123,6 +130,8 @@ using node::ThreadImport;
 using node::VerifyLoadedChainstate;
 using node::fPruneMode;
 using node::fReindex;
+using node::g_prune_batch;
+using node::g_prune_undo_depth;
 using node::nPruneTarget;
 
 static const bool DEFAULT_PROXYRANDOMIZE = true;
@@ -206,6 +215,9 @@ void Interrupt(NodeContext& node)
     if (g_coin_stats_index) {
         g_coin_stats_index->Interrupt();
     }
+    if (g_address_index) {
+        g_address_index->Interrupt();
+    }
 }
 
 void Shutdown(NodeContext& node)
@@ -243,6 +255,9 @@ void Shutdown(NodeContext& node)
     // CScheduler/checkqueue, scheduler and load block thread.
     if (node.scheduler) node.scheduler->stop();
     if (node.chainman && node.chainman->m_load_block.joinable()) node.chainman->m_load_block.join();
+    if (node.chainman) node.chainman->StopBackgroundValidation();
+    if (node.chainman) node.chainman->StopBackgroundVerification();
+    if (node.chainman) node.chainman->m_blockman.StopBlockFileCompression();
     StopScriptCheckWorkerThreads();
 
     // After the threads that potentially access these pointers have been stopped,
@@ -283,6 +298,10 @@ void Shutdown(NodeContext& node)
         g_coin_stats_index->Stop();
         g_coin_stats_index.reset();
     }
+    if (g_address_index) {
+        g_address_index->Stop();
+        g_address_index.reset();
+    }
     ForEachBlockFilterIndex([](BlockFilterIndex& index) { index.Stop(); });
     DestroyAllBlockFilterIndexes();
 
@@ -300,6 +319,8 @@ void Shutdown(NodeContext& node)
                 chainstate->ResetCoinsViews();
             }
         }
+        // Let the next startup load the block index with a single read
+        node.chainman->m_blockman.WriteBlockIndexSnapshot();
     }
     for (const auto& client : node.chain_clients) {
         client->stop();
@@ -406,9 +427,13 @@ void SetupServerArgs(ArgsManager& argsman)
 
     argsman.AddArg("-version", "Print version and exit", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
 #if HAVE_SYSTEM
+    argsman.AddArg("-addressindex", strprintf("Maintain an index of the transaction inputs and outputs of each address or scriptPubKey, used by the getaddresshistory and getaddressutxos RPCs and the /rest/address/ endpoints (default: %u)", DEFAULT_ADDRESSINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-alertnotify=<cmd>", "Execute command when an alert is raised (%s in cmd is replaced by message)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
 #endif
     argsman.AddArg("-assumevalid=<hex>", strprintf("If this block is in the chain assume that it and its ancestors are valid and potentially skip their script verification (0 to verify all, default: %s, testnet: %s, signet: %s)", defaultChainParams->GetConsensus().defaultAssumeValid.GetHex(), testnetChainParams->GetConsensus().defaultAssumeValid.GetHex(), signetChainParams->GetConsensus().defaultAssumeValid.GetHex()), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-backgroundvalidationbudget=<n>", strprintf("Percentage of time (0 to 100) spent validating the blocks beneath a loaded UTXO snapshot in the background, once the snapshot chainstate has caught up with the tip. 0 pauses background validation (default: %u)", DEFAULT_BACKGROUND_VALIDATION_BUDGET), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-blockcompression", strprintf("Compress block files in the background once they are complete. Compressed block files stay readable without this option (default: %u)", DEFAULT_BLOCK_COMPRESSION), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-blockwritebuffer=<n>", strprintf("Write blocks and undo data to disk in the background, buffering up to <n> MiB of them, or 0 to write them before continuing (default: %u)", DEFAULT_BLOCK_WRITE_BUFFER), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-blocksdir=<dir>", "Specify directory to hold blocks subdirectory for *.dat files (default: <datadir>)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-fastprune", "Use smaller block files and lower minimum prune height for testing purposes", ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
 #if HAVE_SYSTEM
@@ -421,6 +446,10 @@ void SetupServerArgs(ArgsManager& argsman)
     argsman.AddArg("-datadir=<dir>", "Specify data directory", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-dbbatchsize", strprintf("Maximum database write batch size in bytes (default: %u)", nDefaultDbBatchSize), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
     argsman.AddArg("-dbcache=<n>", strprintf("Maximum database cache size <n> MiB (%d to %d, default: %d). In addition, unused mempool memory is shared for this cache (see -maxmempool).", nMinDbCache, nMaxDbCache, nDefaultDbCache), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-dboption=<db>:<option>=<n>", "Tune the LevelDB database <db> as named by getdatabaseinfo (e.g. chainstate, blocks/index, indexes/txindex), or all databases if <db> is *. "
+                   "Options: blockcache (share of the database cache used as block cache, in percent, default: 50), writebuffer (share of the database cache used for each of up to two write buffers, in percent, default: 25), "
+                   "bloombits (bloom filter bits per key, 0 to disable, default: 10), blocksize (size of the data blocks read from disk, in KiB, default: 4), maxfilesize (size at which new table files are started, in KiB, default: 2048), "
+                   "maxopenfiles (maximum number of open table files, 0 for the platform default). Can be specified multiple times", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-includeconf=<file>", "Specify additional configuration file, relative to the -datadir path (only useable from configuration file, not command line)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-loadblock=<file>", "Imports blocks from external file on startup", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-maxmempool=<n>", strprintf("Keep the transaction memory pool below <n> megabytes (default: %u)", DEFAULT_MAX_MEMPOOL_SIZE_MB), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
@@ -434,7 +463,10 @@ void SetupServerArgs(ArgsManager& argsman)
     argsman.AddArg("-prune=<n>", strprintf("Reduce storage requirements by enabling pruning (deleting) of old blocks. This allows the pruneblockchain RPC to be called to delete specific blocks and enables automatic pruning of old blocks if a target size in MiB is provided. This mode is incompatible with -txindex. "
             "Warning: Reverting this setting requires re-downloading the entire blockchain. "
             "(default: 0 = disable pruning blocks, 1 = allow manual pruning via RPC, >=%u = automatically prune block files to stay under the specified target size in MiB)", MIN_DISK_SPACE_FOR_BLOCK_FILES / 1024 / 1024), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-prunebatch=<n>", strprintf("When pruning automatically, delete at most <n> block and undo files at once and the rest at later flushes, 0 for no limit (default: %u)", DEFAULT_PRUNE_BATCH), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-pruneundodepth=<n>", strprintf("When pruning, keep the blocks and undo data of at least the last <n> blocks, to be able to handle deeper reorganizations (minimum and default: %u)", MIN_BLOCKS_TO_KEEP), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-reindex", "Rebuild chain state and block index from the blk*.dat files on disk. This will also rebuild active optional indexes.", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-reindexthreads=<n>", strprintf("Number of threads to scan the block files and to read blocks ahead with during -reindex, up to %d. 0 reindexes the block files one after another (default: %d)", MAX_REINDEX_THREADS, DEFAULT_REINDEX_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-reindex-chainstate", "Rebuild chain state from the currently indexed blocks. When in pruning mode or if blocks on disk might be corrupted, use full -reindex instead. Deactivate all optional indexes before running this.", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-settings=<file>", strprintf("Specify path to dynamic settings data file. Can be disabled with -nosettings. File is written at runtime and not meant to be edited by users (use %s instead for custom settings). Relative paths will be prefixed by datadir location. (default: %s)", BITCOIN_CONF_FILENAME, BITCOIN_SETTINGS_FILENAME), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
 #if HAVE_SYSTEM
@@ -446,6 +478,7 @@ void SetupServerArgs(ArgsManager& argsman)
     hidden_args.emplace_back("-sysperms");
 #endif
     argsman.AddArg("-txindex", strprintf("Maintain a full transaction index, used by the getrawtransaction rpc call (default: %u)", DEFAULT_TXINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-utxostats", strprintf("Keep a running MuHash and basic statistics of the UTXO set up to date as blocks are connected, so that gettxoutsetinfo can return them without scanning the UTXO set (default: %u)", DEFAULT_RUNNING_COINS_STATS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-blockfilterindex=<type>",
                  strprintf("Maintain an index of compact filters by block (default: %s, values: %s).", DEFAULT_BLOCKFILTERINDEX, ListBlockFilterTypes()) +
                  " If <type> is not supplied or if <type> = 1, indexes for all known types are enabled.",
@@ -536,6 +569,7 @@ void SetupServerArgs(ArgsManager& argsman)
 #endif
 
     argsman.AddArg("-checkblocks=<n>", strprintf("How many blocks to check at startup (default: %u, 0 = all)", DEFAULT_CHECKBLOCKS), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
+    argsman.AddArg("-checkthreads=<n>", strprintf("Number of threads reading and checking blocks ahead while verifying the chain with -checkblocks or verifychain (1 to %d, default: %d)", MAX_CHECK_THREADS, DEFAULT_CHECK_THREADS), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-checklevel=<n>", strprintf("How thorough the block verification of -checkblocks is: %s (0-4, default: %u)", Join(CHECKLEVEL_DOC, ", "), DEFAULT_CHECKLEVEL), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-checkblockindex", strprintf("Do a consistency check for the block tree, chainstate, and other validation data structures occasionally. (default: %u, regtest: %u)", defaultChainParams->DefaultConsistencyChecks(), regtestChainParams->DefaultConsistencyChecks()), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
     argsman.AddArg("-checkaddrman=<n>", strprintf("Run addrman consistency checks every <n> operations. Use 0 to disable. (default: %u)", DEFAULT_ADDRMAN_CONSISTENCY_CHECKS), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::DEBUG_TEST);
@@ -959,6 +993,25 @@ bool AppInitParameterInteraction(const ArgsManager& args, bool use_syscall_sandb
         fPruneMode = true;
     }
 
+    const int64_t prune_undo_depth{args.GetIntArg("-pruneundodepth", MIN_BLOCKS_TO_KEEP)};
+    if (prune_undo_depth < MIN_BLOCKS_TO_KEEP || prune_undo_depth > std::numeric_limits<int>::max()) {
+        return InitError(strprintf(_("-pruneundodepth must be at least %u"), MIN_BLOCKS_TO_KEEP));
+    }
+    g_prune_undo_depth = prune_undo_depth;
+    const int64_t prune_batch{args.GetIntArg("-prunebatch", DEFAULT_PRUNE_BATCH)};
+    if (prune_batch < 0 || prune_batch > std::numeric_limits<int>::max()) {
+        return InitError(_("-prunebatch must not be negative"));
+    }
+    g_prune_batch = prune_batch;
+
+    if (const auto db_options{ReadDBOptions(args, /*name=*/"")}; !db_options) {
+        return InitError(util::ErrorString(db_options));
+    }
+
+    if (args.GetIntArg("-blockwritebuffer", DEFAULT_BLOCK_WRITE_BUFFER) < 0) {
+        return InitError(_("-blockwritebuffer must not be negative"));
+    }
+
     nConnectTimeout = args.GetIntArg("-timeout", DEFAULT_CONNECT_TIMEOUT);
     if (nConnectTimeout <= 0) {
         nConnectTimeout = DEFAULT_CONNECT_TIMEOUT;
@@ -1003,6 +1056,9 @@ bool AppInitParameterInteraction(const ArgsManager& args, bool use_syscall_sandb
         if (g_enabled_filter_types.count(BlockFilterType::BASIC)) {
             return InitError(_("-reindex-chainstate option is not compatible with -blockfilterindex. Please temporarily disable blockfilterindex while using -reindex-chainstate, or replace -reindex-chainstate with -reindex to fully rebuild all indexes."));
         }
+        if (args.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX)) {
+            return InitError(_("-reindex-chainstate option is not compatible with -addressindex. Please temporarily disable addressindex while using -reindex-chainstate, or replace -reindex-chainstate with -reindex to fully rebuild all indexes."));
+        }
         if (args.GetBoolArg("-txindex", DEFAULT_TXINDEX)) {
             return InitError(_("-reindex-chainstate option is not compatible with -txindex. Please temporarily disable txindex while using -reindex-chainstate, or replace -reindex-chainstate with -reindex to fully rebuild all indexes."));
         }
@@ -1397,6 +1453,9 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
     if (args.GetBoolArg("-txindex", DEFAULT_TXINDEX)) {
         LogPrintf("* Using %.1f MiB for transaction index database\n", cache_sizes.tx_index * (1.0 / 1024 / 1024));
     }
+    if (args.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX)) {
+        LogPrintf("* Using %.1f MiB for address index database\n", cache_sizes.address_index * (1.0 / 1024 / 1024));
+    }
     for (BlockFilterType filter_type : g_enabled_filter_types) {
         LogPrintf("* Using %.1f MiB for %s block filter index database\n",
                   cache_sizes.filter_index * (1.0 / 1024 / 1024), BlockFilterTypeName(filter_type));
@@ -1421,12 +1480,25 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
     }
     LogPrintf("* Using %.1f MiB for in-memory UTXO set (plus up to %.1f MiB of unused mempool space)\n", cache_sizes.coins * (1.0 / 1024 / 1024), mempool_opts.max_size_bytes * (1.0 / 1024 / 1024));
 
+    const int background_validation_budget{int(args.GetIntArg("-backgroundvalidationbudget", DEFAULT_BACKGROUND_VALIDATION_BUDGET))};
+    if (background_validation_budget < 0 || background_validation_budget > 100) {
+        return InitError(_("-backgroundvalidationbudget must be between 0 and 100"));
+    }
+
+    const int check_threads{int(args.GetIntArg("-checkthreads", DEFAULT_CHECK_THREADS))};
+    if (check_threads < 1 || check_threads > MAX_CHECK_THREADS) {
+        return InitError(strprintf(_("-checkthreads must be between 1 and %d"), MAX_CHECK_THREADS));
+    }
+
     for (bool fLoaded = false; !fLoaded && !ShutdownRequested();) {
         node.mempool = std::make_unique<CTxMemPool>(mempool_opts);
 
         const ChainstateManager::Options chainman_opts{
             .chainparams = chainparams,
             .adjusted_time_callback = GetAdjustedTime,
+            .running_coins_stats = args.GetBoolArg("-utxostats", DEFAULT_RUNNING_COINS_STATS),
+            .background_validation_budget = background_validation_budget,
+            .check_threads = check_threads,
         };
         node.chainman = std::make_unique<ChainstateManager>(chainman_opts);
         ChainstateManager& chainman = *node.chainman;
@@ -1534,6 +1606,13 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
         }
     }
 
+    if (args.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX)) {
+        g_address_index = std::make_unique<AddressIndex>(interfaces::MakeChain(node), cache_sizes.address_index, false, fReindex);
+        if (!g_address_index->Start()) {
+            return false;
+        }
+    }
+
     // ********************************************************* Step 9: load wallet
     for (const auto& client : node.chain_clients) {
         if (!client->load()) {
@@ -1599,6 +1678,11 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
     chainman.m_load_block = std::thread(&util::TraceThread, "loadblk", [=, &chainman, &args] {
         ThreadImport(chainman, vImportFiles, args, ShouldPersistMempool(args) ? MempoolPath(args) : fs::path{});
     });
+    if (args.GetBoolArg("-blockcompression", DEFAULT_BLOCK_COMPRESSION)) {
+        chainman.m_blockman.StartBlockFileCompression();
+    }
+    // Continue a background chain verification that was interrupted by a shutdown
+    chainman.ResumeBackgroundVerification();
 
     // Wait for genesis block to be processed
     {
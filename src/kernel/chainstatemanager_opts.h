@@ -12,6 +12,13 @@
 
 class CChainParams;
 
+static constexpr bool DEFAULT_RUNNING_COINS_STATS{false};
+//! Percentage of time spent validating the background chainstate of a UTXO snapshot.
+static constexpr int DEFAULT_BACKGROUND_VALIDATION_BUDGET{50};
+//! Number of threads reading and checking blocks while verifying the chain.
+static constexpr int DEFAULT_CHECK_THREADS{4};
+static constexpr int MAX_CHECK_THREADS{16};
+
 namespace kernel {
 
 /**
@@ -22,6 +29,14 @@ namespace kernel {
 struct ChainstateManagerOpts {
     const CChainParams& chainparams;
     const std::function<NodeClock::time_point()> adjusted_time_callback{nullptr};
+    //! Keep a running MuHash and basic statistics of the UTXO set as blocks are connected.
+    bool running_coins_stats{DEFAULT_RUNNING_COINS_STATS};
+    //! Percentage (0-100) of each second spent connecting blocks on the
+    //! background chainstate while a UTXO snapshot is being validated.
+    int background_validation_budget{DEFAULT_BACKGROUND_VALIDATION_BUDGET};
+    //! Number of threads reading and checking blocks ahead in VerifyDB() and
+    //! in background chain verification.
+    int check_threads{DEFAULT_CHECK_THREADS};
 };
 
 } // namespace kernel
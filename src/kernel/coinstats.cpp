@@ -23,13 +23,16 @@
 #include <validation.h>
 #include <version.h>
 
+#include <algorithm>
 #include <cassert>
 #include <iosfwd>
 #include <iterator>
+#include <future>
 #include <map>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace kernel {
 
@@ -56,6 +59,35 @@ CDataStream TxOutSer(const COutPoint& outpoint, const Coin& coin) {
     return ss;
 }
 
+void RunningCoinsStats::AddCoin(const COutPoint& outpoint, const Coin& coin)
+{
+    muhash.Insert(MakeUCharSpan(TxOutSer(outpoint, coin)));
+    ++coins_count;
+    bogo_size += GetBogoSize(coin.out.scriptPubKey);
+    total_amount += coin.out.nValue;
+}
+
+void RunningCoinsStats::RemoveCoin(const COutPoint& outpoint, const Coin& coin)
+{
+    muhash.Remove(MakeUCharSpan(TxOutSer(outpoint, coin)));
+    --coins_count;
+    bogo_size -= GetBogoSize(coin.out.scriptPubKey);
+    total_amount -= coin.out.nValue;
+}
+
+CCoinsStats RunningCoinsStats::ToStats(int block_height, const uint256& block_hash) const
+{
+    CCoinsStats stats{block_height, block_hash};
+    stats.nTransactionOutputs = coins_count;
+    stats.coins_count = coins_count;
+    stats.nBogoSize = bogo_size;
+    stats.total_amount = total_amount;
+    MuHash3072 muhash_final{muhash};
+    muhash_final.Finalize(stats.hashSerialized);
+    stats.running_stats_used = true;
+    return stats;
+}
+
 //! Warning: be very careful when changing this! assumeutxo and UTXO snapshot
 //! validation commitments are reliant on the hash constructed by this
 //! function.
@@ -68,7 +100,7 @@ CDataStream TxOutSer(const COutPoint& outpoint, const Coin& coin) {
 //! It is also possible, though very unlikely, that a change in this
 //! construction could cause a previously invalid (and potentially malicious)
 //! UTXO snapshot to be considered valid.
-static void ApplyHash(HashWriter& ss, const uint256& hash, const std::map<uint32_t, Coin>& outputs)
+void ApplyCoinHash(HashWriter& ss, const uint256& hash, const std::map<uint32_t, Coin>& outputs)
 {
     for (auto it = outputs.begin(); it != outputs.end(); ++it) {
         if (it == outputs.begin()) {
@@ -86,6 +118,11 @@ static void ApplyHash(HashWriter& ss, const uint256& hash, const std::map<uint32
     }
 }
 
+static void ApplyHash(HashWriter& ss, const uint256& hash, const std::map<uint32_t, Coin>& outputs)
+{
+    ApplyCoinHash(ss, hash, outputs);
+}
+
 static void ApplyHash(std::nullptr_t, const uint256& hash, const std::map<uint32_t, Coin>& outputs) {}
 
 static void ApplyHash(MuHash3072& muhash, const uint256& hash, const std::map<uint32_t, Coin>& outputs)
@@ -110,22 +147,17 @@ static void ApplyStats(CCoinsStats& stats, const uint256& hash, const std::map<u
     }
 }
 
-//! Calculate statistics about the unspent transaction output set
+//! Calculate statistics about the coins returned by the cursor
 template <typename T>
-static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, const std::function<void()>& interruption_point)
+static bool ApplyCoins(CCoinsViewCursor& cursor, CCoinsStats& stats, T& hash_obj, const std::function<void()>& interruption_point)
 {
-    std::unique_ptr<CCoinsViewCursor> pcursor(view->Cursor());
-    assert(pcursor);
-
-    PrepareHash(hash_obj, stats);
-
     uint256 prevkey;
     std::map<uint32_t, Coin> outputs;
-    while (pcursor->Valid()) {
+    while (cursor.Valid()) {
         interruption_point();
         COutPoint key;
         Coin coin;
-        if (pcursor->GetKey(key) && pcursor->GetValue(coin)) {
+        if (cursor.GetKey(key) && cursor.GetValue(coin)) {
             if (!outputs.empty() && key.hash != prevkey) {
                 ApplyStats(stats, prevkey, outputs);
                 ApplyHash(hash_obj, prevkey, outputs);
@@ -137,12 +169,81 @@ static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, c
         } else {
             return error("%s: unable to read value", __func__);
         }
-        pcursor->Next();
+        cursor.Next();
     }
     if (!outputs.empty()) {
         ApplyStats(stats, prevkey, outputs);
         ApplyHash(hash_obj, prevkey, outputs);
     }
+    return true;
+}
+
+static void CombineHash(MuHash3072& muhash, const MuHash3072& part) { muhash *= part; }
+static void CombineHash(std::nullptr_t, std::nullptr_t) {}
+
+//! Add the statistics of a disjoint part of the UTXO set to stats
+static void CombineStats(CCoinsStats& stats, const CCoinsStats& part)
+{
+    stats.nTransactions += part.nTransactions;
+    stats.nTransactionOutputs += part.nTransactionOutputs;
+    stats.nBogoSize += part.nBogoSize;
+    stats.coins_count += part.coins_count;
+    if (stats.total_amount.has_value() && part.total_amount.has_value()) {
+        stats.total_amount = CheckedAdd(*stats.total_amount, *part.total_amount);
+    } else {
+        stats.total_amount = std::nullopt;
+    }
+}
+
+//! The legacy serialized hash depends on the order of the coins, so the whole set is scanned with a single cursor.
+static bool ScanCoins(CCoinsView* view, CCoinsStats& stats, HashWriter& ss, const std::function<void()>& interruption_point)
+{
+    std::unique_ptr<CCoinsViewCursor> pcursor(view->Cursor());
+    assert(pcursor);
+    return ApplyCoins(*pcursor, stats, ss, interruption_point);
+}
+
+//! MuHash and the other statistics do not depend on the order of the coins, so
+//! ranges of the set are scanned in parallel and their results combined.
+template <typename T>
+static bool ScanCoins(CCoinsView* view, CCoinsStats& stats, T& hash_obj, const std::function<void()>& interruption_point)
+{
+    std::vector<std::unique_ptr<CCoinsViewCursor>> cursors{view->Cursors(GetCoinsScanRanges())};
+    assert(!cursors.empty());
+    if (cursors.size() == 1) {
+        return ApplyCoins(*cursors.front(), stats, hash_obj, interruption_point);
+    }
+
+    std::vector<CCoinsStats> part_stats(cursors.size());
+    std::vector<T> part_hashes(cursors.size());
+    std::vector<std::future<bool>> results;
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        results.push_back(std::async(std::launch::async, [&, i] {
+            return ApplyCoins(*cursors[i], part_stats[i], part_hashes[i], interruption_point);
+        }));
+    }
+    bool success{true};
+    for (auto& result : results) {
+        success &= result.get();
+    }
+    if (!success) return false;
+
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        CombineStats(stats, part_stats[i]);
+        CombineHash(hash_obj, part_hashes[i]);
+    }
+    return true;
+}
+
+//! Calculate statistics about the unspent transaction output set
+template <typename T>
+static bool ComputeUTXOStats(CCoinsView* view, CCoinsStats& stats, T hash_obj, const std::function<void()>& interruption_point)
+{
+    PrepareHash(hash_obj, stats);
+
+    if (!ScanCoins(view, stats, hash_obj, interruption_point)) {
+        return false;
+    }
 
     FinalizeHash(hash_obj, stats);
 
@@ -179,6 +280,47 @@ std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsV
     return stats;
 }
 
+int GetCoinsScanRanges()
+{
+    return std::clamp(GetNumCores(), 1, MAX_COINS_SCAN_RANGES);
+}
+
+std::optional<RunningCoinsStats> ComputeRunningCoinsStats(const std::vector<std::unique_ptr<CCoinsViewCursor>>& cursors, const std::function<void()>& interruption_point)
+{
+    std::vector<RunningCoinsStats> parts(cursors.size());
+    std::vector<std::future<bool>> results;
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        results.push_back(std::async(std::launch::async, [&, i] {
+            CCoinsViewCursor& cursor{*cursors[i]};
+            while (cursor.Valid()) {
+                interruption_point();
+                COutPoint key;
+                Coin coin;
+                if (!cursor.GetKey(key) || !cursor.GetValue(coin)) {
+                    return error("ComputeRunningCoinsStats: unable to read value");
+                }
+                parts[i].AddCoin(key, coin);
+                cursor.Next();
+            }
+            return true;
+        }));
+    }
+    bool success{true};
+    for (auto& result : results) {
+        success &= result.get();
+    }
+    if (!success) return std::nullopt;
+
+    RunningCoinsStats stats;
+    for (const RunningCoinsStats& part : parts) {
+        stats.muhash *= part.muhash;
+        stats.coins_count += part.coins_count;
+        stats.bogo_size += part.bogo_size;
+        stats.total_amount += part.total_amount;
+    }
+    return stats;
+}
+
 // The legacy hash serializes the hashBlock
 static void PrepareHash(HashWriter& ss, const CCoinsStats& stats)
 {
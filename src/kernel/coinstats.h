@@ -6,14 +6,21 @@
 #define BITCOIN_KERNEL_COINSTATS_H
 
 #include <consensus/amount.h>
+#include <crypto/muhash.h>
+#include <serialize.h>
 #include <streams.h>
 #include <uint256.h>
 
 #include <cstdint>
 #include <functional>
+#include <map>
+#include <memory>
 #include <optional>
+#include <vector>
 
 class CCoinsView;
+class CCoinsViewCursor;
+class HashWriter;
 class Coin;
 class COutPoint;
 class CScript;
@@ -45,6 +52,9 @@ struct CCoinsStats {
     //! Signals if the coinstatsindex was used to retrieve the statistics.
     bool index_used{false};
 
+    //! Signals if the running statistics of the chainstate were used, which do not include nTransactions.
+    bool running_stats_used{false};
+
     // Following values are only available from coinstats index
 
     //! Total cumulative amount of block subsidies up to and including this block
@@ -70,11 +80,45 @@ struct CCoinsStats {
     CCoinsStats(int block_height, const uint256& block_hash);
 };
 
+/**
+ * MuHash and basic statistics of a UTXO set that are updated coin by coin, so that they can be
+ * kept up to date alongside the set instead of being computed by scanning it.
+ */
+struct RunningCoinsStats {
+    MuHash3072 muhash;
+    uint64_t coins_count{0};
+    uint64_t bogo_size{0};
+    CAmount total_amount{0};
+
+    void AddCoin(const COutPoint& outpoint, const Coin& coin);
+    void RemoveCoin(const COutPoint& outpoint, const Coin& coin);
+
+    //! Get the statistics of the set at the given block. This finalizes the MuHash, which costs a
+    //! modular inversion.
+    CCoinsStats ToStats(int block_height, const uint256& block_hash) const;
+
+    SERIALIZE_METHODS(RunningCoinsStats, obj) { READWRITE(obj.muhash, obj.coins_count, obj.bogo_size, obj.total_amount); }
+};
+
 uint64_t GetBogoSize(const CScript& script_pub_key);
 
 CDataStream TxOutSer(const COutPoint& outpoint, const Coin& coin);
 
+//! Add the unspent outputs of the transaction with the given txid to the
+//! legacy serialized hash of the UTXO set. ComputeUTXOStats does this for each
+//! txid in key order, after writing the hash of the best block.
+void ApplyCoinHash(HashWriter& ss, const uint256& hash, const std::map<uint32_t, Coin>& outputs);
+
 std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point = {});
+
+//! Maximum number of ranges the UTXO set is split into to scan it in parallel.
+static constexpr int MAX_COINS_SCAN_RANGES{16};
+
+//! Number of ranges to split the UTXO set into to scan it in parallel: one per core, up to MAX_COINS_SCAN_RANGES.
+int GetCoinsScanRanges();
+
+//! Compute the running statistics of all coins returned by the cursors, each cursor on its own thread.
+std::optional<RunningCoinsStats> ComputeRunningCoinsStats(const std::vector<std::unique_ptr<CCoinsViewCursor>>& cursors, const std::function<void()>& interruption_point);
 } // namespace kernel
 
 #endif // BITCOIN_KERNEL_COINSTATS_H
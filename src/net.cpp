@@ -99,6 +99,19 @@ enum BindFlags {
     BF_DONT_ADVERTISE = (1U << 1),
 };
 
+/** Messages with a payload of at most this many bytes are copied, together
+ *  with their header, into a shared send buffer rather than being queued as
+ *  separate header and payload buffers. */
+static constexpr size_t MAX_COALESCED_PAYLOAD_SIZE{4 * 1024};
+
+/** A send buffer is not grown beyond this size by coalescing further messages
+ *  into it. */
+static constexpr size_t MAX_COALESCED_SEND_BUFFER_SIZE{64 * 1024};
+
+/** Receive buffers for incoming message payloads are grown at least this many
+ *  bytes ahead of the data received so far. */
+static constexpr unsigned int RECV_BUFFER_CHUNK_SIZE{256 * 1024};
+
 // The set of sockets cannot be modified while waiting
 // The sleep time needs to be small to avoid new sockets stalling
 static const uint64_t SELECT_TIMEOUT_MILLISECONDS = 50;
@@ -731,6 +744,11 @@ int V1TransportDeserializer::readHeader(Span<const uint8_t> msg_bytes)
     // switch state to reading message data
     in_data = true;
 
+    // Size the receive buffer from the header, so that most messages are
+    // received into a single allocation. Don't trust the length field beyond
+    // RECV_BUFFER_CHUNK_SIZE though, as the peer may never send that data.
+    vRecv.reserve(std::min<unsigned int>(hdr.nMessageSize, RECV_BUFFER_CHUNK_SIZE));
+
     return nCopy;
 }
 
@@ -739,13 +757,17 @@ int V1TransportDeserializer::readData(Span<const uint8_t> msg_bytes)
     unsigned int nRemaining = hdr.nMessageSize - nDataPos;
     unsigned int nCopy = std::min<unsigned int>(nRemaining, msg_bytes.size());
 
-    if (vRecv.size() < nDataPos + nCopy) {
-        // Allocate up to 256 KiB ahead, but never more than the total message size.
-        vRecv.resize(std::min(hdr.nMessageSize, nDataPos + nCopy + 256 * 1024));
+    if (vRecv.capacity() < nDataPos + nCopy) {
+        // Allocate at least RECV_BUFFER_CHUNK_SIZE ahead, doubling the buffer
+        // for large messages to bound the number of reallocations, but never
+        // more than the total message size.
+        vRecv.reserve(std::min<size_t>(hdr.nMessageSize, std::max<size_t>(nDataPos + nCopy + RECV_BUFFER_CHUNK_SIZE, 2 * vRecv.capacity())));
     }
 
+    // Append rather than resize-and-copy, so that the buffer is not
+    // zero-filled before being overwritten.
     hasher.Write(msg_bytes.first(nCopy));
-    memcpy(&vRecv[nDataPos], msg_bytes.data(), nCopy);
+    vRecv.write(MakeByteSpan(msg_bytes.first(nCopy)));
     nDataPos += nCopy;
 
     return nCopy;
@@ -2802,8 +2824,22 @@ void CConnman::PushMessage(CNode* pnode, CSerializedNetMsg&& msg)
         pnode->nSendSize += nTotalSize;
 
         if (pnode->nSendSize > nSendBufferMaxSize) pnode->fPauseSend = true;
-        pnode->vSendMsg.push_back(std::move(serializedHeader));
-        if (nMessageSize) pnode->vSendMsg.push_back(std::move(msg.data));
+        if (nMessageSize <= MAX_COALESCED_PAYLOAD_SIZE) {
+            // Append small messages to the last queued buffer while it has
+            // room, so that a burst of them (inv, getdata, headers, ...) is
+            // written with a single send() call instead of two per message.
+            // Appending never moves bytes that may already have been
+            // partially sent (see nSendOffset).
+            if (pnode->vSendMsg.empty() || pnode->vSendMsg.back().size() + nTotalSize > MAX_COALESCED_SEND_BUFFER_SIZE) {
+                pnode->vSendMsg.push_back(std::move(serializedHeader));
+            } else {
+                pnode->vSendMsg.back().insert(pnode->vSendMsg.back().end(), serializedHeader.begin(), serializedHeader.end());
+            }
+            pnode->vSendMsg.back().insert(pnode->vSendMsg.back().end(), msg.data.begin(), msg.data.end());
+        } else {
+            pnode->vSendMsg.push_back(std::move(serializedHeader));
+            pnode->vSendMsg.push_back(std::move(msg.data));
+        }
 
         // If write queue empty, attempt "optimistic write"
         if (optimisticSend) nBytesSent = SocketSendData(*pnode);
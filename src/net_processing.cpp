@@ -887,6 +887,11 @@ private:
      */
     void FindNextBlocksToDownload(const Peer& peer, unsigned int count, std::vector<const CBlockIndex*>& vBlocks, NodeId& nodeStaller) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+    /** Update vBlocks to contain up to count blocks beneath the base block of a
+     *  loaded UTXO snapshot, which the background chainstate needs to validate it.
+     *  Only called once the blocks towards the tip have been requested. */
+    void FindHistoricalBlocksToDownload(const Peer& peer, unsigned int count, std::vector<const CBlockIndex*>& vBlocks) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
     std::map<uint256, std::pair<NodeId, std::list<QueuedBlock>::iterator> > mapBlocksInFlight GUARDED_BY(cs_main);
 
     /** When our tip was last updated. */
@@ -1369,6 +1374,37 @@ void PeerManagerImpl::FindNextBlocksToDownload(const Peer& peer, unsigned int co
     }
 }
 
+void PeerManagerImpl::FindHistoricalBlocksToDownload(const Peer& peer, unsigned int count, std::vector<const CBlockIndex*>& vBlocks)
+{
+    if (count == 0 || IsLimitedPeer(peer)) return;
+
+    const Chainstate* background{m_chainman.BackgroundSyncChainstate()};
+    if (background == nullptr) return;
+    const CBlockIndex* base{m_chainman.GetSnapshotBaseBlock()};
+
+    // The peer must have the whole chain beneath the snapshot base block.
+    const CNodeState* state = State(peer.m_id);
+    assert(state != nullptr);
+    if (state->pindexBestKnownBlock == nullptr || state->pindexBestKnownBlock->GetAncestor(base->nHeight) != base) return;
+
+    const int fork_height{LastCommonAncestor(background->m_chain.Tip(), base)->nHeight};
+    const int window_end{std::min(base->nHeight, fork_height + int(BLOCK_DOWNLOAD_WINDOW))};
+    std::vector<const CBlockIndex*> to_fetch(window_end - fork_height);
+    if (to_fetch.empty()) return;
+    to_fetch.back() = base->GetAncestor(window_end);
+    for (size_t i = to_fetch.size() - 1; i > 0; --i) {
+        to_fetch[i - 1] = to_fetch[i]->pprev;
+    }
+
+    unsigned int added{0};
+    for (const CBlockIndex* pindex : to_fetch) {
+        if (pindex->nStatus & BLOCK_HAVE_DATA || IsBlockRequested(pindex->GetBlockHash())) continue;
+        if (!CanServeWitnesses(peer) && DeploymentActiveAt(*pindex, m_chainman, Consensus::DEPLOYMENT_SEGWIT)) return;
+        vBlocks.push_back(pindex);
+        if (++added == count) return;
+    }
+}
+
 } // namespace
 
 void PeerManagerImpl::PushNodeVersion(CNode& pnode, const Peer& peer)
@@ -5693,6 +5729,7 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
             std::vector<const CBlockIndex*> vToDownload;
             NodeId staller = -1;
             FindNextBlocksToDownload(*peer, MAX_BLOCKS_IN_TRANSIT_PER_PEER - state.nBlocksInFlight, vToDownload, staller);
+            FindHistoricalBlocksToDownload(*peer, MAX_BLOCKS_IN_TRANSIT_PER_PEER - state.nBlocksInFlight - vToDownload.size(), vToDownload);
             for (const CBlockIndex *pindex : vToDownload) {
                 uint32_t nFetchFlags = GetFetchFlags(*peer);
                 vGetData.push_back(CInv(MSG_BLOCK | nFetchFlags, pindex->GetBlockHash()));
@@ -8,6 +8,7 @@
 #include <chainparams.h>
 #include <clientversion.h>
 #include <consensus/validation.h>
+#include <crypto/sha256.h>
 #include <flatfile.h>
 #include <fs.h>
 #include <hash.h>
@@ -17,11 +18,20 @@
 #include <signet.h>
 #include <streams.h>
 #include <undo.h>
+#include <util/lz.h>
 #include <util/syscall_sandbox.h>
 #include <util/system.h>
+#include <util/thread.h>
+#include <util/time.h>
 #include <validation.h>
 
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <list>
 #include <map>
+#include <thread>
 #include <unordered_map>
 
 namespace node {
@@ -29,6 +39,15 @@ std::atomic_bool fImporting(false);
 std::atomic_bool fReindex(false);
 bool fPruneMode = false;
 uint64_t nPruneTarget = 0;
+int g_prune_undo_depth = MIN_BLOCKS_TO_KEEP;
+int g_prune_batch = DEFAULT_PRUNE_BATCH;
+
+/** The number of blocks to keep below the deepest prune lock.
+ *  There is nothing special about this number. It is higher than what we
+ *  expect to see in regular mainnet reorgs, but not so high that it would
+ *  noticeably interfere with the pruning mechanism.
+ * */
+static constexpr int PRUNE_LOCK_BUFFER{10};
 
 bool CBlockIndexWorkComparator::operator()(const CBlockIndex* pa, const CBlockIndex* pb) const
 {
@@ -58,6 +77,195 @@ static FILE* OpenUndoFile(const FlatFilePos& pos, bool fReadOnly = false);
 static FlatFileSeq BlockFileSeq();
 static FlatFileSeq UndoFileSeq();
 
+/** Range of blk or rev data that is queued for writing but not written yet. */
+struct PendingWrite {
+    bool undo;
+    int file;
+    unsigned int begin;
+    unsigned int end;
+};
+
+//! Queued writes of all BlockFileWriters, which readers of the same data wait for
+static GlobalMutex g_pending_writes_mutex;
+static std::condition_variable g_pending_writes_cv;
+static std::list<PendingWrite> g_pending_writes GUARDED_BY(g_pending_writes_mutex);
+
+//! Wait until no data at or after pos in a blk or rev file is queued for writing.
+static void WaitForPendingWrites(bool undo, const FlatFilePos& pos)
+{
+    WAIT_LOCK(g_pending_writes_mutex, lock);
+    const auto is_pending{[&](const PendingWrite& write) { return write.undo == undo && write.file == pos.nFile && write.end > pos.nPos; }};
+    while (std::any_of(g_pending_writes.begin(), g_pending_writes.end(), is_pending)) g_pending_writes_cv.wait(lock);
+}
+
+//! Write data at pos of an open blk or rev file.
+static bool WriteToFile(FILE* file, const FlatFilePos& pos, Span<const unsigned char> data)
+{
+    return fseek(file, pos.nPos, SEEK_SET) == 0 && fwrite(data.data(), 1, data.size(), file) == data.size();
+}
+
+/**
+ * Writes block and undo data in a background thread, so that storing a block
+ * or connecting it doesn't wait for disk I/O. Jobs run in the order they are
+ * queued, and consecutive writes to the same file share one open file. At most
+ * max_buffered_bytes of data are queued at a time; queueing more waits for the
+ * thread to catch up. Readers of data that is still queued wait for it in
+ * OpenBlockFile() and OpenUndoFile().
+ */
+class BlockFileWriter
+{
+    struct Job {
+        bool undo;
+        FlatFilePos pos;
+        //! Data to write at pos, empty to flush the file instead
+        std::vector<unsigned char> data;
+        //! When flushing, whether to truncate the file at pos because it is complete
+        bool finalize{false};
+        std::list<PendingWrite>::iterator pending{};
+    };
+
+    const size_t m_max_buffered_bytes;
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Job> m_jobs GUARDED_BY(m_mutex);
+    //! Size of the queued data, including the data being written
+    size_t m_buffered_bytes GUARDED_BY(m_mutex){0};
+    //! Whether the thread is running jobs it took off the queue
+    bool m_running GUARDED_BY(m_mutex){false};
+    bool m_stop GUARDED_BY(m_mutex){false};
+    std::thread m_thread;
+
+    void Enqueue(Job&& job) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        // Always accept data when nothing is buffered, however large it is
+        while (m_buffered_bytes > 0 && m_buffered_bytes + job.data.size() > m_max_buffered_bytes) m_cv.wait(lock);
+        m_buffered_bytes += job.data.size();
+        m_jobs.push_back(std::move(job));
+        m_cv.notify_all();
+    }
+
+    void ThreadWrite() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        while (true) {
+            std::deque<Job> jobs;
+            {
+                WAIT_LOCK(m_mutex, lock);
+                while (!m_stop && m_jobs.empty()) m_cv.wait(lock);
+                // Stop only once everything queued is written
+                if (m_jobs.empty()) return;
+                jobs.swap(m_jobs);
+                m_running = true;
+            }
+
+            FILE* file{nullptr};
+            bool file_undo{false};
+            int file_number{0};
+            const auto close_file{[&] {
+                if (file && fclose(file) != 0) AbortNode(file_undo ? "Failed to write undo data" : "Failed to write block");
+                file = nullptr;
+            }};
+            size_t written_bytes{0};
+            for (const Job& job : jobs) {
+                if (job.data.empty()) {
+                    close_file();
+                    if (!(job.undo ? UndoFileSeq() : BlockFileSeq()).Flush(job.pos, job.finalize)) {
+                        AbortNode(strprintf("Flushing %s file to disk failed. This is likely the result of an I/O error.", job.undo ? "undo" : "block"));
+                    }
+                    continue;
+                }
+                if (file && (file_undo != job.undo || file_number != job.pos.nFile)) close_file();
+                if (!file) {
+                    file = job.undo ? OpenUndoFile(FlatFilePos{job.pos.nFile, 0}) : OpenBlockFile(FlatFilePos{job.pos.nFile, 0});
+                    file_undo = job.undo;
+                    file_number = job.pos.nFile;
+                }
+                if (!file || !WriteToFile(file, job.pos, job.data)) {
+                    AbortNode(job.undo ? "Failed to write undo data" : "Failed to write block");
+                }
+                written_bytes += job.data.size();
+            }
+            close_file();
+
+            // The data is in the files now, where readers can find it
+            {
+                LOCK(g_pending_writes_mutex);
+                for (const Job& job : jobs) {
+                    if (!job.data.empty()) g_pending_writes.erase(job.pending);
+                }
+            }
+            g_pending_writes_cv.notify_all();
+            {
+                LOCK(m_mutex);
+                m_buffered_bytes -= written_bytes;
+                m_running = false;
+            }
+            m_cv.notify_all();
+        }
+    }
+
+public:
+    explicit BlockFileWriter(size_t max_buffered_bytes)
+        : m_max_buffered_bytes{max_buffered_bytes},
+          m_thread{&util::TraceThread, "blockwriter", [this] { ThreadWrite(); }}
+    {
+    }
+
+    ~BlockFileWriter()
+    {
+        WITH_LOCK(m_mutex, m_stop = true);
+        m_cv.notify_all();
+        m_thread.join();
+    }
+
+    //! Queue data to be written at pos of a blk or rev file.
+    void Write(bool undo, const FlatFilePos& pos, std::vector<unsigned char> data) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        Job job{.undo = undo, .pos = pos, .data = std::move(data)};
+        {
+            LOCK(g_pending_writes_mutex);
+            job.pending = g_pending_writes.insert(g_pending_writes.end(), PendingWrite{undo, pos.nFile, pos.nPos, pos.nPos + (unsigned int)job.data.size()});
+        }
+        Enqueue(std::move(job));
+    }
+
+    //! Queue a flush of a blk or rev file, after the data queued before.
+    void Flush(bool undo, const FlatFilePos& pos, bool finalize) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        Enqueue(Job{.undo = undo, .pos = pos, .finalize = finalize});
+    }
+
+    //! Wait until all queued jobs have run.
+    void Sync() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        while (!m_jobs.empty() || m_running) m_cv.wait(lock);
+    }
+};
+
+BlockManager::BlockManager()
+{
+    const int64_t buffer_mib{gArgs.GetIntArg("-blockwritebuffer", DEFAULT_BLOCK_WRITE_BUFFER)};
+    if (buffer_mib > 0) m_block_file_writer = std::make_unique<BlockFileWriter>(buffer_mib << 20);
+}
+
+BlockManager::~BlockManager()
+{
+    StopBlockFileCompression();
+}
+
+bool BlockManager::WriteToBlockFile(bool undo, const FlatFilePos& pos, std::vector<unsigned char> data)
+{
+    if (m_block_file_writer) {
+        m_block_file_writer->Write(undo, pos, std::move(data));
+        return true;
+    }
+    FILE* file{undo ? OpenUndoFile(pos) : OpenBlockFile(pos)};
+    if (!file) return error("%s: failed to open %s", __func__, pos.ToString());
+    const bool written{WriteToFile(file, pos, data)};
+    return fclose(file) == 0 && written;
+}
+
 std::vector<CBlockIndex*> BlockManager::GetAllBlockIndices()
 {
     AssertLockHeld(cs_main);
@@ -160,8 +368,8 @@ void BlockManager::FindFilesToPruneManual(std::set<int>& setFilesToPrune, int nM
         return;
     }
 
-    // last block to prune is the lesser of (user-specified height, MIN_BLOCKS_TO_KEEP from the tip)
-    unsigned int nLastBlockWeCanPrune = std::min((unsigned)nManualPruneHeight, chain_tip_height - MIN_BLOCKS_TO_KEEP);
+    // last block to prune is the lesser of (user-specified height, -pruneundodepth from the tip)
+    unsigned int nLastBlockWeCanPrune = std::min((unsigned)nManualPruneHeight, (unsigned)(chain_tip_height - g_prune_undo_depth));
     int count = 0;
     for (int fileNumber = 0; fileNumber < m_last_blockfile; fileNumber++) {
         if (m_blockfile_info[fileNumber].nSize == 0 || m_blockfile_info[fileNumber].nHeightLast > nLastBlockWeCanPrune) {
@@ -174,26 +382,28 @@ void BlockManager::FindFilesToPruneManual(std::set<int>& setFilesToPrune, int nM
     LogPrintf("Prune (Manual): prune_height=%d removed %d blk/rev pairs\n", nLastBlockWeCanPrune, count);
 }
 
-void BlockManager::FindFilesToPrune(std::set<int>& setFilesToPrune, uint64_t nPruneAfterHeight, int chain_tip_height, int prune_height, bool is_ibd)
+PrunePlan BlockManager::GetPrunePlan(uint64_t nPruneAfterHeight, int chain_tip_height, int prune_height, bool is_ibd)
 {
-    LOCK2(cs_main, cs_LastBlockFile);
+    LOCK(cs_LastBlockFile);
+    PrunePlan plan;
+    plan.usage_before = plan.usage_after = CalculateCurrentUsage();
     if (chain_tip_height < 0 || nPruneTarget == 0) {
-        return;
+        return plan;
     }
     if ((uint64_t)chain_tip_height <= nPruneAfterHeight) {
-        return;
+        return plan;
     }
 
-    unsigned int nLastBlockWeCanPrune{(unsigned)std::min(prune_height, chain_tip_height - static_cast<int>(MIN_BLOCKS_TO_KEEP))};
-    uint64_t nCurrentUsage = CalculateCurrentUsage();
+    const int last_block_we_can_prune{std::min(prune_height, chain_tip_height - g_prune_undo_depth)};
+    if (last_block_we_can_prune < 0) {
+        return plan;
+    }
     // We don't check to prune until after we've allocated new space for files
     // So we should leave a buffer under our target to account for another allocation
     // before the next pruning.
     uint64_t nBuffer = BLOCKFILE_CHUNK_SIZE + UNDOFILE_CHUNK_SIZE;
-    uint64_t nBytesToPrune;
-    int count = 0;
 
-    if (nCurrentUsage + nBuffer >= nPruneTarget) {
+    if (plan.usage_after + nBuffer >= nPruneTarget) {
         // On a prune event, the chainstate DB is flushed.
         // To avoid excessive prune events negating the benefit of high dbcache
         // values, we should not prune too rapidly.
@@ -204,33 +414,68 @@ void BlockManager::FindFilesToPrune(std::set<int>& setFilesToPrune, uint64_t nPr
         }
 
         for (int fileNumber = 0; fileNumber < m_last_blockfile; fileNumber++) {
-            nBytesToPrune = m_blockfile_info[fileNumber].nSize + m_blockfile_info[fileNumber].nUndoSize;
+            const uint64_t nBytesToPrune = m_blockfile_info[fileNumber].nSize + m_blockfile_info[fileNumber].nUndoSize;
 
             if (m_blockfile_info[fileNumber].nSize == 0) {
                 continue;
             }
 
-            if (nCurrentUsage + nBuffer < nPruneTarget) { // are we below our target?
+            if (plan.usage_after + nBuffer < nPruneTarget) { // are we below our target?
                 break;
             }
 
-            // don't prune files that could have a block within MIN_BLOCKS_TO_KEEP of the main chain's tip but keep scanning
-            if (m_blockfile_info[fileNumber].nHeightLast > nLastBlockWeCanPrune) {
+            // don't prune files that could have a block within -pruneundodepth of the main chain's tip but keep scanning
+            if (m_blockfile_info[fileNumber].nHeightLast > (unsigned)last_block_we_can_prune) {
                 continue;
             }
 
-            PruneOneBlockFile(fileNumber);
-            // Queue up the files for removal
-            setFilesToPrune.insert(fileNumber);
-            nCurrentUsage -= nBytesToPrune;
-            count++;
+            // Leave the rest to the next prune events rather than deleting many files at once
+            if (g_prune_batch > 0 && plan.files.size() >= (size_t)g_prune_batch) {
+                plan.incomplete = true;
+                break;
+            }
+
+            plan.files.push_back(fileNumber);
+            plan.usage_after -= nBytesToPrune;
         }
     }
+    return plan;
+}
+
+bool BlockManager::FindFilesToPrune(std::set<int>& setFilesToPrune, uint64_t nPruneAfterHeight, int chain_tip_height, int prune_height, bool is_ibd)
+{
+    LOCK2(cs_main, cs_LastBlockFile);
+    const PrunePlan plan{GetPrunePlan(nPruneAfterHeight, chain_tip_height, prune_height, is_ibd)};
+    for (const int fileNumber : plan.files) {
+        PruneOneBlockFile(fileNumber);
+        // Queue up the files for removal
+        setFilesToPrune.insert(fileNumber);
+    }
 
-    LogPrint(BCLog::PRUNE, "target=%dMiB actual=%dMiB diff=%dMiB max_prune_height=%d removed %d blk/rev pairs\n",
-           nPruneTarget/1024/1024, nCurrentUsage/1024/1024,
-           ((int64_t)nPruneTarget - (int64_t)nCurrentUsage)/1024/1024,
-           nLastBlockWeCanPrune, count);
+    LogPrint(BCLog::PRUNE, "target=%dMiB actual=%dMiB diff=%dMiB max_prune_height=%d removed %d blk/rev pairs%s\n",
+           nPruneTarget/1024/1024, plan.usage_after/1024/1024,
+           ((int64_t)nPruneTarget - (int64_t)plan.usage_after)/1024/1024,
+           std::min(prune_height, chain_tip_height - g_prune_undo_depth), plan.files.size(),
+           plan.incomplete ? ", more at the next prune event" : "");
+    return !plan.incomplete;
+}
+
+int BlockManager::GetPruneLockHeight(int chain_tip_height, std::optional<std::string>& limiting_lock) const
+{
+    AssertLockHeld(::cs_main);
+    // make sure we don't prune above any of the prune locks bestblocks
+    // pruning is height-based
+    int last_prune{chain_tip_height}; // last height we can prune
+    for (const auto& prune_lock : m_prune_locks) {
+        if (prune_lock.second.height_first == std::numeric_limits<int>::max()) continue;
+        // Remove the buffer and one additional block here to get actual height that is outside of the buffer
+        const int lock_height{prune_lock.second.height_first - PRUNE_LOCK_BUFFER - 1};
+        last_prune = std::max(1, std::min(last_prune, lock_height));
+        if (last_prune == lock_height) {
+            limiting_lock = prune_lock.first;
+        }
+    }
+    return last_prune;
 }
 
 void BlockManager::UpdatePruneLock(const std::string& name, const PruneLockInfo& lock_info) {
@@ -254,16 +499,160 @@ CBlockIndex* BlockManager::InsertBlockIndex(const uint256& hash)
     return pindex;
 }
 
-bool BlockManager::LoadBlockIndex(const Consensus::Params& consensus_params)
+/**
+ * The block index snapshot is a flat file of all block index entries, sorted
+ * by height. It starts with the magic bytes, the version and the number of
+ * entries. Each entry holds the block hash, the distance to the parent's entry
+ * (0 for none) and the fields of CDiskBlockIndex other than the parent hash.
+ * The file ends with the SHA256 of everything before it.
+ */
+static constexpr std::array<uint8_t, 4> BLOCK_INDEX_SNAPSHOT_MAGIC{'b', 'i', 'd', 'x'};
+static constexpr uint16_t BLOCK_INDEX_SNAPSHOT_VERSION{1};
+
+static fs::path GetBlockIndexSnapshotPath()
+{
+    return gArgs.GetDataDirNet() / "blocks" / "blockindex.dat";
+}
+
+static uint256 BlockIndexSnapshotChecksum(Span<const std::byte> data)
 {
-    if (!m_block_tree_db->LoadBlockIndexGuts(consensus_params, [this](const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main) { return this->InsertBlockIndex(hash); })) {
+    uint256 checksum;
+    CSHA256().Write(UCharCast(data.data()), data.size()).Finalize(checksum.begin());
+    return checksum;
+}
+
+bool BlockManager::WriteBlockIndexSnapshot()
+{
+    AssertLockHeld(::cs_main);
+    if (!m_block_index_loaded || !m_block_tree_db) return false;
+    // The snapshot has to match the database, so flush any changes first
+    if (!WriteBlockIndexDB()) return false;
+
+    const auto start{SteadyClock::now()};
+    std::vector<CBlockIndex*> sorted_by_height{GetAllBlockIndices()};
+    std::sort(sorted_by_height.begin(), sorted_by_height.end(), CBlockIndexHeightOnlyComparator());
+    std::unordered_map<const CBlockIndex*, uint64_t> positions;
+    positions.reserve(sorted_by_height.size());
+
+    CDataStream stream{SER_DISK, CLIENT_VERSION};
+    stream.write(MakeByteSpan(BLOCK_INDEX_SNAPSHOT_MAGIC));
+    stream << BLOCK_INDEX_SNAPSHOT_VERSION << uint64_t(sorted_by_height.size());
+    for (const CBlockIndex* pindex : sorted_by_height) {
+        const uint64_t position{positions.size()};
+        const uint64_t parent_distance{pindex->pprev ? position - positions.at(pindex->pprev) : 0};
+        stream << pindex->GetBlockHash() << VARINT(parent_distance);
+        stream << VARINT_MODE(pindex->nHeight, VarIntMode::NONNEGATIVE_SIGNED) << VARINT(pindex->nStatus) << VARINT(pindex->nTx);
+        stream << VARINT_MODE(pindex->nFile, VarIntMode::NONNEGATIVE_SIGNED) << VARINT(pindex->nDataPos) << VARINT(pindex->nUndoPos);
+        stream << pindex->nVersion << pindex->hashMerkleRoot << pindex->nTime << pindex->nBits << pindex->nNonce;
+        positions.emplace(pindex, position);
+    }
+    const uint256 checksum{BlockIndexSnapshotChecksum(stream)};
+    stream << checksum;
+
+    // Write to a temporary file and only record the checksum in the database
+    // once the snapshot is complete on disk
+    const fs::path path{GetBlockIndexSnapshotPath()};
+    const fs::path temp_path{path + ".new"};
+    FILE* file{fsbridge::fopen(temp_path, "wb")};
+    if (!file) return error("%s: failed to open %s", __func__, fs::PathToString(temp_path));
+    const bool written{fwrite(stream.data(), 1, stream.size(), file) == stream.size() && FileCommit(file)};
+    if (fclose(file) != 0 || !written) {
+        fs::remove(temp_path);
+        return error("%s: failed to write %s", __func__, fs::PathToString(temp_path));
+    }
+    if (!RenameOver(temp_path, path)) return error("%s: failed to rename %s", __func__, fs::PathToString(temp_path));
+    if (!m_block_tree_db->WriteBlockIndexSnapshotChecksum(checksum)) return false;
+
+    LogPrintf("Wrote block index snapshot of %u entries (%u bytes) in %dms\n",
+              sorted_by_height.size(), stream.size(), Ticks<std::chrono::milliseconds>(SteadyClock::now() - start));
+    return true;
+}
+
+bool BlockManager::LoadBlockIndexSnapshot(std::vector<CBlockIndex*>& sorted_by_height)
+{
+    AssertLockHeld(::cs_main);
+    // The checksum is only present while the database has not changed since
+    // the snapshot was written
+    uint256 expected_checksum;
+    if (!m_block_tree_db->ReadBlockIndexSnapshotChecksum(expected_checksum)) return false;
+
+    const auto start{SteadyClock::now()};
+    const fs::path path{GetBlockIndexSnapshotPath()};
+    CDataStream stream{SER_DISK, CLIENT_VERSION};
+    try {
+        std::error_code ec;
+        const uintmax_t size{fs::file_size(path, ec)};
+        AutoFile file{fsbridge::fopen(path, "rb")};
+        if (ec || file.IsNull()) {
+            LogPrintf("Block index snapshot %s is missing, loading the block index from the database\n", fs::PathToString(path));
+            return false;
+        }
+        stream.resize(size);
+        file.read(MakeWritableByteSpan(stream));
+    } catch (const std::ios_base::failure& e) {
+        LogPrintf("Failed to read block index snapshot: %s\n", e.what());
+        return false;
+    }
+    if (stream.size() < sizeof(uint256) ||
+        BlockIndexSnapshotChecksum(Span{stream}.first(stream.size() - sizeof(uint256))) != expected_checksum ||
+        !std::equal(expected_checksum.begin(), expected_checksum.end(), MakeUCharSpan(stream).last(sizeof(uint256)).begin())) {
+        LogPrintf("Block index snapshot %s does not match the database, loading the block index from the database\n", fs::PathToString(path));
         return false;
     }
 
+    try {
+        std::array<uint8_t, 4> magic;
+        uint16_t version;
+        uint64_t count;
+        stream.read(MakeWritableByteSpan(magic));
+        stream >> version >> count;
+        if (magic != BLOCK_INDEX_SNAPSHOT_MAGIC || version != BLOCK_INDEX_SNAPSHOT_VERSION) {
+            throw std::ios_base::failure("unknown format");
+        }
+        m_block_index.reserve(count);
+        sorted_by_height.reserve(count);
+        for (uint64_t position = 0; position < count; ++position) {
+            uint256 hash;
+            uint64_t parent_distance;
+            stream >> hash >> VARINT(parent_distance);
+            if (parent_distance > position) throw std::ios_base::failure("invalid parent");
+            CBlockIndex* pindex{InsertBlockIndex(hash)};
+            pindex->pprev = parent_distance ? sorted_by_height[position - parent_distance] : nullptr;
+            stream >> VARINT_MODE(pindex->nHeight, VarIntMode::NONNEGATIVE_SIGNED) >> VARINT(pindex->nStatus) >> VARINT(pindex->nTx);
+            stream >> VARINT_MODE(pindex->nFile, VarIntMode::NONNEGATIVE_SIGNED) >> VARINT(pindex->nDataPos) >> VARINT(pindex->nUndoPos);
+            stream >> pindex->nVersion >> pindex->hashMerkleRoot >> pindex->nTime >> pindex->nBits >> pindex->nNonce;
+            sorted_by_height.push_back(pindex);
+        }
+        if (stream.size() != sizeof(uint256) || m_block_index.size() != count) {
+            throw std::ios_base::failure("inconsistent size");
+        }
+    } catch (const std::ios_base::failure& e) {
+        LogPrintf("Failed to load block index snapshot: %s\n", e.what());
+        sorted_by_height.clear();
+        m_block_index.clear();
+        return false;
+    }
+
+    LogPrintf("Loaded block index snapshot of %u entries in %dms\n",
+              sorted_by_height.size(), Ticks<std::chrono::milliseconds>(SteadyClock::now() - start));
+    return true;
+}
+
+bool BlockManager::LoadBlockIndex(const Consensus::Params& consensus_params)
+{
+    // The snapshot is sorted by height and its headers were checked when they
+    // were first added, which saves checking proof of work and sorting here
+    std::vector<CBlockIndex*> vSortedByHeight;
+    if (!LoadBlockIndexSnapshot(vSortedByHeight)) {
+        if (!m_block_tree_db->LoadBlockIndexGuts(consensus_params, [this](const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main) { return this->InsertBlockIndex(hash); })) {
+            return false;
+        }
+        vSortedByHeight = GetAllBlockIndices();
+        std::sort(vSortedByHeight.begin(), vSortedByHeight.end(),
+                  CBlockIndexHeightOnlyComparator());
+    }
+
     // Calculate nChainWork
-    std::vector<CBlockIndex*> vSortedByHeight{GetAllBlockIndices()};
-    std::sort(vSortedByHeight.begin(), vSortedByHeight.end(),
-              CBlockIndexHeightOnlyComparator());
 
     for (CBlockIndex* pindex : vSortedByHeight) {
         if (ShutdownRequested()) return false;
@@ -451,39 +840,29 @@ CBlockFileInfo* BlockManager::GetBlockFileInfo(size_t n)
     return &m_blockfile_info.at(n);
 }
 
-static bool UndoWriteToDisk(const CBlockUndo& blockundo, FlatFilePos& pos, const uint256& hashBlock, const CMessageHeader::MessageStartChars& messageStart)
+//! Serialize undo data as stored in rev files: after the network magic and
+//! its size, followed by a checksum that also commits to the block hash.
+static std::vector<unsigned char> SerializeUndo(const CBlockUndo& blockundo, const uint256& hashBlock, const CMessageHeader::MessageStartChars& messageStart)
 {
-    // Open history file to append
-    CAutoFile fileout(OpenUndoFile(pos), SER_DISK, CLIENT_VERSION);
-    if (fileout.IsNull()) {
-        return error("%s: OpenUndoFile failed", __func__);
-    }
-
-    // Write index header
-    unsigned int nSize = GetSerializeSize(blockundo, fileout.GetVersion());
-    fileout << messageStart << nSize;
-
-    // Write undo data
-    long fileOutPos = ftell(fileout.Get());
-    if (fileOutPos < 0) {
-        return error("%s: ftell failed", __func__);
-    }
-    pos.nPos = (unsigned int)fileOutPos;
-    fileout << blockundo;
+    std::vector<unsigned char> data;
+    CVectorWriter writer{SER_DISK, CLIENT_VERSION, data, 0};
+    writer << messageStart << (unsigned int)GetSerializeSize(blockundo, CLIENT_VERSION) << blockundo;
 
-    // calculate & write checksum
     HashWriter hasher{};
     hasher << hashBlock;
     hasher << blockundo;
-    fileout << hasher.GetHash();
-
-    return true;
+    writer << hasher.GetHash();
+    return data;
 }
 
 bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex* pindex)
 {
     const FlatFilePos pos{WITH_LOCK(::cs_main, return pindex->GetUndoPos())};
+    return UndoReadFromDisk(blockundo, pos, pindex->pprev->GetBlockHash());
+}
 
+bool UndoReadFromDisk(CBlockUndo& blockundo, const FlatFilePos& pos, const uint256& prev_hash)
+{
     if (pos.IsNull()) {
         return error("%s: no undo data available", __func__);
     }
@@ -498,7 +877,7 @@ bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex* pindex)
     uint256 hashChecksum;
     CHashVerifier<CAutoFile> verifier(&filein); // We need a CHashVerifier as reserializing may lose data
     try {
-        verifier << pindex->pprev->GetBlockHash();
+        verifier << prev_hash;
         verifier >> blockundo;
         filein >> hashChecksum;
     } catch (const std::exception& e) {
@@ -513,9 +892,68 @@ bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex* pindex)
     return true;
 }
 
+BlockPrefetcher::BlockPrefetcher(std::vector<FlatFilePos> positions, int threads, const Consensus::Params& consensus_params, CheckFn check)
+    : m_positions{std::move(positions)},
+      m_read_ahead{static_cast<size_t>(std::max(threads, 1)) * 4},
+      m_consensus_params{consensus_params},
+      m_check{std::move(check)}
+{
+    for (int n = 0; n < std::max(threads, 1); ++n) {
+        m_threads.emplace_back(&util::TraceThread, strprintf("blkread.%i", n), [this] { ThreadRead(); });
+    }
+}
+
+BlockPrefetcher::~BlockPrefetcher()
+{
+    WITH_LOCK(m_mutex, m_stop = true);
+    m_cv.notify_all();
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void BlockPrefetcher::ThreadRead()
+{
+    while (true) {
+        size_t index;
+        {
+            WAIT_LOCK(m_mutex, lock);
+            while (!m_stop && m_next_read < m_positions.size() && m_next_read >= m_next_taken + m_read_ahead) m_cv.wait(lock);
+            if (m_stop || m_next_read == m_positions.size()) return;
+            index = m_next_read++;
+        }
+        auto block{std::make_shared<CBlock>()};
+        if (ReadBlockFromDisk(*block, m_positions[index], m_consensus_params)) {
+            if (m_check) m_check(index, *block);
+        } else {
+            block.reset();
+        }
+        WITH_LOCK(m_mutex, m_blocks.emplace(index, std::move(block)));
+        m_cv.notify_all();
+    }
+}
+
+std::shared_ptr<const CBlock> BlockPrefetcher::Next()
+{
+    std::shared_ptr<const CBlock> block;
+    {
+        WAIT_LOCK(m_mutex, lock);
+        assert(m_next_taken < m_positions.size());
+        while (m_blocks.count(m_next_taken) == 0) m_cv.wait(lock);
+        block = std::move(m_blocks.extract(m_next_taken++).mapped());
+    }
+    m_cv.notify_all();
+    return block;
+}
+
 void BlockManager::FlushUndoFile(int block_file, bool finalize)
 {
     FlatFilePos undo_pos_old(block_file, m_blockfile_info[block_file].nUndoSize);
+    if (m_block_file_writer) {
+        // Finalize after the queued writes, without waiting for it
+        m_block_file_writer->Flush(/*undo=*/true, undo_pos_old, finalize);
+        return;
+    }
     if (!UndoFileSeq().Flush(undo_pos_old, finalize)) {
         AbortNode("Flushing undo file to disk failed. This is likely the result of an I/O error.");
     }
@@ -525,12 +963,18 @@ void BlockManager::FlushBlockFile(bool fFinalize, bool finalize_undo)
 {
     LOCK(cs_LastBlockFile);
     FlatFilePos block_pos_old(m_last_blockfile, m_blockfile_info[m_last_blockfile].nSize);
-    if (!BlockFileSeq().Flush(block_pos_old, fFinalize)) {
+    if (m_block_file_writer) {
+        m_block_file_writer->Flush(/*undo=*/false, block_pos_old, fFinalize);
+    } else if (!BlockFileSeq().Flush(block_pos_old, fFinalize)) {
         AbortNode("Flushing block file to disk failed. This is likely the result of an I/O error.");
     }
     // we do not always flush the undo file, as the chain tip may be lagging behind the incoming blocks,
     // e.g. during IBD or a sync after a node going offline
     if (!fFinalize || finalize_undo) FlushUndoFile(m_last_blockfile, finalize_undo);
+    // Finalizing a file when moving on to the next one can happen in the
+    // background, but otherwise this is a durability barrier: everything
+    // queued so far must be on disk before the block index refers to it.
+    if (m_block_file_writer && !fFinalize) m_block_file_writer->Sync();
 }
 
 uint64_t BlockManager::CalculateCurrentUsage()
@@ -544,12 +988,284 @@ uint64_t BlockManager::CalculateCurrentUsage()
     return retval;
 }
 
+/**
+ * A compressed block file holds the blocks of a blk?????.dat file at their
+ * original positions, so that the block index doesn't change when the file is
+ * compressed. It starts with the magic bytes, the version and the offset of
+ * the index. One frame per block follows: the block's record (network magic,
+ * size and block) compressed with LZCompress(), or stored as is if that
+ * doesn't make it smaller. The index at the end holds the number of frames
+ * and, for each frame in order of position, the distance from the end of the
+ * previous record, the size of the record and the size of the frame.
+ */
+static constexpr std::array<uint8_t, 4> COMPRESSED_BLOCK_FILE_MAGIC{'b', 'l', 'k', 'z'};
+static constexpr uint8_t COMPRESSED_BLOCK_FILE_VERSION{1};
+static constexpr uint32_t COMPRESSED_BLOCK_FILE_HEADER_SIZE{4 + 1 + 4};
+
+struct CompressedBlockFrame {
+    //! Position and size of the block's record in the uncompressed file
+    uint32_t pos;
+    uint32_t size;
+    //! Position and size of the frame in the compressed file
+    uint32_t offset;
+    uint32_t frame_size;
+};
+
+struct CompressedBlockFileIndex {
+    uint32_t index_offset;
+    //! Sorted by position
+    std::vector<CompressedBlockFrame> frames;
+};
+
+//! Indexes of recently read compressed block files, by file number
+static GlobalMutex g_compressed_block_files_mutex;
+static std::map<int, std::shared_ptr<const CompressedBlockFileIndex>> g_compressed_block_files GUARDED_BY(g_compressed_block_files_mutex);
+static constexpr size_t MAX_CACHED_COMPRESSED_BLOCK_FILES{256};
+
+static bool ReadFromFile(FILE* file, uint32_t offset, Span<uint8_t> data)
+{
+    return fseek(file, offset, SEEK_SET) == 0 && fread(data.data(), 1, data.size(), file) == data.size();
+}
+
+bool IsCompressedBlockFile(FILE* file, const FlatFilePos& pos)
+{
+    std::array<uint8_t, COMPRESSED_BLOCK_FILE_MAGIC.size()> magic;
+    const bool compressed{ReadFromFile(file, 0, magic) && magic == COMPRESSED_BLOCK_FILE_MAGIC};
+    fseek(file, pos.nPos, SEEK_SET);
+    return compressed;
+}
+
+static std::shared_ptr<const CompressedBlockFileIndex> ReadCompressedBlockFileIndex(FILE* file, int file_number)
+{
+    std::array<uint8_t, COMPRESSED_BLOCK_FILE_HEADER_SIZE> header;
+    if (!ReadFromFile(file, 0, header)) return nullptr;
+    if (header[4] != COMPRESSED_BLOCK_FILE_VERSION) {
+        LogPrintf("%s: unsupported version %u of compressed block file %d\n", __func__, header[4], file_number);
+        return nullptr;
+    }
+    const uint32_t index_offset{ReadLE32(header.data() + 5)};
+    {
+        LOCK(g_compressed_block_files_mutex);
+        const auto it{g_compressed_block_files.find(file_number)};
+        if (it != g_compressed_block_files.end() && it->second->index_offset == index_offset) return it->second;
+    }
+
+    if (fseek(file, 0, SEEK_END) != 0) return nullptr;
+    const long file_size{ftell(file)};
+    if (file_size < 0 || static_cast<uint64_t>(file_size) < index_offset || index_offset < COMPRESSED_BLOCK_FILE_HEADER_SIZE) return nullptr;
+    std::vector<uint8_t> data(file_size - index_offset);
+    if (!ReadFromFile(file, index_offset, data)) return nullptr;
+
+    auto index{std::make_shared<CompressedBlockFileIndex>()};
+    index->index_offset = index_offset;
+    try {
+        SpanReader reader{SER_DISK, CLIENT_VERSION, data};
+        const uint64_t count{ReadCompactSize(reader)};
+        index->frames.reserve(std::min<uint64_t>(count, data.size() / 3));
+        uint64_t record_end{0};
+        uint32_t offset{COMPRESSED_BLOCK_FILE_HEADER_SIZE};
+        for (uint64_t i = 0; i < count; ++i) {
+            uint32_t distance, size, frame_size;
+            reader >> VARINT(distance) >> VARINT(size) >> VARINT(frame_size);
+            if (size < 8 || frame_size > size || record_end + distance + size > std::numeric_limits<uint32_t>::max() || frame_size > index_offset - offset) {
+                throw std::ios_base::failure("invalid frame");
+            }
+            index->frames.push_back({static_cast<uint32_t>(record_end + distance), size, offset, frame_size});
+            record_end += distance + size;
+            offset += frame_size;
+        }
+        if (!reader.empty()) throw std::ios_base::failure("trailing data");
+    } catch (const std::exception& e) {
+        LogPrintf("%s: invalid index of compressed block file %d: %s\n", __func__, file_number, e.what());
+        return nullptr;
+    }
+
+    LOCK(g_compressed_block_files_mutex);
+    if (g_compressed_block_files.size() >= MAX_CACHED_COMPRESSED_BLOCK_FILES) {
+        // Older files are less likely to be read again
+        g_compressed_block_files.erase(g_compressed_block_files.begin());
+    }
+    g_compressed_block_files.insert_or_assign(file_number, index);
+    return index;
+}
+
+bool ReadCompressedBlockRecord(FILE* file, const FlatFilePos& pos, std::vector<uint8_t>& record)
+{
+    if (pos.nPos < 8) return error("%s: no block at %s", __func__, pos.ToString());
+    const auto index{ReadCompressedBlockFileIndex(file, pos.nFile)};
+    if (!index) return error("%s: failed to read the index of compressed block file %d", __func__, pos.nFile);
+    const uint32_t record_pos{pos.nPos - 8};
+    const auto frame{std::lower_bound(index->frames.begin(), index->frames.end(), record_pos,
+                                      [](const CompressedBlockFrame& frame, uint32_t p) { return frame.pos < p; })};
+    if (frame == index->frames.end() || frame->pos != record_pos) {
+        return error("%s: no block at %s in compressed block file", __func__, pos.ToString());
+    }
+
+    std::vector<uint8_t> data(frame->frame_size);
+    if (!ReadFromFile(file, frame->offset, data)) return error("%s: failed to read %s", __func__, pos.ToString());
+    if (frame->frame_size == frame->size) {
+        record = std::move(data);
+    } else {
+        record.resize(frame->size);
+        if (!LZDecompress(data, record)) return error("%s: failed to decompress %s", __func__, pos.ToString());
+    }
+    return true;
+}
+
+//! Write the blocks of a compressed block file to a temporary file at their
+//! original positions, to be reindexed like any other block file.
+static FILE* ExpandCompressedBlockFile(FILE* file, int file_number)
+{
+    const auto index{ReadCompressedBlockFileIndex(file, file_number)};
+    if (!index) return nullptr;
+    FILE* expanded{tmpfile()};
+    if (!expanded) return nullptr;
+    std::vector<uint8_t> record;
+    for (const CompressedBlockFrame& frame : index->frames) {
+        if (!ReadCompressedBlockRecord(file, FlatFilePos{file_number, frame.pos + 8}, record) ||
+            !WriteToFile(expanded, FlatFilePos{file_number, frame.pos}, record)) {
+            fclose(expanded);
+            return nullptr;
+        }
+    }
+    rewind(expanded);
+    return expanded;
+}
+
+bool BlockManager::CompressBlockFile(int file_number)
+{
+    const FlatFilePos file_pos{file_number, 0};
+    {
+        LOCK(cs_LastBlockFile);
+        if (file_number >= m_last_blockfile) return error("%s: blocks are still being added to block file %d", __func__, file_number);
+        if (m_blockfile_info[file_number].nSize == 0) return false;
+    }
+    // Wait for the writes and the final flush of the file
+    if (m_block_file_writer) m_block_file_writer->Sync();
+
+    CAutoFile in{OpenBlockFile(file_pos, true), SER_DISK, CLIENT_VERSION};
+    if (in.IsNull()) return false;
+    if (IsCompressedBlockFile(in.Get(), file_pos)) return true;
+
+    const auto start{SteadyClock::now()};
+    std::vector<uint32_t> positions;
+    {
+        LOCK(::cs_main);
+        for (const auto& [_, block_index] : m_block_index) {
+            if ((block_index.nStatus & BLOCK_HAVE_DATA) && block_index.nFile == file_number) positions.push_back(block_index.nDataPos);
+        }
+    }
+    std::sort(positions.begin(), positions.end());
+
+    const fs::path path{GetBlockPosFilename(file_pos)};
+    const fs::path temp_path{path + ".new"};
+    FILE* out{fsbridge::fopen(temp_path, "wb")};
+    if (!out) return error("%s: failed to open %s", __func__, fs::PathToString(temp_path));
+    const auto fail{[&](const std::string& message) {
+        fclose(out);
+        fs::remove(temp_path);
+        return error("%s: %s compressing block file %d", __func__, message, file_number);
+    }};
+
+    std::array<uint8_t, COMPRESSED_BLOCK_FILE_HEADER_SIZE> header{};
+    std::copy(COMPRESSED_BLOCK_FILE_MAGIC.begin(), COMPRESSED_BLOCK_FILE_MAGIC.end(), header.begin());
+    header[4] = COMPRESSED_BLOCK_FILE_VERSION;
+    if (fwrite(header.data(), 1, header.size(), out) != header.size()) return fail("failed to write");
+
+    CDataStream index{SER_DISK, CLIENT_VERSION};
+    WriteCompactSize(index, positions.size());
+    uint64_t record_end{0};
+    uint64_t offset{header.size()};
+    std::vector<uint8_t> record;
+    for (const uint32_t pos : positions) {
+        if (m_interrupt_block_file_compression) return fail("interrupted");
+        std::array<uint8_t, 8> record_header;
+        if (pos < record_header.size() || pos - record_header.size() < record_end) return fail(strprintf("invalid block position %u", pos));
+        if (!ReadFromFile(in.Get(), pos - record_header.size(), record_header)) return fail("failed to read");
+        const uint32_t size{ReadLE32(record_header.data() + 4)};
+        if (size > MAX_SIZE) return fail(strprintf("invalid block size %u", size));
+        record.resize(record_header.size() + size);
+        std::copy(record_header.begin(), record_header.end(), record.begin());
+        if (fread(record.data() + record_header.size(), 1, size, in.Get()) != size) return fail("failed to read");
+
+        const std::vector<uint8_t> compressed{LZCompress(record)};
+        const Span<const uint8_t> frame{compressed.size() < record.size() ? Span{compressed} : Span{record}};
+        if (fwrite(frame.data(), 1, frame.size(), out) != frame.size()) return fail("failed to write");
+        index << VARINT(uint32_t(pos - record_header.size() - record_end)) << VARINT(uint32_t(record.size())) << VARINT(uint32_t(frame.size()));
+        record_end = pos + size;
+        offset += frame.size();
+    }
+    if (offset + index.size() > std::numeric_limits<uint32_t>::max()) return fail("too much data");
+    WriteLE32(header.data() + 5, offset);
+    if (fwrite(index.data(), 1, index.size(), out) != index.size() ||
+        fseek(out, 0, SEEK_SET) != 0 || fwrite(header.data(), 1, header.size(), out) != header.size() ||
+        !FileCommit(out)) {
+        return fail("failed to write");
+    }
+    if (fclose(out) != 0) {
+        fs::remove(temp_path);
+        return error("%s: failed to write %s", __func__, fs::PathToString(temp_path));
+    }
+    const long original_size{fseek(in.Get(), 0, SEEK_END) == 0 ? ftell(in.Get()) : -1};
+    in.fclose();
+
+    {
+        // Don't bring back a file that was pruned in the meantime
+        LOCK(::cs_main);
+        if (WITH_LOCK(cs_LastBlockFile, return m_blockfile_info[file_number].nSize) == 0) {
+            fs::remove(temp_path);
+            return false;
+        }
+        if (!RenameOver(temp_path, path)) {
+            fs::remove(temp_path);
+            return error("%s: failed to rename %s", __func__, fs::PathToString(temp_path));
+        }
+    }
+    DirectoryCommit(gArgs.GetBlocksDirPath());
+
+    LogPrintf("Compressed block file %s with %u blocks from %d to %u bytes in %dms\n",
+              fs::PathToString(path.filename()), positions.size(), original_size, offset + index.size(),
+              Ticks<std::chrono::milliseconds>(SteadyClock::now() - start));
+    return true;
+}
+
+//! How often block file compression looks for newly completed block files
+static constexpr auto BLOCK_FILE_COMPRESSION_INTERVAL{1min};
+
+void BlockManager::ThreadCompressBlockFiles()
+{
+    ScheduleBatchPriority();
+    int file_number{0};
+    while (!m_interrupt_block_file_compression) {
+        // Reindexing adds the blocks of a file to the block index only when
+        // it gets to the file, so until then the blocks would be dropped
+        if (fReindex || file_number >= WITH_LOCK(cs_LastBlockFile, return m_last_blockfile)) {
+            if (!m_interrupt_block_file_compression.sleep_for(BLOCK_FILE_COMPRESSION_INTERVAL)) break;
+            continue;
+        }
+        CompressBlockFile(file_number++);
+    }
+}
+
+void BlockManager::StartBlockFileCompression()
+{
+    assert(!m_block_file_compression.joinable());
+    m_block_file_compression = std::thread(&util::TraceThread, "blockcompress", [this] { ThreadCompressBlockFiles(); });
+}
+
+void BlockManager::StopBlockFileCompression()
+{
+    m_interrupt_block_file_compression();
+    if (m_block_file_compression.joinable()) m_block_file_compression.join();
+}
+
 void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune)
 {
     for (std::set<int>::iterator it = setFilesToPrune.begin(); it != setFilesToPrune.end(); ++it) {
         FlatFilePos pos(*it, 0);
         fs::remove(BlockFileSeq().FileName(pos));
         fs::remove(UndoFileSeq().FileName(pos));
+        WITH_LOCK(g_compressed_block_files_mutex, g_compressed_block_files.erase(*it));
         LogPrint(BCLog::BLOCKSTORE, "Prune: %s deleted blk/rev (%05u)\n", __func__, *it);
     }
 }
@@ -566,12 +1282,14 @@ static FlatFileSeq UndoFileSeq()
 
 FILE* OpenBlockFile(const FlatFilePos& pos, bool fReadOnly)
 {
+    if (fReadOnly) WaitForPendingWrites(/*undo=*/false, pos);
     return BlockFileSeq().Open(pos, fReadOnly);
 }
 
 /** Open an undo file (rev?????.dat) */
 static FILE* OpenUndoFile(const FlatFilePos& pos, bool fReadOnly)
 {
+    if (fReadOnly) WaitForPendingWrites(/*undo=*/true, pos);
     return UndoFileSeq().Open(pos, fReadOnly);
 }
 
@@ -591,7 +1309,13 @@ bool BlockManager::FindBlockPos(FlatFilePos& pos, unsigned int nAddSize, unsigne
 
     bool finalize_undo = false;
     if (!fKnown) {
-        while (m_blockfile_info[nFile].nSize + nAddSize >= (gArgs.GetBoolArg("-fastprune", false) ? 0x10000 /* 64kb */ : MAX_BLOCKFILE_SIZE)) {
+        unsigned int max_blockfile_size{MAX_BLOCKFILE_SIZE};
+        // Use smaller blockfiles in test-only -fastprune mode, but never too
+        // small for the block, which would never fit in a file otherwise
+        if (gArgs.GetBoolArg("-fastprune", false)) {
+            max_blockfile_size = std::max<unsigned int>(0x10000 /* 64kb */, nAddSize + 1);
+        }
+        while (m_blockfile_info[nFile].nSize + nAddSize >= max_blockfile_size) {
             // when the undo file is keeping up with the block file, we want to flush it explicitly
             // when it is lagging behind (more blocks arrive than are being connected), we let the
             // undo block write case handle it
@@ -657,27 +1381,13 @@ bool BlockManager::FindUndoPos(BlockValidationState& state, int nFile, FlatFileP
     return true;
 }
 
-static bool WriteBlockToDisk(const CBlock& block, FlatFilePos& pos, const CMessageHeader::MessageStartChars& messageStart)
+//! Serialize a block as stored in blk files, after the network magic and its size.
+static std::vector<unsigned char> SerializeBlock(const CBlock& block, unsigned int size, const CMessageHeader::MessageStartChars& messageStart)
 {
-    // Open history file to append
-    CAutoFile fileout(OpenBlockFile(pos), SER_DISK, CLIENT_VERSION);
-    if (fileout.IsNull()) {
-        return error("WriteBlockToDisk: OpenBlockFile failed");
-    }
-
-    // Write index header
-    unsigned int nSize = GetSerializeSize(block, fileout.GetVersion());
-    fileout << messageStart << nSize;
-
-    // Write block
-    long fileOutPos = ftell(fileout.Get());
-    if (fileOutPos < 0) {
-        return error("WriteBlockToDisk: ftell failed");
-    }
-    pos.nPos = (unsigned int)fileOutPos;
-    fileout << block;
-
-    return true;
+    std::vector<unsigned char> data;
+    data.reserve(size + 8);
+    CVectorWriter{SER_DISK, CLIENT_VERSION, data, 0} << messageStart << size << block;
+    return data;
 }
 
 bool BlockManager::WriteUndoDataForBlock(const CBlockUndo& blockundo, BlockValidationState& state, CBlockIndex* pindex, const CChainParams& chainparams)
@@ -689,9 +1399,11 @@ bool BlockManager::WriteUndoDataForBlock(const CBlockUndo& blockundo, BlockValid
         if (!FindUndoPos(state, pindex->nFile, _pos, ::GetSerializeSize(blockundo, CLIENT_VERSION) + 40)) {
             return error("ConnectBlock(): FindUndoPos failed");
         }
-        if (!UndoWriteToDisk(blockundo, _pos, pindex->pprev->GetBlockHash(), chainparams.MessageStart())) {
+        if (!WriteToBlockFile(/*undo=*/true, _pos, SerializeUndo(blockundo, pindex->pprev->GetBlockHash(), chainparams.MessageStart()))) {
             return AbortNode(state, "Failed to write undo data");
         }
+        // The undo data follows its header
+        _pos.nPos += 8;
         // rev files are written in block height order, whereas blk files are written as blocks come in (often out of order)
         // we want to flush the rev (undo) file once we've written the last block, which is indicated by the last height
         // in the block file info as below; note that this does not catch the case where the undo writes are keeping up
@@ -722,7 +1434,13 @@ bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos, const Consensus::P
 
     // Read block
     try {
-        filein >> block;
+        if (IsCompressedBlockFile(filein.Get(), pos)) {
+            std::vector<uint8_t> record;
+            if (!ReadCompressedBlockRecord(filein.Get(), pos, record)) return false;
+            SpanReader{SER_DISK, CLIENT_VERSION, Span{record}.subspan(8)} >> block;
+        } else {
+            filein >> block;
+        }
     } catch (const std::exception& e) {
         return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), pos.ToString());
     }
@@ -767,6 +1485,16 @@ bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const FlatFilePos& pos, c
         CMessageHeader::MessageStartChars blk_start;
         unsigned int blk_size;
 
+        if (IsCompressedBlockFile(filein.Get(), hpos)) {
+            if (!ReadCompressedBlockRecord(filein.Get(), pos, block)) return false;
+            SpanReader{SER_DISK, CLIENT_VERSION, block} >> blk_start >> blk_size;
+            if (memcmp(blk_start, message_start, CMessageHeader::MESSAGE_START_SIZE) || blk_size != block.size() - 8) {
+                return error("%s: Invalid block record for %s", __func__, pos.ToString());
+            }
+            block.erase(block.begin(), block.begin() + 8);
+            return true;
+        }
+
         filein >> blk_start >> blk_size;
 
         if (memcmp(blk_start, message_start, CMessageHeader::MESSAGE_START_SIZE)) {
@@ -802,14 +1530,146 @@ FlatFilePos BlockManager::SaveBlockToDisk(const CBlock& block, int nHeight, CCha
         return FlatFilePos();
     }
     if (dbp == nullptr) {
-        if (!WriteBlockToDisk(block, blockPos, chainparams.MessageStart())) {
+        if (!WriteToBlockFile(/*undo=*/false, blockPos, SerializeBlock(block, nBlockSize, chainparams.MessageStart()))) {
             AbortNode("Failed to write block");
             return FlatFilePos();
         }
+        // The block follows its header
+        blockPos.nPos += 8;
     }
     return blockPos;
 }
 
+std::optional<std::vector<BlockFileEntry>> ScanBlockFile(int file_number, const CChainParams& params)
+{
+    const FlatFilePos file_pos{file_number, 0};
+    FILE* file{OpenBlockFile(file_pos, true)};
+    if (!file) return std::nullopt; // This error is logged in OpenBlockFile
+    if (IsCompressedBlockFile(file, file_pos)) {
+        FILE* expanded{ExpandCompressedBlockFile(file, file_number)};
+        fclose(file);
+        if (!expanded) {
+            LogPrintf("Failed to read compressed block file blk%05u.dat\n", (unsigned int)file_number);
+            return std::nullopt;
+        }
+        file = expanded;
+    }
+
+    std::vector<BlockFileEntry> entries;
+    try {
+        // Only the headers are read, so the buffer doesn't have to hold a whole block.
+        // This takes over file and calls fclose() on it in the CBufferedFile destructor.
+        CBufferedFile blkdat(file, 1 << 20, 1 << 16, SER_DISK, CLIENT_VERSION);
+        uint64_t rewind_pos{blkdat.GetPos()};
+        while (!blkdat.eof()) {
+            if (ShutdownRequested()) break;
+            blkdat.SetPos(rewind_pos);
+            rewind_pos++; // start one byte further next time, in case of failure
+            CMessageHeader::MessageStartChars buf;
+            unsigned int size{0};
+            CBlockHeader header;
+            try {
+                blkdat.FindByte(params.MessageStart()[0]);
+                rewind_pos = blkdat.GetPos() + 1;
+                blkdat >> buf;
+                if (memcmp(buf, params.MessageStart(), CMessageHeader::MESSAGE_START_SIZE)) continue;
+                blkdat >> size;
+                if (size < 80 || size > MAX_BLOCK_SERIALIZED_SIZE) continue;
+                const uint64_t block_pos{blkdat.GetPos()};
+                blkdat >> header;
+                const uint256 hash{header.GetHash()};
+                if (!CheckProofOfWork(hash, header.nBits, params.GetConsensus())) continue;
+                blkdat.SkipTo(block_pos + size);
+                rewind_pos = blkdat.GetPos();
+                entries.push_back({hash, header.hashPrevBlock, FlatFilePos{file_number, static_cast<unsigned int>(block_pos)}});
+            } catch (const std::exception&) {
+                // no complete block found; don't complain
+                break;
+            }
+        }
+    } catch (const std::exception& e) {
+        LogPrintf("%s: Deserialize or I/O error - %s\n", __func__, e.what());
+        return std::nullopt;
+    }
+    return entries;
+}
+
+//! Rebuild the block index from the block files with a number of threads, see
+//! -reindexthreads. The files are scanned in parallel for the positions of
+//! their blocks, which are then accepted and connected parent first while the
+//! blocks after them are read ahead. Returns false if a shutdown was requested.
+static bool ReindexBlockFilesInParallel(ChainstateManager& chainman, int threads)
+{
+    const CChainParams& params{chainman.GetParams()};
+    int num_files{0};
+    while (fs::exists(GetBlockPosFilename(FlatFilePos{num_files, 0}))) {
+        ++num_files;
+    }
+
+    std::vector<std::optional<std::vector<BlockFileEntry>>> files(num_files);
+    std::atomic<int> next_file{0};
+    std::vector<std::thread> scanners;
+    for (int n = 0; n < std::min(threads, num_files); ++n) {
+        scanners.emplace_back(&util::TraceThread, strprintf("blkscan.%i", n), [&] {
+            for (int file_number; (file_number = next_file++) < num_files && !ShutdownRequested();) {
+                LogPrintf("Scanning block file blk%05u.dat...\n", (unsigned int)file_number);
+                files[file_number] = ScanBlockFile(file_number, params);
+            }
+        });
+    }
+    for (std::thread& scanner : scanners) {
+        scanner.join();
+    }
+    if (ShutdownRequested()) return false;
+
+    // Like a sequential reindex, stop at the first file that can't be read, and
+    // only use the first copy of a block stored more than once.
+    std::unordered_map<uint256, const BlockFileEntry*, BlockHasher> entries;
+    std::unordered_multimap<uint256, const BlockFileEntry*, BlockHasher> children;
+    for (const auto& file : files) {
+        if (!file) break;
+        for (const BlockFileEntry& entry : *file) {
+            if (entries.emplace(entry.hash, &entry).second) {
+                children.emplace(entry.prev_hash, &entry);
+            }
+        }
+    }
+
+    // Order the blocks so that every block comes after its parent, starting from
+    // the genesis block and from blocks whose parent is already in the block index
+    // when resuming an interrupted reindex.
+    std::vector<FlatFilePos> positions;
+    positions.reserve(entries.size());
+    std::deque<const BlockFileEntry*> queue;
+    {
+        LOCK(::cs_main);
+        for (const auto& file : files) {
+            if (!file) break;
+            for (const BlockFileEntry& entry : *file) {
+                if (entries.at(entry.hash) != &entry || entries.count(entry.prev_hash)) continue;
+                if (entry.hash == params.GetConsensus().hashGenesisBlock || chainman.m_blockman.LookupBlockIndex(entry.prev_hash)) {
+                    queue.push_back(&entry);
+                }
+            }
+        }
+    }
+    while (!queue.empty()) {
+        const BlockFileEntry* entry{queue.front()};
+        queue.pop_front();
+        positions.push_back(entry->pos);
+        auto range{children.equal_range(entry->hash)};
+        for (auto it = range.first; it != range.second; ++it) {
+            queue.push_back(it->second);
+        }
+    }
+    if (positions.size() < entries.size()) {
+        LogPrintf("Skipping %u blocks with unknown parent\n", entries.size() - positions.size());
+    }
+
+    chainman.ActiveChainstate().ReindexBlocks(positions, threads);
+    return !ShutdownRequested();
+}
+
 struct CImportingNow {
     CImportingNow()
     {
@@ -834,26 +1694,44 @@ void ThreadImport(ChainstateManager& chainman, std::vector<fs::path> vImportFile
 
         // -reindex
         if (fReindex) {
-            int nFile = 0;
-            // Map of disk positions for blocks with unknown parent (only used for reindex);
-            // parent hash -> child disk position, multiple children can have the same parent.
-            std::multimap<uint256, FlatFilePos> blocks_with_unknown_parent;
-            while (true) {
-                FlatFilePos pos(nFile, 0);
-                if (!fs::exists(GetBlockPosFilename(pos))) {
-                    break; // No block files left to reindex
-                }
-                FILE* file = OpenBlockFile(pos, true);
-                if (!file) {
-                    break; // This error is logged in OpenBlockFile
-                }
-                LogPrintf("Reindexing block file blk%05u.dat...\n", (unsigned int)nFile);
-                chainman.ActiveChainstate().LoadExternalBlockFile(file, &pos, &blocks_with_unknown_parent);
-                if (ShutdownRequested()) {
+            const int threads{std::min<int>(args.GetIntArg("-reindexthreads", DEFAULT_REINDEX_THREADS), MAX_REINDEX_THREADS)};
+            if (threads > 0) {
+                LogPrintf("Reindexing block files with %d threads...\n", threads);
+                if (!ReindexBlockFilesInParallel(chainman, threads)) {
                     LogPrintf("Shutdown requested. Exit %s\n", __func__);
                     return;
                 }
-                nFile++;
+            } else {
+                int nFile = 0;
+                // Map of disk positions for blocks with unknown parent (only used for reindex);
+                // parent hash -> child disk position, multiple children can have the same parent.
+                std::multimap<uint256, FlatFilePos> blocks_with_unknown_parent;
+                while (true) {
+                    FlatFilePos pos(nFile, 0);
+                    if (!fs::exists(GetBlockPosFilename(pos))) {
+                        break; // No block files left to reindex
+                    }
+                    FILE* file = OpenBlockFile(pos, true);
+                    if (!file) {
+                        break; // This error is logged in OpenBlockFile
+                    }
+                    if (IsCompressedBlockFile(file, pos)) {
+                        FILE* expanded{ExpandCompressedBlockFile(file, nFile)};
+                        fclose(file);
+                        if (!expanded) {
+                            LogPrintf("Failed to read compressed block file blk%05u.dat\n", (unsigned int)nFile);
+                            break;
+                        }
+                        file = expanded;
+                    }
+                    LogPrintf("Reindexing block file blk%05u.dat...\n", (unsigned int)nFile);
+                    chainman.ActiveChainstate().LoadExternalBlockFile(file, &pos, &blocks_with_unknown_parent);
+                    if (ShutdownRequested()) {
+                        LogPrintf("Shutdown requested. Exit %s\n", __func__);
+                        return;
+                    }
+                    nFile++;
+                }
             }
             WITH_LOCK(::cs_main, chainman.m_blockman.m_block_tree_db->WriteReindexing(false));
             fReindex = false;
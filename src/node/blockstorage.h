@@ -9,11 +9,20 @@
 #include <chain.h>
 #include <fs.h>
 #include <protocol.h>
+#include <support/allocators/pool.h>
 #include <sync.h>
+#include <threadinterrupt.h>
 #include <txdb.h>
 
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -35,6 +44,8 @@ struct Params;
 }
 
 namespace node {
+class BlockFileWriter;
+
 static constexpr bool DEFAULT_STOPAFTERBLOCKIMPORT{false};
 
 /** The pre-allocation chunk size for blk?????.dat files (since 0.8) */
@@ -43,6 +54,15 @@ static const unsigned int BLOCKFILE_CHUNK_SIZE = 0x1000000; // 16 MiB
 static const unsigned int UNDOFILE_CHUNK_SIZE = 0x100000; // 1 MiB
 /** The maximum size of a blk?????.dat file (since 0.8) */
 static const unsigned int MAX_BLOCKFILE_SIZE = 0x8000000; // 128 MiB
+/** Default for -blockwritebuffer, in MiB */
+static constexpr int64_t DEFAULT_BLOCK_WRITE_BUFFER{32};
+static constexpr bool DEFAULT_BLOCK_COMPRESSION{false};
+/** Default for -reindexthreads, 0 to reindex the block files one after another */
+static constexpr int DEFAULT_REINDEX_THREADS{0};
+/** Maximum number of threads for -reindexthreads */
+static constexpr int MAX_REINDEX_THREADS{16};
+/** Default for -prunebatch, 0 to prune as many block files as needed at once */
+static constexpr int DEFAULT_PRUNE_BATCH{8};
 
 extern std::atomic_bool fImporting;
 extern std::atomic_bool fReindex;
@@ -51,12 +71,24 @@ extern std::atomic_bool fReindex;
 extern bool fPruneMode;
 /** Number of bytes of block files that we're trying to stay below. */
 extern uint64_t nPruneTarget;
+/** Number of blocks below the tip whose block and undo files are never pruned, at least MIN_BLOCKS_TO_KEEP. */
+extern int g_prune_undo_depth;
+/** Maximum number of block files pruned by one automatic prune event, 0 for no limit. */
+extern int g_prune_batch;
 
 // Because validation code takes pointers to the map's CBlockIndex objects, if
 // we ever switch to another associative container, we need to either use a
 // container that has stable addressing (true of all std associative
 // containers), or make the key a `std::unique_ptr<CBlockIndex>`
-using BlockMap = std::unordered_map<uint256, CBlockIndex, BlockHasher>;
+//
+// The entries are allocated from a PoolResource owned by the BlockManager, so
+// that entries added one after another, such as the headers of a synced chain
+// or a block index loaded from its snapshot, are contiguous in memory and
+// walking back through pprev and pskip stays within a few pages.
+using BlockMap = std::unordered_map<uint256, CBlockIndex, BlockHasher, std::equal_to<uint256>,
+                                    PoolAllocator<std::pair<const uint256, CBlockIndex>,
+                                                  sizeof(std::pair<const uint256, CBlockIndex>) + 2 * sizeof(void*),
+                                                  alignof(void*)>>;
 
 struct CBlockIndexWorkComparator {
     bool operator()(const CBlockIndex* pa, const CBlockIndex* pb) const;
@@ -71,6 +103,17 @@ struct PruneLockInfo {
     int height_first{std::numeric_limits<int>::max()}; //! Height of earliest block that should be kept and not pruned
 };
 
+/** The block files that the next automatic prune event deletes, see BlockManager::GetPrunePlan() */
+struct PrunePlan {
+    //! Block files to prune, oldest first
+    std::vector<int> files;
+    //! Disk space used by block and undo files before and after pruning them
+    uint64_t usage_before{0};
+    uint64_t usage_after{0};
+    //! Whether -prunebatch leaves more files to prune at the following prune events
+    bool incomplete{false};
+};
+
 /**
  * Maintains a tree of blocks (stored in `m_block_index`) which is consulted
  * to determine where the most-work tip is.
@@ -91,10 +134,21 @@ private:
      */
     bool LoadBlockIndex(const Consensus::Params& consensus_params)
         EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+    /**
+     * Load the block index from the snapshot written by WriteBlockIndexSnapshot(),
+     * if the block tree database has not changed since.
+     *
+     * @param[out] sorted_by_height  The loaded entries, sorted by height
+     * @returns false if there is no valid snapshot, leaving the block index empty
+     */
+    bool LoadBlockIndexSnapshot(std::vector<CBlockIndex*>& sorted_by_height)
+        EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     void FlushBlockFile(bool fFinalize = false, bool finalize_undo = false);
     void FlushUndoFile(int block_file, bool finalize = false);
     bool FindBlockPos(FlatFilePos& pos, unsigned int nAddSize, unsigned int nHeight, CChain& active_chain, uint64_t nTime, bool fKnown);
     bool FindUndoPos(BlockValidationState& state, int nFile, FlatFilePos& pos, unsigned int nAddSize);
+    /** Write data at pos of a blk or rev file, in the background unless -blockwritebuffer=0 */
+    bool WriteToBlockFile(bool undo, const FlatFilePos& pos, std::vector<unsigned char> data);
 
     /* Calculate the block/rev files to delete based on height specified by user with RPC command pruneblockchain */
     void FindFilesToPruneManual(std::set<int>& setFilesToPrune, int nManualPruneHeight, int chain_tip_height);
@@ -108,13 +162,15 @@ private:
      * Pruning functions are called from FlushStateToDisk when the m_check_for_pruning flag has been set.
      * Block and undo files are deleted in lock-step (when blk00003.dat is deleted, so is rev00003.dat.)
      * Pruning cannot take place until the longest chain is at least a certain length (CChainParams::nPruneAfterHeight).
-     * Pruning will never delete a block within a defined distance (currently 288) from the active chain's tip.
+     * Pruning will never delete a block within -pruneundodepth (at least 288) blocks from the active chain's tip.
+     * To avoid deleting many files at once, at most -prunebatch files are pruned per call.
      * The block index is updated by unsetting HAVE_DATA and HAVE_UNDO for any blocks that were stored in the deleted files.
      * A db flag records the fact that at least some block files have been pruned.
      *
      * @param[out]   setFilesToPrune   The set of file indices that can be unlinked will be returned
+     * @returns false if -prunebatch left files to prune at the next call
      */
-    void FindFilesToPrune(std::set<int>& setFilesToPrune, uint64_t nPruneAfterHeight, int chain_tip_height, int prune_height, bool is_ibd);
+    bool FindFilesToPrune(std::set<int>& setFilesToPrune, uint64_t nPruneAfterHeight, int chain_tip_height, int prune_height, bool is_ibd);
 
     RecursiveMutex cs_LastBlockFile;
     std::vector<CBlockFileInfo> m_blockfile_info;
@@ -139,8 +195,23 @@ private:
      */
     std::unordered_map<std::string, PruneLockInfo> m_prune_locks GUARDED_BY(::cs_main);
 
+    //! Writes block and undo data in the background, nullptr if -blockwritebuffer=0
+    std::unique_ptr<BlockFileWriter> m_block_file_writer;
+
+    std::thread m_block_file_compression;
+    CThreadInterrupt m_interrupt_block_file_compression;
+
+    //! Compress each complete block file, then wait for more files to complete.
+    void ThreadCompressBlockFiles();
+
+    //! Memory of the entries of m_block_index, which must not outlive it
+    BlockMap::allocator_type::ResourceType m_block_index_resource;
+
 public:
-    BlockMap m_block_index GUARDED_BY(cs_main);
+    BlockManager();
+    ~BlockManager();
+
+    BlockMap m_block_index GUARDED_BY(cs_main){0, BlockHasher{}, std::equal_to<uint256>{}, &m_block_index_resource};
 
     std::vector<CBlockIndex*> GetAllBlockIndices() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
@@ -153,6 +224,12 @@ public:
     std::unique_ptr<CBlockTreeDB> m_block_tree_db GUARDED_BY(::cs_main);
 
     bool WriteBlockIndexDB() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+    /**
+     * Write the whole block index to a flat file, which the next startup loads
+     * with a single read instead of iterating the block tree database. Used on
+     * clean shutdown; any later database write invalidates the snapshot.
+     */
+    bool WriteBlockIndexSnapshot() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
     bool LoadBlockIndexDB(const Consensus::Params& consensus_params) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
     CBlockIndex* AddToBlockIndex(const CBlockHeader& block, CBlockIndex*& best_header) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
@@ -173,6 +250,22 @@ public:
 
     FlatFilePos SaveBlockToDisk(const CBlock& block, int nHeight, CChain& active_chain, const CChainParams& chainparams, const FlatFilePos* dbp);
 
+    /**
+     * Compress a block file that blocks are no longer appended to. The blocks
+     * keep their positions, so the block index stays valid, and the functions
+     * reading blocks below find them in the compressed file. Data in the file
+     * that is not a block in the block index is dropped.
+     *
+     * @returns true if the file is compressed, including if it already was
+     */
+    bool CompressBlockFile(int file_number) LOCKS_EXCLUDED(::cs_main);
+
+    //! Compress complete block files in a separate thread, for -blockcompression.
+    void StartBlockFileCompression();
+
+    //! Interrupt block file compression and wait for its thread to exit.
+    void StopBlockFileCompression();
+
     /** Calculate the amount of disk space the block & undo files currently use */
     uint64_t CalculateCurrentUsage();
 
@@ -182,6 +275,9 @@ public:
     //! Find the first block that is not pruned
     const CBlockIndex* GetFirstStoredBlock(const CBlockIndex& start_block LIFETIMEBOUND) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
+    /** True once the block index mirrors the block tree database, so that it may be snapshotted. */
+    bool m_block_index_loaded GUARDED_BY(::cs_main){false};
+
     /** True if any block files have ever been pruned. */
     bool m_have_pruned = false;
 
@@ -190,12 +286,57 @@ public:
 
     //! Create or update a prune lock identified by its name
     void UpdatePruneLock(const std::string& name, const PruneLockInfo& lock_info) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+    //! Get the prune locks, by name
+    std::unordered_map<std::string, PruneLockInfo> GetPruneLocks() const EXCLUSIVE_LOCKS_REQUIRED(::cs_main) { return m_prune_locks; }
+
+    /**
+     * Highest height whose block and undo files the prune locks allow to prune,
+     * the tip if there are none. Pruning also keeps -pruneundodepth blocks below the tip.
+     *
+     * @param[out] limiting_lock  The prune lock that limits the height, if any
+     */
+    int GetPruneLockHeight(int chain_tip_height, std::optional<std::string>& limiting_lock) const EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+    /**
+     * Select the block files that FindFilesToPrune() prunes, without pruning them:
+     * the oldest files below prune_height, until the disk usage is below the prune
+     * target or -prunebatch files are selected.
+     */
+    PrunePlan GetPrunePlan(uint64_t nPruneAfterHeight, int chain_tip_height, int prune_height, bool is_ibd);
 };
 
 void CleanupBlockRevFiles();
 
 /** Open a block file (blk?????.dat) */
 FILE* OpenBlockFile(const FlatFilePos& pos, bool fReadOnly = false);
+/**
+ * Whether a block file opened by OpenBlockFile() was compressed by
+ * BlockManager::CompressBlockFile(). The file is left positioned at pos.
+ */
+bool IsCompressedBlockFile(FILE* file, const FlatFilePos& pos);
+/**
+ * Read the record of the block at pos from a compressed block file: the
+ * network magic and the size of the block, followed by the block. Like in the
+ * block index, pos is the position of the block itself.
+ */
+bool ReadCompressedBlockRecord(FILE* file, const FlatFilePos& pos, std::vector<uint8_t>& record);
+
+/** A block found in a block file by ScanBlockFile() */
+struct BlockFileEntry {
+    uint256 hash;
+    uint256 prev_hash;
+    //! Position of the block itself, like in the block index
+    FlatFilePos pos;
+};
+
+/**
+ * Find the blocks in a block file, reading only their headers and skipping
+ * over their transactions. Like in a reindex, data that doesn't start with
+ * the network magic or whose header lacks valid proof of work is skipped.
+ * Returns std::nullopt if the file is missing or can't be read.
+ */
+std::optional<std::vector<BlockFileEntry>> ScanBlockFile(int file_number, const CChainParams& params);
 /** Translation to a filesystem path */
 fs::path GetBlockPosFilename(const FlatFilePos& pos);
 
@@ -210,6 +351,49 @@ bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus
 bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const FlatFilePos& pos, const CMessageHeader::MessageStartChars& message_start);
 
 bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex* pindex);
+/** Read the undo data at pos of a block whose parent is prev_hash, which the checksum of the undo data commits to */
+bool UndoReadFromDisk(CBlockUndo& blockundo, const FlatFilePos& pos, const uint256& prev_hash);
+
+/**
+ * Reads the blocks at a list of positions with a number of threads, ahead of
+ * the caller taking them in order with Next(). At most a few blocks per thread
+ * are read ahead. An optional check runs on each block on the thread that read
+ * it, so that it is done in parallel too.
+ */
+class BlockPrefetcher
+{
+public:
+    //! Called with the index of the block in the list of positions
+    using CheckFn = std::function<void(size_t, const CBlock&)>;
+
+    BlockPrefetcher(std::vector<FlatFilePos> positions, int threads, const Consensus::Params& consensus_params, CheckFn check = {});
+    //! Stop reading and wait for the threads to exit
+    ~BlockPrefetcher();
+
+    BlockPrefetcher(const BlockPrefetcher&) = delete;
+    BlockPrefetcher& operator=(const BlockPrefetcher&) = delete;
+
+    //! Wait for the next block in order, nullptr if it couldn't be read. Must
+    //! not be called more often than there are positions.
+    std::shared_ptr<const CBlock> Next() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    const std::vector<FlatFilePos> m_positions;
+    const size_t m_read_ahead;
+    const Consensus::Params& m_consensus_params;
+    const CheckFn m_check;
+
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    //! Blocks read ahead, by their index in m_positions
+    std::map<size_t, std::shared_ptr<const CBlock>> m_blocks GUARDED_BY(m_mutex);
+    size_t m_next_read GUARDED_BY(m_mutex){0};
+    size_t m_next_taken GUARDED_BY(m_mutex){0};
+    bool m_stop GUARDED_BY(m_mutex){false};
+    std::vector<std::thread> m_threads;
+
+    void ThreadRead() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+};
 
 void ThreadImport(ChainstateManager& chainman, std::vector<fs::path> vImportFiles, const ArgsManager& args, const fs::path& mempool_path);
 } // namespace node
@@ -169,7 +169,8 @@ ChainstateLoadResult VerifyLoadedChainstate(ChainstateManager& chainman, const C
             if (!CVerifyDB().VerifyDB(
                     *chainstate, chainman.GetConsensus(), chainstate->CoinsDB(),
                     options.check_level,
-                    options.check_blocks)) {
+                    options.check_blocks,
+                    chainman.m_options.check_threads)) {
                 return {ChainstateLoadStatus::FAILURE, _("Corrupted block database detected")};
             }
         }
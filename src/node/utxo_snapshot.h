@@ -6,10 +6,25 @@
 #ifndef BITCOIN_NODE_UTXO_SNAPSHOT_H
 #define BITCOIN_NODE_UTXO_SNAPSHOT_H
 
-#include <uint256.h>
 #include <serialize.h>
+#include <span.h>
+#include <uint256.h>
+
+#include <array>
+#include <cstdint>
+#include <ios>
 
 namespace node {
+//! Magic bytes at the start of a UTXO snapshot file.
+static constexpr std::array<uint8_t, 5> SNAPSHOT_MAGIC_BYTES{'u', 't', 'x', 'o', 0xff};
+
+//! Version of the snapshot format. Since version 2 the coins of a transaction
+//! are grouped under a single txid: the txid, the number of its coins, and
+//! for each coin its output index and the coin itself. Transactions appear in
+//! increasing txid order and their coins in increasing output index order, the
+//! same order as in the coins database.
+static constexpr uint16_t SNAPSHOT_VERSION{2};
+
 //! Metadata describing a serialized version of a UTXO set from which an
 //! assumeutxo Chainstate can be constructed.
 class SnapshotMetadata
@@ -31,7 +46,28 @@ public:
             m_base_blockhash(base_blockhash),
             m_coins_count(coins_count) { }
 
-    SERIALIZE_METHODS(SnapshotMetadata, obj) { READWRITE(obj.m_base_blockhash, obj.m_coins_count); }
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        s.write(MakeByteSpan(SNAPSHOT_MAGIC_BYTES));
+        s << SNAPSHOT_VERSION << m_base_blockhash << m_coins_count;
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        std::array<uint8_t, SNAPSHOT_MAGIC_BYTES.size()> magic;
+        uint16_t version;
+        s.read(MakeWritableByteSpan(magic));
+        s >> version;
+        if (magic != SNAPSHOT_MAGIC_BYTES) {
+            throw std::ios_base::failure("Invalid UTXO snapshot magic bytes");
+        }
+        if (version != SNAPSHOT_VERSION) {
+            throw std::ios_base::failure("Unsupported UTXO snapshot version");
+        }
+        s >> m_base_blockhash >> m_coins_count;
+    }
 };
 } // namespace node
 
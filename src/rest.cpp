@@ -9,7 +9,9 @@
 #include <chain.h>
 #include <chainparams.h>
 #include <core_io.h>
+#include <key_io.h>
 #include <httpserver.h>
+#include <index/addressindex.h>
 #include <index/blockfilterindex.h>
 #include <index/txindex.h>
 #include <node/blockstorage.h>
@@ -21,6 +23,7 @@
 #include <rpc/protocol.h>
 #include <rpc/server.h>
 #include <rpc/server_util.h>
+#include <script/standard.h>
 #include <streams.h>
 #include <sync.h>
 #include <txmempool.h>
@@ -926,6 +929,72 @@ static bool rest_blockhash_by_height(const std::any& context, HTTPRequest* req,
     }
 }
 
+static bool rest_address(const std::any& context, HTTPRequest* req, const std::string& str_uri_part)
+{
+    if (!CheckWarmup(req)) return false;
+
+    std::string param;
+    const RESTResponseFormat rf = ParseDataFormat(param, str_uri_part);
+    if (rf != RESTResponseFormat::JSON) {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: json)");
+    }
+
+    // /rest/address/<history|utxos>/<address>.json?count=<count>&cursor=<cursor>
+    const std::vector<std::string> uri_parts{SplitString(param, '/')};
+    if (uri_parts.size() != 2 || (uri_parts[0] != "history" && uri_parts[0] != "utxos")) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Expected /rest/address/<history|utxos>/<address>.json?count=<count>&cursor=<cursor>");
+    }
+    const CTxDestination dest{DecodeDestination(uri_parts[1])};
+    if (!IsValidDestination(dest)) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid address: " + SanitizeString(uri_parts[1]));
+    }
+    const std::string raw_count{req->GetQueryParameter("count").value_or(ToString(DEFAULT_ADDRESS_INDEX_RESULTS))};
+    const auto count{ToIntegral<size_t>(raw_count)};
+    if (!count || *count < 1 || *count > MAX_ADDRESS_INDEX_RESULTS) {
+        return RESTERR(req, HTTP_BAD_REQUEST, strprintf("Count is invalid or out of acceptable range (1-%u): %s", MAX_ADDRESS_INDEX_RESULTS, SanitizeString(raw_count)));
+    }
+    const std::optional<std::string> cursor{req->GetQueryParameter("cursor")};
+
+    if (!g_address_index) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Address index is not enabled");
+    }
+    if (!g_address_index->BlockUntilSyncedToCurrentChain()) {
+        return RESTERR(req, HTTP_SERVICE_UNAVAILABLE, "Address index is still syncing");
+    }
+
+    const CScript script{GetScriptForDestination(dest)};
+    UniValue result;
+    if (uri_parts[0] == "history") {
+        AddressHistoryPosition start;
+        if (cursor) {
+            const auto position{AddressHistoryPosition::FromString(*cursor)};
+            if (!position) return RESTERR(req, HTTP_BAD_REQUEST, "Invalid cursor: " + SanitizeString(*cursor));
+            start = *position;
+        }
+        std::vector<AddressHistoryEntry> entries;
+        if (!g_address_index->FindHistory(script, start, *count + 1, entries)) {
+            return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Unable to read the address index");
+        }
+        result = AddressHistoryToJSON(entries, *count);
+    } else {
+        COutPoint start;
+        if (cursor) {
+            const auto outpoint{ParseAddressUnspentCursor(*cursor)};
+            if (!outpoint) return RESTERR(req, HTTP_BAD_REQUEST, "Invalid cursor: " + SanitizeString(*cursor));
+            start = *outpoint;
+        }
+        std::vector<AddressUnspentEntry> entries;
+        if (!g_address_index->FindUnspent(script, start, *count + 1, entries)) {
+            return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Unable to read the address index");
+        }
+        result = AddressUnspentToJSON(entries, *count);
+    }
+
+    req->WriteHeader("Content-Type", "application/json");
+    req->WriteReply(HTTP_OK, result.write() + "\n");
+    return true;
+}
+
 static const struct {
     const char* prefix;
     bool (*handler)(const std::any& context, HTTPRequest* req, const std::string& strReq);
@@ -940,6 +1009,7 @@ static const struct {
       {"/rest/headers/", rest_headers},
       {"/rest/getutxos", rest_getutxos},
       {"/rest/blockhashbyheight/", rest_blockhash_by_height},
+      {"/rest/address/", rest_address},
 };
 
 void StartREST(const std::any& context)
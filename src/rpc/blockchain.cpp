@@ -17,9 +17,11 @@
 #include <deploymentstatus.h>
 #include <fs.h>
 #include <hash.h>
+#include <index/addressindex.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
 #include <kernel/coinstats.h>
+#include <key_io.h>
 #include <logging/timer.h>
 #include <net.h>
 #include <net_processing.h>
@@ -31,6 +33,7 @@
 #include <rpc/server_util.h>
 #include <rpc/util.h>
 #include <script/descriptor.h>
+#include <script/standard.h>
 #include <streams.h>
 #include <sync.h>
 #include <txdb.h>
@@ -39,6 +42,7 @@
 #include <univalue.h>
 #include <util/check.h>
 #include <util/strencodings.h>
+#include <util/string.h>
 #include <util/system.h>
 #include <util/translation.h>
 #include <validation.h>
@@ -49,8 +53,11 @@
 #include <stdint.h>
 
 #include <condition_variable>
+#include <future>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <vector>
 
 using kernel::CCoinsStats;
 using kernel::CoinStatsHashType;
@@ -792,9 +799,9 @@ static RPCHelpMan pruneblockchain()
         throw JSONRPCError(RPC_MISC_ERROR, "Blockchain is too short for pruning.");
     } else if (height > chainHeight) {
         throw JSONRPCError(RPC_INVALID_PARAMETER, "Blockchain is shorter than the attempted prune height.");
-    } else if (height > chainHeight - MIN_BLOCKS_TO_KEEP) {
+    } else if (height > chainHeight - node::g_prune_undo_depth) {
         LogPrint(BCLog::RPC, "Attempt to prune blocks close to the tip.  Retaining the minimum number of blocks.\n");
-        height = chainHeight - MIN_BLOCKS_TO_KEEP;
+        height = chainHeight - node::g_prune_undo_depth;
     }
 
     PruneBlockFilesManual(active_chainstate, height);
@@ -806,6 +813,103 @@ static RPCHelpMan pruneblockchain()
     };
 }
 
+static RPCHelpMan getpruneplan()
+{
+    return RPCHelpMan{"getpruneplan",
+                "\nReturns what limits pruning and the block files that the next automatic prune event deletes.\n",
+                {},
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::NUM, "pruneheight", "Height of the last block pruned, plus one"},
+                        {RPCResult::Type::NUM, "undodepth", "The number of blocks below the tip whose blocks and undo data are kept (-pruneundodepth)"},
+                        {RPCResult::Type::NUM, "maxpruneheight", "Height of the last block that may be pruned, or -1 if none"},
+                        {RPCResult::Type::STR, "limitedby", /*optional=*/true, "The index that limits maxpruneheight further than undodepth"},
+                        {RPCResult::Type::ARR, "prunelocks", "The blocks needed by indexes",
+                        {
+                            {RPCResult::Type::OBJ, "", "",
+                            {
+                                {RPCResult::Type::STR, "name", "The index"},
+                                {RPCResult::Type::NUM, "height", "Height of the earliest block it needs"},
+                            }},
+                        }},
+                        {RPCResult::Type::BOOL, "automatic_pruning", "Whether automatic pruning is enabled"},
+                        {RPCResult::Type::NUM, "prune_target_size", /*optional=*/true, "The target size used by pruning (only present if automatic pruning is enabled)"},
+                        {RPCResult::Type::NUM, "batch", "The maximum number of files pruned at once, 0 for no limit (-prunebatch)"},
+                        {RPCResult::Type::NUM, "size_on_disk", "The size of the block and undo files on disk"},
+                        {RPCResult::Type::NUM, "size_after_pruning", "The size of the block and undo files after the next prune event"},
+                        {RPCResult::Type::ARR, "files", "The block and undo files that the next prune event deletes, oldest first",
+                        {
+                            {RPCResult::Type::OBJ, "", "",
+                            {
+                                {RPCResult::Type::NUM, "file", "The number of the blk and rev files"},
+                                {RPCResult::Type::NUM, "firstheight", "The lowest height of the blocks in the file"},
+                                {RPCResult::Type::NUM, "lastheight", "The highest height of the blocks in the file"},
+                                {RPCResult::Type::NUM, "size", "The size of the blk and rev files"},
+                            }},
+                        }},
+                        {RPCResult::Type::BOOL, "incomplete", "Whether more files need to be pruned at later prune events to get below the target"},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getpruneplan", "")
+            + HelpExampleRpc("getpruneplan", "")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    if (!node::fPruneMode)
+        throw JSONRPCError(RPC_MISC_ERROR, "Cannot prune blocks because node is not in prune mode.");
+
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    LOCK(cs_main);
+    Chainstate& active_chainstate = chainman.ActiveChainstate();
+    node::BlockManager& blockman{active_chainstate.m_blockman};
+    const CBlockIndex& tip{*CHECK_NONFATAL(active_chainstate.m_chain.Tip())};
+
+    std::optional<std::string> limiting_lock;
+    const int prune_lock_height{blockman.GetPruneLockHeight(tip.nHeight, limiting_lock)};
+    const int max_prune_height{std::min(prune_lock_height, tip.nHeight - node::g_prune_undo_depth)};
+    if (max_prune_height < prune_lock_height) limiting_lock.reset();
+    const node::PrunePlan plan{blockman.GetPrunePlan(chainman.GetParams().PruneAfterHeight(), tip.nHeight, max_prune_height, active_chainstate.IsInitialBlockDownload())};
+
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("pruneheight", blockman.GetFirstStoredBlock(tip)->nHeight);
+    obj.pushKV("undodepth", node::g_prune_undo_depth);
+    obj.pushKV("maxpruneheight", std::max(-1, max_prune_height));
+    if (limiting_lock) obj.pushKV("limitedby", *limiting_lock);
+    UniValue prune_locks(UniValue::VARR);
+    for (const auto& [name, lock_info] : blockman.GetPruneLocks()) {
+        if (lock_info.height_first == std::numeric_limits<int>::max()) continue;
+        UniValue prune_lock(UniValue::VOBJ);
+        prune_lock.pushKV("name", name);
+        prune_lock.pushKV("height", lock_info.height_first);
+        prune_locks.push_back(prune_lock);
+    }
+    obj.pushKV("prunelocks", prune_locks);
+    const bool automatic_pruning{node::nPruneTarget != std::numeric_limits<uint64_t>::max()};
+    obj.pushKV("automatic_pruning", automatic_pruning);
+    if (automatic_pruning) {
+        obj.pushKV("prune_target_size", node::nPruneTarget);
+    }
+    obj.pushKV("batch", node::g_prune_batch);
+    obj.pushKV("size_on_disk", plan.usage_before);
+    obj.pushKV("size_after_pruning", plan.usage_after);
+    UniValue files(UniValue::VARR);
+    for (const int file_number : plan.files) {
+        const CBlockFileInfo& info{*blockman.GetBlockFileInfo(file_number)};
+        UniValue file(UniValue::VOBJ);
+        file.pushKV("file", file_number);
+        file.pushKV("firstheight", info.nHeightFirst);
+        file.pushKV("lastheight", info.nHeightLast);
+        file.pushKV("size", uint64_t{info.nSize} + info.nUndoSize);
+        files.push_back(file);
+    }
+    obj.pushKV("files", files);
+    obj.pushKV("incomplete", plan.incomplete);
+    return obj;
+},
+    };
+}
+
 CoinStatsHashType ParseHashType(const std::string& hash_type_input)
 {
     if (hash_type_input == "hash_serialized_2") {
@@ -853,7 +957,7 @@ static RPCHelpMan gettxoutsetinfo()
 {
     return RPCHelpMan{"gettxoutsetinfo",
                 "\nReturns statistics about the unspent transaction output set.\n"
-                "Note this call may take some time if you are not using coinstatsindex.\n",
+                "Note this call may take some time if you are not using coinstatsindex, or -utxostats for the 'muhash' and 'none' hash types.\n",
                 {
                     {"hash_type", RPCArg::Type::STR, RPCArg::Default{"hash_serialized_2"}, "Which UTXO set hash should be calculated. Options: 'hash_serialized_2' (the legacy algorithm), 'muhash', 'none'."},
                     {"hash_or_height", RPCArg::Type::NUM, RPCArg::DefaultHint{"the current best block"}, "The block hash or height of the target height (only available with coinstatsindex).", RPCArgOptions{.type_str={"", "string or numeric"}}},
@@ -868,7 +972,7 @@ static RPCHelpMan gettxoutsetinfo()
                         {RPCResult::Type::NUM, "bogosize", "Database-independent, meaningless metric indicating the UTXO set size"},
                         {RPCResult::Type::STR_HEX, "hash_serialized_2", /*optional=*/true, "The serialized hash (only present if 'hash_serialized_2' hash_type is chosen)"},
                         {RPCResult::Type::STR_HEX, "muhash", /*optional=*/true, "The serialized hash (only present if 'muhash' hash_type is chosen)"},
-                        {RPCResult::Type::NUM, "transactions", /*optional=*/true, "The number of transactions with unspent outputs (not available when coinstatsindex is used)"},
+                        {RPCResult::Type::NUM, "transactions", /*optional=*/true, "The number of transactions with unspent outputs (not available when coinstatsindex or -utxostats is used)"},
                         {RPCResult::Type::NUM, "disk_size", /*optional=*/true, "The estimated size of the chainstate on disk (not available when coinstatsindex is used)"},
                         {RPCResult::Type::STR_AMOUNT, "total_amount", "The total amount of coins in the UTXO set"},
                         {RPCResult::Type::STR_AMOUNT, "total_unspendable_amount", /*optional=*/true, "The total amount of coins permanently excluded from the UTXO set (only available if coinstatsindex is used)"},
@@ -947,7 +1051,14 @@ static RPCHelpMan gettxoutsetinfo()
         }
     }
 
-    const std::optional<CCoinsStats> maybe_stats = GetUTXOStats(coins_view, *blockman, hash_type, node.rpc_interruption_point, pindex, index_requested);
+    std::optional<CCoinsStats> maybe_stats;
+    if (hash_type != CoinStatsHashType::HASH_SERIALIZED && !(index_requested && g_coin_stats_index)) {
+        // Without the index, answer from the running statistics of the chainstate if available
+        maybe_stats = active_chainstate.GetRunningCoinsStats(node.rpc_interruption_point);
+    }
+    if (!maybe_stats) {
+        maybe_stats = GetUTXOStats(coins_view, *blockman, hash_type, node.rpc_interruption_point, pindex, index_requested);
+    }
     if (maybe_stats.has_value()) {
         const CCoinsStats& stats = maybe_stats.value();
         ret.pushKV("height", (int64_t)stats.nHeight);
@@ -963,7 +1074,9 @@ static RPCHelpMan gettxoutsetinfo()
         CHECK_NONFATAL(stats.total_amount.has_value());
         ret.pushKV("total_amount", ValueFromAmount(stats.total_amount.value()));
         if (!stats.index_used) {
-            ret.pushKV("transactions", static_cast<int64_t>(stats.nTransactions));
+            if (!stats.running_stats_used) {
+                ret.pushKV("transactions", static_cast<int64_t>(stats.nTransactions));
+            }
             ret.pushKV("disk_size", stats.nDiskSize);
         } else {
             ret.pushKV("total_unspendable_amount", ValueFromAmount(stats.total_unspendable_amount));
@@ -1090,11 +1203,19 @@ static RPCHelpMan verifychain()
                     {"checklevel", RPCArg::Type::NUM, RPCArg::DefaultHint{strprintf("%d, range=0-4", DEFAULT_CHECKLEVEL)},
                         strprintf("How thorough the block verification is:\n%s", MakeUnorderedList(CHECKLEVEL_DOC))},
                     {"nblocks", RPCArg::Type::NUM, RPCArg::DefaultHint{strprintf("%d, 0=all", DEFAULT_CHECKBLOCKS)}, "The number of blocks to check."},
+                    {"background", RPCArg::Type::BOOL, RPCArg::Default{false}, "Verify the blocks in the background, once the initial block download is done, and return right away.\n"
+                        "The checks of levels 0 to 2 don't hold up the node. Levels 3 and 4 run at the end, on as many blocks as the coins cache can hold.\n"
+                        "A verification interrupted by a shutdown continues on the next start. See getverifychaininfo for its progress."},
+                },
+                {
+                    RPCResult{"if background is false",
+                        RPCResult::Type::BOOL, "", "Verified or not"},
+                    RPCResult{"if background is true",
+                        RPCResult::Type::BOOL, "", "Whether the verification was started; false if one is running already"},
                 },
-                RPCResult{
-                    RPCResult::Type::BOOL, "", "Verified or not"},
                 RPCExamples{
                     HelpExampleCli("verifychain", "")
+            + HelpExampleCli("verifychain", "4 0 true")
             + HelpExampleRpc("verifychain", "")
                 },
         [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
@@ -1103,11 +1224,57 @@ static RPCHelpMan verifychain()
     const int check_depth{request.params[1].isNull() ? DEFAULT_CHECKBLOCKS : request.params[1].getInt<int>()};
 
     ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    if (!request.params[2].isNull() && request.params[2].get_bool()) {
+        return chainman.StartBackgroundVerification(check_level, check_depth);
+    }
+
     LOCK(cs_main);
 
     Chainstate& active_chainstate = chainman.ActiveChainstate();
     return CVerifyDB().VerifyDB(
-        active_chainstate, chainman.GetParams().GetConsensus(), active_chainstate.CoinsTip(), check_level, check_depth);
+        active_chainstate, chainman.GetParams().GetConsensus(), active_chainstate.CoinsTip(), check_level, check_depth, chainman.m_options.check_threads);
+},
+    };
+}
+
+static RPCHelpMan getverifychaininfo()
+{
+    return RPCHelpMan{"getverifychaininfo",
+                "\nReturns the progress of the chain verification started with verifychain in the background, or the result of the last one.\n",
+                {},
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::BOOL, "running", "Whether a verification is running"},
+                        {RPCResult::Type::NUM, "checklevel", /*optional=*/true, "The level of the verification"},
+                        {RPCResult::Type::BOOL, "paused", /*optional=*/true, "Whether the verification is waiting for the initial block download to finish"},
+                        {RPCResult::Type::NUM, "blocks", /*optional=*/true, "The number of blocks checked at levels 0 to 2"},
+                        {RPCResult::Type::NUM, "target", /*optional=*/true, "The number of blocks to check"},
+                        {RPCResult::Type::NUM, "progress", /*optional=*/true, "The fraction of the blocks checked at levels 0 to 2"},
+                        {RPCResult::Type::BOOL, "verified", /*optional=*/true, "Once the verification is finished, whether no errors were found"},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getverifychaininfo", "")
+            + HelpExampleRpc("getverifychaininfo", "")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    // Doesn't take cs_main, which the checks of levels 3 and 4 hold
+    const auto status{chainman.GetBackgroundVerificationStatus()};
+
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("running", status && status->running);
+    if (status) {
+        const VerifyChainProgress& progress{status->progress};
+        obj.pushKV("checklevel", progress.check_level);
+        if (status->running) obj.pushKV("paused", status->paused);
+        obj.pushKV("blocks", progress.blocks_checked);
+        obj.pushKV("target", progress.blocks_total);
+        obj.pushKV("progress", progress.blocks_total > 0 ? double(progress.blocks_checked) / progress.blocks_total : 1.0);
+        if (status->verified) obj.pushKV("verified", *status->verified);
+    }
+    return obj;
 },
     };
 }
@@ -1463,6 +1630,103 @@ static RPCHelpMan getchaintips()
     };
 }
 
+static RPCHelpMan getchainstates()
+{
+    return RPCHelpMan{"getchainstates",
+        "\nReturn information about the chainstates in use: the one following the tip and, while a loaded UTXO snapshot\n"
+        "is being validated, the background chainstate validating the blocks beneath the snapshot base block.\n",
+        {},
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::NUM, "headers", "the number of headers seen so far"},
+                {RPCResult::Type::ARR, "chainstates", "list of the chainstates in use",
+                {
+                    {RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::NUM, "blocks", "number of blocks in this chainstate"},
+                        {RPCResult::Type::STR_HEX, "bestblockhash", "blockhash of the tip"},
+                        {RPCResult::Type::NUM, "verificationprogress", "estimate of verification progress [0..1]"},
+                        {RPCResult::Type::STR_HEX, "snapshot_blockhash", /*optional=*/true, "the base block of the snapshot this chainstate is based on, if any"},
+                        {RPCResult::Type::BOOL, "active", "whether this chainstate follows the tip"},
+                        {RPCResult::Type::BOOL, "validated", "whether the chainstate is fully validated. True if all blocks in the chainstate were validated, false if the chain is based on a snapshot and the snapshot has not yet been validated"},
+                        {RPCResult::Type::NUM, "coins_db_cache_bytes", "size of the coinsdb cache"},
+                        {RPCResult::Type::NUM, "coins_tip_cache_bytes", "size of the coinstip cache"},
+                        {RPCResult::Type::OBJ, "coins_cache", "the in-memory coins cache of this chainstate",
+                        {
+                            {RPCResult::Type::NUM, "entries", "the number of coins in the cache"},
+                            {RPCResult::Type::NUM, "usage", "the memory used by the cache, in bytes"},
+                            {RPCResult::Type::NUM, "hits", "the number of coin lookups served from the cache"},
+                            {RPCResult::Type::NUM, "misses", "the number of coin lookups that had to read from the coins database"},
+                            {RPCResult::Type::NUM, "hit_ratio", "the fraction of coin lookups served from the cache"},
+                        }},
+                    }},
+                }},
+                {RPCResult::Type::OBJ, "background_validation", /*optional=*/true, "progress of the background chainstate (only present while a snapshot is being validated)",
+                {
+                    {RPCResult::Type::NUM, "blocks", "number of blocks in the background chainstate"},
+                    {RPCResult::Type::NUM, "target", "height of the snapshot base block"},
+                    {RPCResult::Type::NUM, "budget", "percentage of time spent on background validation (see -backgroundvalidationbudget)"},
+                    {RPCResult::Type::BOOL, "paused", "whether background validation waits for the active chainstate to catch up with the tip"},
+                    {RPCResult::Type::NUM, "blocks_per_second", "blocks validated per second since background validation started"},
+                    {RPCResult::Type::NUM, "eta", /*optional=*/true, "estimated number of seconds until the snapshot base block is reached"},
+                }},
+            }},
+        RPCExamples{
+            HelpExampleCli("getchainstates", "")
+            + HelpExampleRpc("getchainstates", "")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    LOCK(cs_main);
+
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("headers", chainman.m_best_header ? chainman.m_best_header->nHeight : -1);
+
+    UniValue chainstates(UniValue::VARR);
+    for (Chainstate* chainstate : chainman.GetAll()) {
+        const CBlockIndex& tip{*CHECK_NONFATAL(chainstate->m_chain.Tip())};
+        const CCoinsViewCache& coins_tip{chainstate->CoinsTip()};
+        const uint64_t lookups{coins_tip.GetCacheHits() + coins_tip.GetCacheMisses()};
+
+        UniValue data(UniValue::VOBJ);
+        data.pushKV("blocks", tip.nHeight);
+        data.pushKV("bestblockhash", tip.GetBlockHash().GetHex());
+        data.pushKV("verificationprogress", GuessVerificationProgress(chainman.GetParams().TxData(), &tip));
+        if (chainstate->m_from_snapshot_blockhash) {
+            data.pushKV("snapshot_blockhash", chainstate->m_from_snapshot_blockhash->GetHex());
+        }
+        data.pushKV("active", chainstate == &chainman.ActiveChainstate());
+        data.pushKV("validated", !chainstate->m_from_snapshot_blockhash || chainman.IsSnapshotValidated());
+        data.pushKV("coins_db_cache_bytes", chainstate->m_coinsdb_cache_size_bytes);
+        data.pushKV("coins_tip_cache_bytes", chainstate->m_coinstip_cache_size_bytes);
+        UniValue cache(UniValue::VOBJ);
+        cache.pushKV("entries", uint64_t(coins_tip.GetCacheSize()));
+        cache.pushKV("usage", coins_tip.DynamicMemoryUsage());
+        cache.pushKV("hits", coins_tip.GetCacheHits());
+        cache.pushKV("misses", coins_tip.GetCacheMisses());
+        cache.pushKV("hit_ratio", lookups > 0 ? double(coins_tip.GetCacheHits()) / lookups : 0.0);
+        data.pushKV("coins_cache", cache);
+        chainstates.push_back(data);
+    }
+    obj.pushKV("chainstates", chainstates);
+
+    if (const auto progress{chainman.GetBackgroundValidationProgress()}) {
+        UniValue background(UniValue::VOBJ);
+        background.pushKV("blocks", progress->height);
+        background.pushKV("target", progress->target_height);
+        background.pushKV("budget", chainman.m_options.background_validation_budget);
+        background.pushKV("paused", progress->paused);
+        background.pushKV("blocks_per_second", progress->blocks_per_second);
+        if (progress->eta) background.pushKV("eta", count_seconds(*progress->eta));
+        obj.pushKV("background_validation", background);
+    }
+    return obj;
+},
+    };
+}
+
 static RPCHelpMan preciousblock()
 {
     return RPCHelpMan{"preciousblock",
@@ -1960,31 +2224,57 @@ static RPCHelpMan getblockstats()
 
 namespace {
 //! Search for a given set of pubkey scripts
-bool FindScriptPubKey(std::atomic<int>& scan_progress, const std::atomic<bool>& should_abort, int64_t& count, CCoinsViewCursor* cursor, const std::set<CScript>& needles, std::map<COutPoint, Coin>& out_results, std::function<void()>& interruption_point)
+bool FindScriptPubKey(std::atomic<int>& scan_progress, const std::atomic<bool>& should_abort, int64_t& count, const std::vector<std::unique_ptr<CCoinsViewCursor>>& cursors, const std::set<CScript>& needles, std::map<COutPoint, Coin>& out_results, std::function<void()>& interruption_point)
 {
     scan_progress = 0;
     count = 0;
-    while (cursor->Valid()) {
-        COutPoint key;
-        Coin coin;
-        if (!cursor->GetKey(key) || !cursor->GetValue(coin)) return false;
-        if (++count % 8192 == 0) {
-            interruption_point();
-            if (should_abort) {
-                // allow to abort the scan via the abort reference
-                return false;
+    // Each cursor scans its own range of txids on its own thread. The progress
+    // is the part of the txid space, in units of its first two bytes, that the
+    // cursors have moved past together.
+    std::atomic<uint32_t> scanned{0};
+    std::vector<int64_t> counts(cursors.size());
+    std::vector<std::map<COutPoint, Coin>> results(cursors.size());
+    std::vector<std::future<bool>> finished;
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        finished.push_back(std::async(std::launch::async, [&, i] {
+            CCoinsViewCursor& cursor{*cursors[i]};
+            std::optional<uint32_t> last_high;
+            while (cursor.Valid()) {
+                COutPoint key;
+                Coin coin;
+                if (!cursor.GetKey(key) || !cursor.GetValue(coin)) return false;
+                if (!last_high) last_high = 0x100 * *key.hash.begin() + *(key.hash.begin() + 1);
+                if (++counts[i] % 8192 == 0) {
+                    interruption_point();
+                    if (should_abort) {
+                        // allow to abort the scan via the abort reference
+                        return false;
+                    }
+                }
+                if (counts[i] % 256 == 0) {
+                    // update progress reference every 256 item
+                    uint32_t high = 0x100 * *key.hash.begin() + *(key.hash.begin() + 1);
+                    scanned += high - *last_high;
+                    last_high = high;
+                    scan_progress = (int)(scanned * 100.0 / 65536.0 + 0.5);
+                }
+                if (needles.count(coin.out.scriptPubKey)) {
+                    results[i].emplace(key, coin);
+                }
+                cursor.Next();
             }
-        }
-        if (count % 256 == 0) {
-            // update progress reference every 256 item
-            uint32_t high = 0x100 * *key.hash.begin() + *(key.hash.begin() + 1);
-            scan_progress = (int)(high * 100.0 / 65536.0 + 0.5);
-        }
-        if (needles.count(coin.out.scriptPubKey)) {
-            out_results.emplace(key, coin);
-        }
-        cursor->Next();
+            return true;
+        }));
+    }
+    bool success{true};
+    for (auto& range_finished : finished) {
+        success &= range_finished.get();
     }
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        count += counts[i];
+        out_results.merge(results[i]);
+    }
+    if (!success) return false;
     scan_progress = 100;
     return true;
 }
@@ -2142,7 +2432,7 @@ static RPCHelpMan scantxoutset()
         std::map<COutPoint, Coin> coins;
         g_should_abort_scan = false;
         int64_t count = 0;
-        std::unique_ptr<CCoinsViewCursor> pcursor;
+        std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
         const CBlockIndex* tip;
         NodeContext& node = EnsureAnyNodeContext(request.context);
         {
@@ -2150,10 +2440,11 @@ static RPCHelpMan scantxoutset()
             LOCK(cs_main);
             Chainstate& active_chainstate = chainman.ActiveChainstate();
             active_chainstate.ForceFlushStateToDisk();
-            pcursor = CHECK_NONFATAL(active_chainstate.CoinsDB().Cursor());
+            cursors = active_chainstate.CoinsDB().Cursors(kernel::GetCoinsScanRanges());
+            CHECK_NONFATAL(!cursors.empty());
             tip = CHECK_NONFATAL(active_chainstate.m_chain.Tip());
         }
-        bool res = FindScriptPubKey(g_scan_progress, g_should_abort_scan, count, pcursor.get(), needles, coins, node.rpc_interruption_point);
+        bool res = FindScriptPubKey(g_scan_progress, g_should_abort_scan, count, cursors, needles, coins, node.rpc_interruption_point);
         result.pushKV("success", res);
         result.pushKV("txouts", count);
         result.pushKV("height", tip->nHeight);
@@ -2265,6 +2556,425 @@ static RPCHelpMan getblockfilter()
     };
 }
 
+UniValue AddressHistoryToJSON(const std::vector<AddressHistoryEntry>& entries, size_t count)
+{
+    UniValue result(UniValue::VOBJ);
+    UniValue history(UniValue::VARR);
+    for (size_t i = 0; i < std::min(entries.size(), count); ++i) {
+        const AddressHistoryEntry& entry{entries[i]};
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("txid", entry.txid.GetHex());
+        obj.pushKV("height", entry.pos.height);
+        if (entry.pos.is_output) {
+            obj.pushKV("vout", (uint64_t)entry.pos.index);
+        } else {
+            obj.pushKV("vin", (uint64_t)entry.pos.index);
+            obj.pushKV("prevout_txid", entry.prevout.hash.GetHex());
+            obj.pushKV("prevout_vout", (uint64_t)entry.prevout.n);
+        }
+        obj.pushKV("amount", ValueFromAmount(entry.amount));
+        history.push_back(obj);
+    }
+    result.pushKV("history", history);
+    if (entries.size() > count) result.pushKV("next", entries[count].pos.ToString());
+    return result;
+}
+
+UniValue AddressUnspentToJSON(const std::vector<AddressUnspentEntry>& entries, size_t count)
+{
+    UniValue result(UniValue::VOBJ);
+    UniValue unspents(UniValue::VARR);
+    for (size_t i = 0; i < std::min(entries.size(), count); ++i) {
+        const AddressUnspentEntry& entry{entries[i]};
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("txid", entry.outpoint.hash.GetHex());
+        obj.pushKV("vout", (uint64_t)entry.outpoint.n);
+        obj.pushKV("height", entry.height);
+        obj.pushKV("amount", ValueFromAmount(entry.amount));
+        unspents.push_back(obj);
+    }
+    result.pushKV("unspents", unspents);
+    if (entries.size() > count) {
+        result.pushKV("next", strprintf("%s:%u", entries[count].outpoint.hash.GetHex(), entries[count].outpoint.n));
+    }
+    return result;
+}
+
+std::optional<COutPoint> ParseAddressUnspentCursor(const std::string& cursor)
+{
+    const std::vector<std::string> parts{SplitString(cursor, ':')};
+    uint256 txid;
+    if (parts.size() != 2 || !ParseHashStr(parts[0], txid)) return std::nullopt;
+    const auto n{ToIntegral<uint32_t>(parts[1])};
+    if (!n) return std::nullopt;
+    return COutPoint{txid, *n};
+}
+
+/** Parse the common arguments of getaddresshistory and getaddressutxos and wait for the address index. */
+static CScript ParseAddressQuery(const JSONRPCRequest& request, size_t& count)
+{
+    if (!g_address_index) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Address index is not enabled. Restart with -addressindex.");
+    }
+    const CTxDestination dest{DecodeDestination(request.params[0].get_str())};
+    if (!IsValidDestination(dest)) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
+    }
+    count = DEFAULT_ADDRESS_INDEX_RESULTS;
+    if (!request.params[1].isNull()) {
+        const int raw_count{request.params[1].getInt<int>()};
+        if (raw_count < 1 || raw_count > int(MAX_ADDRESS_INDEX_RESULTS)) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("count must be between 1 and %u", MAX_ADDRESS_INDEX_RESULTS));
+        }
+        count = raw_count;
+    }
+    if (!g_address_index->BlockUntilSyncedToCurrentChain()) {
+        throw JSONRPCError(RPC_MISC_ERROR, strprintf("Address index is still syncing. Current height: %d", g_address_index->GetSummary().best_block_height));
+    }
+    return GetScriptForDestination(dest);
+}
+
+static RPCHelpMan getaddresshistory()
+{
+    return RPCHelpMan{"getaddresshistory",
+                "\nReturn the transaction inputs and outputs of the active chain that spend from or pay to an address, in chain order.\n"
+                "Requires -addressindex. Long histories are returned in pages: pass the \"next\" value of a result as cursor to get the following page.\n",
+                {
+                    {"address", RPCArg::Type::STR, RPCArg::Optional::NO, "The address"},
+                    {"count", RPCArg::Type::NUM, RPCArg::Default{int(DEFAULT_ADDRESS_INDEX_RESULTS)}, strprintf("The maximum number of entries to return (1 to %u)", MAX_ADDRESS_INDEX_RESULTS)},
+                    {"cursor", RPCArg::Type::STR, RPCArg::DefaultHint{"the start of the history"}, "The \"next\" value of a previous result"},
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::ARR, "history", "",
+                        {
+                            {RPCResult::Type::OBJ, "", "",
+                            {
+                                {RPCResult::Type::STR_HEX, "txid", "The transaction id"},
+                                {RPCResult::Type::NUM, "height", "The height of the block containing the transaction"},
+                                {RPCResult::Type::NUM, "vout", /*optional=*/true, "The index of the output paying to the address (outputs only)"},
+                                {RPCResult::Type::NUM, "vin", /*optional=*/true, "The index of the input spending from the address (inputs only)"},
+                                {RPCResult::Type::STR_HEX, "prevout_txid", /*optional=*/true, "The transaction id of the output spent by the input (inputs only)"},
+                                {RPCResult::Type::NUM, "prevout_vout", /*optional=*/true, "The index of the output spent by the input (inputs only)"},
+                                {RPCResult::Type::STR_AMOUNT, "amount", "The amount received or spent in " + CURRENCY_UNIT},
+                            }},
+                        }},
+                        {RPCResult::Type::STR, "next", /*optional=*/true, "The cursor of the next page, if there are more entries"},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getaddresshistory", "\"" + EXAMPLE_ADDRESS[0] + "\"") +
+                    HelpExampleCli("getaddresshistory", "\"" + EXAMPLE_ADDRESS[0] + "\" 100 \"120:1:out:0\"") +
+                    HelpExampleRpc("getaddresshistory", "\"" + EXAMPLE_ADDRESS[0] + "\", 100")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    size_t count;
+    const CScript script{ParseAddressQuery(request, count)};
+    AddressHistoryPosition start;
+    if (!request.params[2].isNull()) {
+        const auto cursor{AddressHistoryPosition::FromString(request.params[2].get_str())};
+        if (!cursor) throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+        start = *cursor;
+    }
+
+    std::vector<AddressHistoryEntry> entries;
+    if (!g_address_index->FindHistory(script, start, count + 1, entries)) {
+        throw JSONRPCError(RPC_DATABASE_ERROR, "Unable to read the address index");
+    }
+    return AddressHistoryToJSON(entries, count);
+},
+    };
+}
+
+static RPCHelpMan getaddressutxos()
+{
+    return RPCHelpMan{"getaddressutxos",
+                "\nReturn the unspent outputs of the active chain that pay to an address, ordered by outpoint.\n"
+                "Requires -addressindex. Outputs spent by mempool transactions are included. Many outputs are returned in pages:\n"
+                "pass the \"next\" value of a result as cursor to get the following page.\n",
+                {
+                    {"address", RPCArg::Type::STR, RPCArg::Optional::NO, "The address"},
+                    {"count", RPCArg::Type::NUM, RPCArg::Default{int(DEFAULT_ADDRESS_INDEX_RESULTS)}, strprintf("The maximum number of outputs to return (1 to %u)", MAX_ADDRESS_INDEX_RESULTS)},
+                    {"cursor", RPCArg::Type::STR, RPCArg::DefaultHint{"the first output"}, "The \"next\" value of a previous result"},
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::ARR, "unspents", "",
+                        {
+                            {RPCResult::Type::OBJ, "", "",
+                            {
+                                {RPCResult::Type::STR_HEX, "txid", "The transaction id"},
+                                {RPCResult::Type::NUM, "vout", "The output index"},
+                                {RPCResult::Type::NUM, "height", "The height of the block containing the transaction"},
+                                {RPCResult::Type::STR_AMOUNT, "amount", "The amount in " + CURRENCY_UNIT},
+                            }},
+                        }},
+                        {RPCResult::Type::STR, "next", /*optional=*/true, "The cursor of the next page, if there are more outputs"},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getaddressutxos", "\"" + EXAMPLE_ADDRESS[0] + "\"") +
+                    HelpExampleRpc("getaddressutxos", "\"" + EXAMPLE_ADDRESS[0] + "\", 100")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    size_t count;
+    const CScript script{ParseAddressQuery(request, count)};
+    COutPoint start;
+    if (!request.params[2].isNull()) {
+        const auto cursor{ParseAddressUnspentCursor(request.params[2].get_str())};
+        if (!cursor) throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+        start = *cursor;
+    }
+
+    std::vector<AddressUnspentEntry> entries;
+    if (!g_address_index->FindUnspent(script, start, count + 1, entries)) {
+        throw JSONRPCError(RPC_DATABASE_ERROR, "Unable to read the address index");
+    }
+    return AddressUnspentToJSON(entries, count);
+},
+    };
+}
+
+/** RAII object to prevent concurrency issue when scanning block filters */
+static std::atomic<int> g_scanfilter_progress;
+static std::atomic<int> g_scanfilter_progress_height;
+static std::atomic<bool> g_scanfilter_in_progress;
+static std::atomic<bool> g_scanfilter_should_abort_scan;
+class BlockFiltersScanReserver
+{
+private:
+    bool m_could_reserve{false};
+public:
+    explicit BlockFiltersScanReserver() = default;
+
+    bool reserve() {
+        CHECK_NONFATAL(!m_could_reserve);
+        if (g_scanfilter_in_progress.exchange(true)) {
+            return false;
+        }
+        m_could_reserve = true;
+        return true;
+    }
+
+    ~BlockFiltersScanReserver() {
+        if (m_could_reserve) {
+            g_scanfilter_in_progress = false;
+        }
+    }
+};
+
+/** Number of block filters looked up from the index at a time by scanblocks. */
+static constexpr int SCANBLOCKS_FILTERS_PER_LOOKUP{10000};
+
+/** Don't start a separate matching task for fewer filters than this. */
+static constexpr size_t SCANBLOCKS_MIN_FILTERS_PER_TASK{500};
+
+/** Match every filter against the needles, spreading the filters over up to
+ *  one task per core. Returns whether each filter matched, in order. */
+static std::vector<uint8_t> MatchFilters(const std::vector<BlockFilter>& filters, const GCSFilter::ElementSet& needles)
+{
+    std::vector<uint8_t> matches(filters.size());
+    if (filters.empty()) return matches;
+
+    const auto match_range{[&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            matches[i] = filters[i].GetFilter().MatchAny(needles);
+        }
+    }};
+    const size_t max_tasks{(filters.size() + SCANBLOCKS_MIN_FILTERS_PER_TASK - 1) / SCANBLOCKS_MIN_FILTERS_PER_TASK};
+    const size_t num_tasks{std::clamp<size_t>(GetNumCores(), 1, max_tasks)};
+    const size_t filters_per_task{(filters.size() + num_tasks - 1) / num_tasks};
+
+    std::vector<std::future<void>> tasks;
+    for (size_t begin = filters_per_task; begin < filters.size(); begin += filters_per_task) {
+        tasks.push_back(std::async(std::launch::async, match_range, begin, std::min(begin + filters_per_task, filters.size())));
+    }
+    match_range(0, std::min(filters_per_task, filters.size()));
+    for (auto& task : tasks) {
+        task.get();
+    }
+    return matches;
+}
+
+static RPCHelpMan scanblocks()
+{
+    return RPCHelpMan{"scanblocks",
+        "\nReturn relevant blockhashes for given descriptors.\n"
+        "Matches the scriptPubKeys derived from the descriptors against the BIP 157 block filters of the\n"
+        "requested range of the active chain, which requires -blockfilterindex. As block filters are\n"
+        "probabilistic, a small number of returned blocks may not actually be relevant.\n"
+        "This call may take several minutes. Make sure to use no RPC timeout (bitcoin-cli -rpcclienttimeout=0)",
+        {
+            {"action", RPCArg::Type::STR, RPCArg::Optional::NO, "The action to execute\n"
+                "\"start\" for starting a scan\n"
+                "\"abort\" for aborting the current scan (returns true when abort was successful)\n"
+                "\"status\" for progress report (in %) of the current scan"},
+            {"scanobjects", RPCArg::Type::ARR, RPCArg::Optional::OMITTED, "Array of scan objects. Required for \"start\" action\n"
+                "Every scan object is either a string descriptor or an object:",
+            {
+                {"descriptor", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "An output descriptor"},
+                {"", RPCArg::Type::OBJ, RPCArg::Optional::OMITTED, "An object with output descriptor and metadata",
+                {
+                    {"desc", RPCArg::Type::STR, RPCArg::Optional::NO, "An output descriptor"},
+                    {"range", RPCArg::Type::RANGE, RPCArg::Default{1000}, "The range of HD chain indexes to explore (either end or [begin,end])"},
+                }},
+            },
+            RPCArgOptions{.oneline_description="[scanobjects,...]"}},
+            {"start_height", RPCArg::Type::NUM, RPCArg::Default{0}, "Height to start to scan from"},
+            {"stop_height", RPCArg::Type::NUM, RPCArg::DefaultHint{"chain tip"}, "Height to stop to scan"},
+            {"filtertype", RPCArg::Type::STR, RPCArg::Default{BlockFilterTypeName(BlockFilterType::BASIC)}, "The type name of the filter"},
+        },
+        {
+            RPCResult{"when action=='start'; only returns after scan completes", RPCResult::Type::OBJ, "", "", {
+                {RPCResult::Type::NUM, "from_height", "The height we started the scan from"},
+                {RPCResult::Type::NUM, "to_height", "The height we ended the scan at"},
+                {RPCResult::Type::ARR, "relevant_blocks", "Blocks that may have matched a scanobject.",
+                {
+                    {RPCResult::Type::STR_HEX, "blockhash", "A relevant blockhash"},
+                }},
+                {RPCResult::Type::BOOL, "completed", "true if the scan process was not aborted"},
+            }},
+            RPCResult{"when action=='abort'", RPCResult::Type::BOOL, "success", "True if scan will be aborted (not necessarily before this RPC returns), or false if there is no scan to abort"},
+            RPCResult{"when action=='status' and a scan is currently in progress", RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::NUM, "progress", "Approximate percent complete"},
+                {RPCResult::Type::NUM, "current_height", "Height of the block currently being scanned"},
+            }},
+            RPCResult{"when action=='status' and no scan is in progress - possibly already completed", RPCResult::Type::NONE, "", ""},
+        },
+        RPCExamples{
+            HelpExampleCli("scanblocks", "start '[\"addr(bcrt1q4u4nsgk6ug0sqz7r3rj9tykjxrsl0yy4d0wwte)\"]' 300000") +
+            HelpExampleCli("scanblocks", "start '[\"addr(bcrt1q4u4nsgk6ug0sqz7r3rj9tykjxrsl0yy4d0wwte)\"]' 100 150 basic") +
+            HelpExampleCli("scanblocks", "status") +
+            HelpExampleRpc("scanblocks", "\"start\", [\"addr(bcrt1q4u4nsgk6ug0sqz7r3rj9tykjxrsl0yy4d0wwte)\"], 300000") +
+            HelpExampleRpc("scanblocks", "\"start\", [\"addr(bcrt1q4u4nsgk6ug0sqz7r3rj9tykjxrsl0yy4d0wwte)\"], 100, 150, \"basic\"") +
+            HelpExampleRpc("scanblocks", "\"status\"")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    UniValue ret(UniValue::VOBJ);
+    if (request.params[0].get_str() == "status") {
+        BlockFiltersScanReserver reserver;
+        if (reserver.reserve()) {
+            // no scan in progress
+            return UniValue::VNULL;
+        }
+        ret.pushKV("progress", g_scanfilter_progress.load());
+        ret.pushKV("current_height", g_scanfilter_progress_height.load());
+        return ret;
+    } else if (request.params[0].get_str() == "abort") {
+        BlockFiltersScanReserver reserver;
+        if (reserver.reserve()) {
+            // reserve was possible which means no scan was running
+            return false;
+        }
+        // set the abort flag
+        g_scanfilter_should_abort_scan = true;
+        return true;
+    } else if (request.params[0].get_str() == "start") {
+        BlockFiltersScanReserver reserver;
+        if (!reserver.reserve()) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Scan already in progress, use action \"abort\" or \"status\"");
+        }
+
+        if (request.params[1].isNull()) {
+            throw JSONRPCError(RPC_MISC_ERROR, "scanobjects argument is required for the start action");
+        }
+
+        const std::string filtertype_name{request.params[4].isNull() ? BlockFilterTypeName(BlockFilterType::BASIC) : request.params[4].get_str()};
+        BlockFilterType filtertype;
+        if (!BlockFilterTypeByName(filtertype_name, filtertype)) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown filtertype");
+        }
+
+        BlockFilterIndex* index = GetBlockFilterIndex(filtertype);
+        if (!index) {
+            throw JSONRPCError(RPC_MISC_ERROR, "Index is not enabled for filtertype " + filtertype_name);
+        }
+        if (!index->BlockUntilSyncedToCurrentChain()) {
+            throw JSONRPCError(RPC_MISC_ERROR, "Block filters are still in the process of being indexed.");
+        }
+
+        NodeContext& node = EnsureAnyNodeContext(request.context);
+        ChainstateManager& chainman = EnsureChainman(node);
+
+        const CBlockIndex* start_index;
+        const CBlockIndex* stop_index;
+        {
+            LOCK(cs_main);
+            CChain& active_chain = chainman.ActiveChain();
+            start_index = active_chain.Genesis();
+            stop_index = active_chain.Tip();
+            if (!request.params[2].isNull()) {
+                start_index = active_chain[request.params[2].getInt<int>()];
+                if (!start_index) {
+                    throw JSONRPCError(RPC_MISC_ERROR, "Invalid start_height");
+                }
+            }
+            if (!request.params[3].isNull()) {
+                stop_index = active_chain[request.params[3].getInt<int>()];
+                if (!stop_index || stop_index->nHeight < start_index->nHeight) {
+                    throw JSONRPCError(RPC_MISC_ERROR, "Invalid stop_height");
+                }
+            }
+        }
+
+        // loop through the scan objects, adding their scripts to the needles
+        GCSFilter::ElementSet needles;
+        for (const UniValue& scanobject : request.params[1].get_array().getValues()) {
+            FlatSigningProvider provider;
+            for (const CScript& script : EvalDescriptorStringOrObject(scanobject, provider)) {
+                needles.emplace(script.begin(), script.end());
+            }
+        }
+
+        const int from_height{start_index->nHeight};
+        const int total_blocks{stop_index->nHeight - from_height + 1};
+        g_scanfilter_should_abort_scan = false;
+        g_scanfilter_progress = 0;
+        g_scanfilter_progress_height = from_height;
+
+        UniValue blocks(UniValue::VARR);
+        std::vector<BlockFilter> filters;
+        int next_height{from_height};
+        bool completed{true};
+        while (next_height <= stop_index->nHeight) {
+            node.rpc_interruption_point(); // allow a clean shutdown
+            if (g_scanfilter_should_abort_scan) {
+                completed = false;
+                break;
+            }
+
+            // Look up the filters in chunks, to bound memory usage and report progress
+            const int chunk_stop_height{std::min(next_height + SCANBLOCKS_FILTERS_PER_LOOKUP - 1, stop_index->nHeight)};
+            const CBlockIndex* chunk_stop_index{stop_index->GetAncestor(chunk_stop_height)};
+            if (!index->LookupFilterRange(next_height, chunk_stop_index, filters)) {
+                throw JSONRPCError(RPC_INTERNAL_ERROR, strprintf("Failed to read block filters for heights %d to %d", next_height, chunk_stop_height));
+            }
+            const std::vector<uint8_t> matches{MatchFilters(filters, needles)};
+            for (size_t i = 0; i < filters.size(); ++i) {
+                if (matches[i]) blocks.push_back(filters[i].GetBlockHash().GetHex());
+            }
+
+            next_height = chunk_stop_height + 1;
+            g_scanfilter_progress = (next_height - from_height) * 100 / total_blocks;
+            g_scanfilter_progress_height = chunk_stop_height;
+        }
+
+        ret.pushKV("from_height", from_height);
+        ret.pushKV("to_height", next_height - 1);
+        ret.pushKV("relevant_blocks", blocks);
+        ret.pushKV("completed", completed);
+    } else {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Invalid action '%s'", request.params[0].get_str()));
+    }
+    return ret;
+},
+    };
+}
+
 /**
  * Serialize the UTXO set to a file for loading elsewhere.
  *
@@ -2326,6 +3036,39 @@ static RPCHelpMan dumptxoutset()
     };
 }
 
+//! Write the coins returned by the cursor to a UTXO snapshot file, grouped by txid.
+static void WriteSnapshotCoins(CCoinsViewCursor& cursor, AutoFile& afile, const std::function<void()>& interruption_point)
+{
+    uint256 last_hash;
+    std::vector<std::pair<uint32_t, Coin>> coins;
+    const auto write_coins = [&] {
+        afile << last_hash;
+        WriteCompactSize(afile, coins.size());
+        for (const auto& [n, coin] : coins) {
+            afile << VARINT(n);
+            afile << coin;
+        }
+        coins.clear();
+    };
+
+    COutPoint key;
+    Coin coin;
+    unsigned int iter{0};
+
+    while (cursor.Valid()) {
+        if (iter % 5000 == 0) interruption_point();
+        ++iter;
+        if (cursor.GetKey(key) && cursor.GetValue(coin)) {
+            if (!coins.empty() && key.hash != last_hash) write_coins();
+            last_hash = key.hash;
+            coins.emplace_back(key.n, std::move(coin));
+        }
+
+        cursor.Next();
+    }
+    if (!coins.empty()) write_coins();
+}
+
 UniValue CreateUTXOSnapshot(
     NodeContext& node,
     Chainstate& chainstate,
@@ -2333,7 +3076,7 @@ UniValue CreateUTXOSnapshot(
     const fs::path& path,
     const fs::path& temppath)
 {
-    std::unique_ptr<CCoinsViewCursor> pcursor;
+    std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
     std::optional<CCoinsStats> maybe_stats;
     const CBlockIndex* tip;
 
@@ -2359,7 +3102,8 @@ UniValue CreateUTXOSnapshot(
             throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read UTXO set");
         }
 
-        pcursor = chainstate.CoinsDB().Cursor();
+        cursors = chainstate.CoinsDB().Cursors(kernel::GetCoinsScanRanges());
+        CHECK_NONFATAL(!cursors.empty());
         tip = CHECK_NONFATAL(chainstate.m_blockman.LookupBlockIndex(maybe_stats->hashBlock));
     }
 
@@ -2371,19 +3115,47 @@ UniValue CreateUTXOSnapshot(
 
     afile << metadata;
 
-    COutPoint key;
-    Coin coin;
-    unsigned int iter{0};
-
-    while (pcursor->Valid()) {
-        if (iter % 5000 == 0) node.rpc_interruption_point();
-        ++iter;
-        if (pcursor->GetKey(key) && pcursor->GetValue(coin)) {
-            afile << key;
-            afile << coin;
+    if (cursors.size() == 1) {
+        WriteSnapshotCoins(*cursors.front(), afile, node.rpc_interruption_point);
+    } else {
+        // Serialize each range of coins on its own thread into a part file next
+        // to temppath, then append the parts in order, so that the snapshot is
+        // the same however many ranges were used.
+        std::vector<fs::path> part_paths;
+        for (size_t i = 0; i < cursors.size(); ++i) {
+            part_paths.push_back(fs::PathFromString(fs::PathToString(temppath) + strprintf(".part%u", i)));
         }
+        try {
+            std::vector<std::future<void>> written;
+            for (size_t i = 0; i < cursors.size(); ++i) {
+                written.push_back(std::async(std::launch::async, [&, i] {
+                    AutoFile part{fsbridge::fopen(part_paths[i], "wb")};
+                    if (part.IsNull()) {
+                        throw JSONRPCError(RPC_INVALID_PARAMETER, "Couldn't open file " + fs::PathToString(part_paths[i]) + " for writing.");
+                    }
+                    WriteSnapshotCoins(*cursors[i], part, node.rpc_interruption_point);
+                }));
+            }
+            for (auto& range_written : written) {
+                range_written.get();
+            }
 
-        pcursor->Next();
+            std::vector<std::byte> buf(1 << 20);
+            for (const fs::path& part_path : part_paths) {
+                AutoFile part{fsbridge::fopen(part_path, "rb")};
+                while (size_t read = std::fread(buf.data(), 1, buf.size(), part.Get())) {
+                    afile.write(Span{buf}.first(read));
+                }
+                part.fclose();
+                fs::remove(part_path);
+            }
+        } catch (...) {
+            for (const fs::path& part_path : part_paths) {
+                std::error_code ec;
+                fs::remove(part_path, ec);
+            }
+            throw;
+        }
     }
 
     afile.fclose();
@@ -2400,6 +3172,79 @@ UniValue CreateUTXOSnapshot(
     return result;
 }
 
+static RPCHelpMan loadtxoutset()
+{
+    return RPCHelpMan{
+        "loadtxoutset",
+        "Load the serialized UTXO set from a file written by dumptxoutset.\n"
+        "The snapshot's base block header must be in the headers chain, the active chain must not have reached it yet, "
+        "and its UTXO set hash must match the assumeutxo value known for its height.\n"
+        "Once loaded, the node follows the tip from the snapshot's base block.\n"
+        "The snapshot chainstate is not restored after a restart yet.",
+        {
+            {"path", RPCArg::Type::STR, RPCArg::Optional::NO, "Path to the snapshot file. If relative, will be prefixed by datadir."},
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+                {
+                    {RPCResult::Type::NUM, "coins_loaded", "the number of coins loaded from the snapshot"},
+                    {RPCResult::Type::STR_HEX, "tip_hash", "the hash of the base of the snapshot"},
+                    {RPCResult::Type::NUM, "base_height", "the height of the base of the snapshot"},
+                    {RPCResult::Type::STR, "path", "the absolute path that the snapshot was loaded from"},
+                }
+        },
+        RPCExamples{
+            HelpExampleCli("loadtxoutset", "utxo.dat")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    NodeContext& node = EnsureAnyNodeContext(request.context);
+    ChainstateManager& chainman = EnsureChainman(node);
+    const ArgsManager& args{EnsureArgsman(node)};
+    const fs::path path{fsbridge::AbsPathJoin(args.GetDataDirNet(), fs::u8path(request.params[0].get_str()))};
+
+    FILE* file{fsbridge::fopen(path, "rb")};
+    AutoFile afile{file};
+    if (afile.IsNull()) {
+        throw JSONRPCError(
+            RPC_INVALID_PARAMETER,
+            "Couldn't open file " + path.u8string() + " for reading.");
+    }
+
+    SnapshotMetadata metadata;
+    try {
+        afile >> metadata;
+    } catch (const std::ios_base::failure& e) {
+        throw JSONRPCError(RPC_DESERIALIZATION_ERROR, strprintf("Unable to parse snapshot metadata: %s", e.what()));
+    }
+
+    {
+        LOCK(::cs_main);
+        const CBlockIndex* base_index{chainman.m_blockman.LookupBlockIndex(metadata.m_base_blockhash)};
+        if (!base_index) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY,
+                strprintf("The base block header (%s) must appear in the headers chain", metadata.m_base_blockhash.ToString()));
+        }
+        if (chainman.ActiveHeight() >= base_index->nHeight) {
+            throw JSONRPCError(RPC_MISC_ERROR, "The active chain is already at or past the snapshot's base block");
+        }
+    }
+
+    if (!chainman.ActivateSnapshot(afile, metadata, /*in_memory=*/false)) {
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to load UTXO snapshot " + path.u8string() + ", see debug.log for details");
+    }
+    const CBlockIndex& snapshot_index{*CHECK_NONFATAL(WITH_LOCK(::cs_main, return chainman.ActiveTip()))};
+
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("coins_loaded", metadata.m_coins_count);
+    result.pushKV("tip_hash", snapshot_index.GetBlockHash().ToString());
+    result.pushKV("base_height", snapshot_index.nHeight);
+    result.pushKV("path", path.u8string());
+    return result;
+},
+    };
+}
+
 void RegisterBlockchainRPCCommands(CRPCTable& t)
 {
     static const CRPCCommand commands[]{
@@ -2413,15 +3258,21 @@ void RegisterBlockchainRPCCommands(CRPCTable& t)
         {"blockchain", &getblockhash},
         {"blockchain", &getblockheader},
         {"blockchain", &getchaintips},
+        {"blockchain", &getchainstates},
         {"blockchain", &getdifficulty},
         {"blockchain", &getdeploymentinfo},
         {"blockchain", &gettxout},
         {"blockchain", &gettxoutsetinfo},
         {"blockchain", &pruneblockchain},
+        {"blockchain", &getpruneplan},
         {"blockchain", &verifychain},
+        {"blockchain", &getverifychaininfo},
         {"blockchain", &preciousblock},
         {"blockchain", &scantxoutset},
         {"blockchain", &getblockfilter},
+        {"blockchain", &getaddresshistory},
+        {"blockchain", &getaddressutxos},
+        {"blockchain", &scanblocks},
         {"hidden", &invalidateblock},
         {"hidden", &reconsiderblock},
         {"hidden", &waitfornewblock},
@@ -2429,6 +3280,7 @@ void RegisterBlockchainRPCCommands(CRPCTable& t)
         {"hidden", &waitforblockheight},
         {"hidden", &syncwithvalidationinterfacequeue},
         {"hidden", &dumptxoutset},
+        {"hidden", &loadtxoutset},
     };
     for (const auto& c : commands) {
         t.appendCommand(c.name, &c);
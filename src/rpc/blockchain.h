@@ -13,7 +13,9 @@
 #include <validation.h>
 
 #include <any>
+#include <optional>
 #include <stdint.h>
+#include <string>
 #include <vector>
 
 extern RecursiveMutex cs_main;
@@ -21,12 +23,18 @@ extern RecursiveMutex cs_main;
 class CBlock;
 class CBlockIndex;
 class Chainstate;
+class COutPoint;
 class UniValue;
+struct AddressHistoryEntry;
+struct AddressUnspentEntry;
 namespace node {
 struct NodeContext;
 } // namespace node
 
 static constexpr int NUM_GETBLOCKSTATS_PERCENTILES = 5;
+//! Default and maximum number of entries returned by one address index query
+static constexpr size_t DEFAULT_ADDRESS_INDEX_RESULTS{1000};
+static constexpr size_t MAX_ADDRESS_INDEX_RESULTS{10000};
 
 /**
  * Get the difficulty of the net wrt to the given block index.
@@ -48,6 +56,13 @@ UniValue blockheaderToJSON(const CBlockIndex* tip, const CBlockIndex* blockindex
 /** Used by getblockstats to get feerates at different percentiles by weight  */
 void CalculatePercentilesByWeight(CAmount result[NUM_GETBLOCKSTATS_PERCENTILES], std::vector<std::pair<CAmount, int64_t>>& scores, int64_t total_weight);
 
+/** Address history and unspent outputs to JSON. The entry following the first count entries, if any, is returned as the cursor of the next page. */
+UniValue AddressHistoryToJSON(const std::vector<AddressHistoryEntry>& entries, size_t count);
+UniValue AddressUnspentToJSON(const std::vector<AddressUnspentEntry>& entries, size_t count);
+
+/** Parse the cursor of a page of unspent outputs, "<txid>:<vout>". */
+std::optional<COutPoint> ParseAddressUnspentCursor(const std::string& cursor);
+
 /**
  * Helper to create UTXO snapshots given a chainstate and a file handle.
  * @return a UniValue map containing metadata about the snapshot.
@@ -4,8 +4,10 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <chainparams.h>
+#include <dbwrapper.h>
 #include <httpserver.h>
 #include <index/blockfilterindex.h>
+#include <index/addressindex.h>
 #include <index/coinstatsindex.h>
 #include <index/txindex.h>
 #include <interfaces/chain.h>
@@ -19,9 +21,11 @@
 #include <scheduler.h>
 #include <univalue.h>
 #include <util/check.h>
+#include <util/strencodings.h>
 #include <util/syscall_sandbox.h>
 #include <util/system.h>
 
+#include <optional>
 #include <stdint.h>
 #ifdef HAVE_MALLOC_INFO
 #include <malloc.h>
@@ -361,7 +365,7 @@ static RPCHelpMan echoipc()
     };
 }
 
-static UniValue SummaryToJSON(const IndexSummary&& summary, std::string index_name)
+static UniValue SummaryToJSON(const IndexSummary&& summary, std::string index_name, const std::string& cache_name = "", const std::optional<IndexCacheStats>& cache_stats = std::nullopt)
 {
     UniValue ret_summary(UniValue::VOBJ);
     if (!index_name.empty() && index_name != summary.name) return ret_summary;
@@ -369,10 +373,31 @@ static UniValue SummaryToJSON(const IndexSummary&& summary, std::string index_na
     UniValue entry(UniValue::VOBJ);
     entry.pushKV("synced", summary.synced);
     entry.pushKV("best_block_height", summary.best_block_height);
+    if (cache_stats) {
+        const uint64_t lookups{cache_stats->hits + cache_stats->misses};
+        UniValue cache(UniValue::VOBJ);
+        cache.pushKV("entries", (uint64_t)cache_stats->entries);
+        cache.pushKV("usage", (uint64_t)cache_stats->usage);
+        cache.pushKV("hits", cache_stats->hits);
+        cache.pushKV("misses", cache_stats->misses);
+        cache.pushKV("hit_ratio", lookups > 0 ? double(cache_stats->hits) / lookups : 0.0);
+        entry.pushKV(cache_name, cache);
+    }
     ret_summary.pushKV(summary.name, entry);
     return ret_summary;
 }
 
+static std::vector<RPCResult> IndexCacheDoc(const std::string& items)
+{
+    return {
+        {RPCResult::Type::NUM, "entries", "The number of cached " + items},
+        {RPCResult::Type::NUM, "usage", "Approximate memory used by the cached " + items + ", in bytes"},
+        {RPCResult::Type::NUM, "hits", "The number of lookups served from the cache"},
+        {RPCResult::Type::NUM, "misses", "The number of lookups that had to read from disk"},
+        {RPCResult::Type::NUM, "hit_ratio", "The fraction of lookups served from the cache"},
+    };
+}
+
 static RPCHelpMan getindexinfo()
 {
     return RPCHelpMan{"getindexinfo",
@@ -387,6 +412,8 @@ static RPCHelpMan getindexinfo()
                             {
                                 {RPCResult::Type::BOOL, "synced", "Whether the index is synced or not"},
                                 {RPCResult::Type::NUM, "best_block_height", "The block height to which the index is synced"},
+                                {RPCResult::Type::OBJ, "tx_cache", /*optional=*/true, "Cache of recently looked up transactions (txindex only)", IndexCacheDoc("transactions")},
+                                {RPCResult::Type::OBJ, "filter_cache", /*optional=*/true, "Cache of recently served filters (block filter indexes only)", IndexCacheDoc("filters")},
                             }
                         },
                     },
@@ -403,15 +430,19 @@ static RPCHelpMan getindexinfo()
     const std::string index_name = request.params[0].isNull() ? "" : request.params[0].get_str();
 
     if (g_txindex) {
-        result.pushKVs(SummaryToJSON(g_txindex->GetSummary(), index_name));
+        result.pushKVs(SummaryToJSON(g_txindex->GetSummary(), index_name, "tx_cache", g_txindex->GetTxCacheStats()));
     }
 
     if (g_coin_stats_index) {
         result.pushKVs(SummaryToJSON(g_coin_stats_index->GetSummary(), index_name));
     }
 
+    if (g_address_index) {
+        result.pushKVs(SummaryToJSON(g_address_index->GetSummary(), index_name));
+    }
+
     ForEachBlockFilterIndex([&result, &index_name](const BlockFilterIndex& index) {
-        result.pushKVs(SummaryToJSON(index.GetSummary(), index_name));
+        result.pushKVs(SummaryToJSON(index.GetSummary(), index_name, "filter_cache", index.GetFilterCacheStats()));
     });
 
     return result;
@@ -419,11 +450,154 @@ static RPCHelpMan getindexinfo()
     };
 }
 
+static std::vector<RPCResult> CompactionStatusDoc()
+{
+    return {
+        {RPCResult::Type::BOOL, "running", "Whether the compaction is still running"},
+        {RPCResult::Type::STR_HEX, "begin", "The first key of the compacted range, empty if unbounded"},
+        {RPCResult::Type::STR_HEX, "end", "The last key of the compacted range, empty if unbounded"},
+        {RPCResult::Type::NUM_TIME, "start_time", "When the compaction started, expressed in " + UNIX_EPOCH_TIME},
+        {RPCResult::Type::NUM, "duration_ms", /*optional=*/true, "How long the compaction took, once it has finished"},
+    };
+}
+
+static UniValue CompactionStatusToJSON(const DBCompactionStatus& status)
+{
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("running", status.running);
+    ret.pushKV("begin", HexStr(status.begin));
+    ret.pushKV("end", HexStr(status.end));
+    ret.pushKV("start_time", status.start_time);
+    if (status.duration) ret.pushKV("duration_ms", count_milliseconds(*status.duration));
+    return ret;
+}
+
+static RPCHelpMan getdatabaseinfo()
+{
+    return RPCHelpMan{"getdatabaseinfo",
+                "\nReturns the LevelDB settings and statistics of one or all open databases.\n",
+                {
+                    {"name", RPCArg::Type::STR, RPCArg::Optional::OMITTED_NAMED_ARG, "Only return the database with this name, e.g. \"chainstate\"."},
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ_DYN, "", "", {
+                        {
+                            RPCResult::Type::OBJ, "name", "The database path relative to the data directory",
+                            {
+                                {RPCResult::Type::OBJ, "options", "The settings the database was opened with (see -dboption)",
+                                {
+                                    {RPCResult::Type::NUM, "blockcache", "Share of the database cache used as block cache, in percent"},
+                                    {RPCResult::Type::NUM, "writebuffer", "Share of the database cache used for each write buffer, in percent"},
+                                    {RPCResult::Type::NUM, "bloombits", "Bloom filter bits per key, 0 if disabled"},
+                                    {RPCResult::Type::NUM, "blocksize", "Size of the blocks of data read from disk, in bytes"},
+                                    {RPCResult::Type::NUM, "maxfilesize", "Size at which a new table file is started, in bytes"},
+                                    {RPCResult::Type::NUM, "maxopenfiles", "Maximum number of open table files, 0 for the platform default"},
+                                }},
+                                {RPCResult::Type::NUM, "memory_usage", "Approximate memory used by LevelDB, in bytes"},
+                                {RPCResult::Type::NUM, "approximate_size", "Approximate size of all keys on disk, in bytes"},
+                                {RPCResult::Type::ARR, "files_per_level", "Number of table files in each level",
+                                {
+                                    {RPCResult::Type::NUM, "", "Number of table files"},
+                                }},
+                                {RPCResult::Type::STR, "stats", "LevelDB's compaction statistics (leveldb.stats)"},
+                                {RPCResult::Type::OBJ, "compaction", /*optional=*/true, "The last compaction started with compactdatabase", CompactionStatusDoc()},
+                            }
+                        },
+                    },
+                },
+                RPCExamples{
+                    HelpExampleCli("getdatabaseinfo", "")
+                  + HelpExampleCli("getdatabaseinfo", "chainstate")
+                  + HelpExampleRpc("getdatabaseinfo", "\"chainstate\"")
+                },
+                [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const std::string name = request.params[0].isNull() ? "" : request.params[0].get_str();
+
+    UniValue result(UniValue::VOBJ);
+    ForEachDBWrapper([&](CDBWrapper& db) {
+        if (!name.empty() && name != db.GetName()) return;
+
+        const DBOptions& db_options{db.GetDBOptions()};
+        UniValue options(UniValue::VOBJ);
+        options.pushKV("blockcache", db_options.block_cache_percent);
+        options.pushKV("writebuffer", db_options.write_buffer_percent);
+        options.pushKV("bloombits", db_options.bloom_bits);
+        options.pushKV("blocksize", uint64_t(db_options.block_size));
+        options.pushKV("maxfilesize", uint64_t(db_options.max_file_size));
+        options.pushKV("maxopenfiles", db_options.max_open_files);
+
+        UniValue files_per_level(UniValue::VARR);
+        for (int level = 0;; ++level) {
+            const auto files{db.GetProperty(strprintf("leveldb.num-files-at-level%d", level))};
+            if (!files) break;
+            files_per_level.push_back(ToIntegral<int64_t>(*files).value_or(0));
+        }
+
+        UniValue info(UniValue::VOBJ);
+        info.pushKV("options", options);
+        info.pushKV("memory_usage", uint64_t(db.DynamicMemoryUsage()));
+        info.pushKV("approximate_size", uint64_t(db.EstimateRawSize({}, {})));
+        info.pushKV("files_per_level", files_per_level);
+        info.pushKV("stats", db.GetProperty("leveldb.stats").value_or(""));
+        if (const DBCompactionStatus compaction{db.GetCompactionStatus()}; compaction.start_time != 0) {
+            info.pushKV("compaction", CompactionStatusToJSON(compaction));
+        }
+        result.pushKV(db.GetName(), info);
+    });
+    if (!name.empty() && result.empty()) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("No open database named %s", name));
+    }
+    return result;
+},
+    };
+}
+
+static RPCHelpMan compactdatabase()
+{
+    return RPCHelpMan{"compactdatabase",
+                "\nStart compacting a range of keys of a database in the background, which reduces the number of table\n"
+                "files reads of those keys go through. Progress can be followed with getdatabaseinfo.\n",
+                {
+                    {"name", RPCArg::Type::STR, RPCArg::Optional::NO, "The database to compact, as named by getdatabaseinfo"},
+                    {"begin", RPCArg::Type::STR_HEX, RPCArg::Default{""}, "The first key of the range, empty to start at the first key"},
+                    {"end", RPCArg::Type::STR_HEX, RPCArg::Default{""}, "The last key of the range, empty to end at the last key"},
+                },
+                RPCResult{RPCResult::Type::OBJ, "", "The compaction that was started", CompactionStatusDoc()},
+                RPCExamples{
+                    HelpExampleCli("compactdatabase", "chainstate")
+                  + HelpExampleCli("compactdatabase", "chainstate 43 44")
+                  + HelpExampleRpc("compactdatabase", "\"chainstate\"")
+                },
+                [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const std::string name = request.params[0].get_str();
+    const std::vector<unsigned char> begin{request.params[1].isNull() ? std::vector<unsigned char>{} : ParseHexV(request.params[1], "begin")};
+    const std::vector<unsigned char> end{request.params[2].isNull() ? std::vector<unsigned char>{} : ParseHexV(request.params[2], "end")};
+
+    std::optional<DBCompactionStatus> status;
+    ForEachDBWrapper([&](CDBWrapper& db) {
+        if (db.GetName() != name) return;
+        if (!db.StartCompaction(begin, end)) {
+            throw JSONRPCError(RPC_MISC_ERROR, strprintf("A compaction of %s is already running", name));
+        }
+        status = db.GetCompactionStatus();
+    });
+    if (!status) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("No open database named %s", name));
+    }
+    return CompactionStatusToJSON(*status);
+},
+    };
+}
+
 void RegisterNodeRPCCommands(CRPCTable& t)
 {
     static const CRPCCommand commands[]{
         {"control", &getmemoryinfo},
         {"control", &logging},
+        {"control", &getdatabaseinfo},
+        {"control", &compactdatabase},
         {"util", &getindexinfo},
         {"hidden", &setmocktime},
         {"hidden", &mockscheduler},
@@ -274,6 +274,104 @@ static RPCHelpMan getrawtransaction()
     };
 }
 
+static RPCHelpMan getrawtransactions()
+{
+    return RPCHelpMan{
+                "getrawtransactions",
+                "Return the raw transaction data of many transactions.\n"
+
+                "\nLike getrawtransaction without a blockhash, but transactions in blocks are read in the order\n"
+                "they are stored on disk, so looking up many of them at once is faster than one call per transaction.\n"
+                "Transactions are returned if they are in the mempool, or in any block if -txindex is enabled.\n"
+
+                "\nIf verbose is 'true', returns Objects with information about each txid.\n"
+                "If verbose is 'false' or omitted, returns strings that are serialized, hex-encoded data.",
+                {
+                    {"txids", RPCArg::Type::ARR, RPCArg::Optional::NO, "The transaction ids",
+                        {
+                            {"txid", RPCArg::Type::STR_HEX, RPCArg::Optional::OMITTED, "A transaction id"},
+                        },
+                    },
+                    {"verbose", RPCArg::Type::BOOL, RPCArg::Default{false}, "If false, return strings, otherwise return json objects"},
+                },
+                {
+                    RPCResult{"if verbose is not set or set to false",
+                        RPCResult::Type::ARR, "", "The transactions in the order of the txids, null for those that are not found",
+                        {
+                            {RPCResult::Type::STR, "data", "The serialized, hex-encoded data for 'txid', or null if not found", {}, /*skip_type_check=*/true},
+                        }},
+                    RPCResult{"if verbose is set to true",
+                        RPCResult::Type::ARR, "", "The transactions in the order of the txids, null for those that are not found",
+                        {
+                            {RPCResult::Type::OBJ, "", "The transaction, or null if not found",
+                            Cat<std::vector<RPCResult>>(
+                            {
+                                {RPCResult::Type::STR_HEX, "blockhash", /*optional=*/true, "the block hash"},
+                                {RPCResult::Type::NUM, "confirmations", /*optional=*/true, "The confirmations"},
+                                {RPCResult::Type::NUM_TIME, "blocktime", /*optional=*/true, "The block time expressed in " + UNIX_EPOCH_TIME},
+                                {RPCResult::Type::NUM, "time", /*optional=*/true, "Same as \"blocktime\""},
+                                {RPCResult::Type::STR_HEX, "hex", "The serialized, hex-encoded data for 'txid'"},
+                            },
+                            DecodeTxDoc(/*txid_field_doc=*/"The transaction id (same as provided)")), /*skip_type_check=*/true},
+                        }},
+                    },
+                RPCExamples{
+                    HelpExampleCli("getrawtransactions", "'[\"mytxid\",\"myothertxid\"]'")
+            + HelpExampleCli("getrawtransactions", "'[\"mytxid\",\"myothertxid\"]' true")
+            + HelpExampleRpc("getrawtransactions", "[\"mytxid\",\"myothertxid\"], true")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const NodeContext& node = EnsureAnyNodeContext(request.context);
+    ChainstateManager& chainman = EnsureChainman(node);
+
+    const UniValue& txids{request.params[0].get_array()};
+    std::vector<uint256> hashes;
+    hashes.reserve(txids.size());
+    for (size_t i = 0; i < txids.size(); ++i) {
+        hashes.push_back(ParseHashV(txids[i], strprintf("txids[%d]", i)));
+    }
+    const bool verbose{!request.params[1].isNull() && request.params[1].get_bool()};
+
+    std::vector<uint256> block_hashes(hashes.size());
+    std::vector<CTransactionRef> txs(hashes.size());
+    std::vector<uint256> lookups;
+    std::vector<size_t> lookup_indexes;
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        if (node.mempool) txs[i] = node.mempool->get(hashes[i]);
+        if (!txs[i]) {
+            lookups.push_back(hashes[i]);
+            lookup_indexes.push_back(i);
+        }
+    }
+    if (g_txindex && !lookups.empty()) {
+        g_txindex->BlockUntilSyncedToCurrentChain();
+        std::vector<uint256> found_block_hashes;
+        std::vector<CTransactionRef> found_txs;
+        g_txindex->FindTxs(lookups, found_block_hashes, found_txs);
+        for (size_t j = 0; j < lookups.size(); ++j) {
+            block_hashes[lookup_indexes[j]] = found_block_hashes[j];
+            txs[lookup_indexes[j]] = std::move(found_txs[j]);
+        }
+    }
+
+    UniValue result(UniValue::VARR);
+    for (size_t i = 0; i < txs.size(); ++i) {
+        if (!txs[i]) {
+            result.push_back(NullUniValue);
+        } else if (!verbose) {
+            result.push_back(EncodeHexTx(*txs[i], RPCSerializationFlags()));
+        } else {
+            UniValue entry(UniValue::VOBJ);
+            TxToJSON(*txs[i], block_hashes[i], entry, chainman.ActiveChainstate());
+            result.push_back(entry);
+        }
+    }
+    return result;
+},
+    };
+}
+
 static RPCHelpMan createrawtransaction()
 {
     return RPCHelpMan{"createrawtransaction",
@@ -1857,6 +1955,7 @@ void RegisterRawTransactionRPCCommands(CRPCTable& t)
 {
     static const CRPCCommand commands[]{
         {"rawtransactions", &getrawtransaction},
+        {"rawtransactions", &getrawtransactions},
         {"rawtransactions", &createrawtransaction},
         {"rawtransactions", &decoderawtransaction},
         {"rawtransactions", &decodescript},
@@ -238,6 +238,7 @@ public:
     bool empty() const                               { return vch.size() == m_read_pos; }
     void resize(size_type n, value_type c = value_type{}) { vch.resize(n + m_read_pos, c); }
     void reserve(size_type n)                        { vch.reserve(n + m_read_pos); }
+    size_type capacity() const                       { return vch.capacity() - m_read_pos; }
     const_reference operator[](size_type pos) const  { return vch[pos + m_read_pos]; }
     reference operator[](size_type pos)              { return vch[pos + m_read_pos]; }
     void clear()                                     { vch.clear(); m_read_pos = 0; }
@@ -706,6 +707,21 @@ public:
         return true;
     }
 
+    //! move ahead to a given reading position without copying the bytes in
+    //! between anywhere; use SetPos() to go back
+    void SkipTo(uint64_t nPos)
+    {
+        assert(nPos >= m_read_pos);
+        if (nPos > nReadLimit) {
+            throw std::ios_base::failure("Skip attempted past buffer limit");
+        }
+        while (m_read_pos < nPos) {
+            if (m_read_pos == nSrcPos)
+                Fill();
+            m_read_pos = std::min(nPos, nSrcPos);
+        }
+    }
+
     //! prevent reading beyond a certain position
     //! no argument removes the limit
     bool SetLimit(uint64_t nPos = std::numeric_limits<uint64_t>::max()) {
@@ -0,0 +1,190 @@
+// Copyright (c) 2022 The Garikcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_SUPPORT_ALLOCATORS_POOL_H
+#define BITCOIN_SUPPORT_ALLOCATORS_POOL_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * A memory resource for the many small, equally sized allocations of
+ * node-based containers such as std::unordered_map.
+ *
+ * Blocks of up to MAX_BLOCK_SIZE_BYTES are carved out of large chunks in
+ * allocation order, so nodes inserted one after another sit next to each
+ * other in memory and don't pay the bookkeeping overhead of malloc. A
+ * deallocated block goes on a free list for its size and is handed out again
+ * by the next allocation of that size. Chunks are only released when the
+ * resource is destroyed. Allocations that are larger or more strictly aligned,
+ * such as the bucket array of a hash map, are passed on to operator new.
+ *
+ * The resource is not thread safe; it has to be protected by the same lock as
+ * the container using it.
+ */
+template <std::size_t MAX_BLOCK_SIZE_BYTES, std::size_t ALIGN_BYTES>
+class PoolResource final
+{
+    static_assert(ALIGN_BYTES > 0 && (ALIGN_BYTES & (ALIGN_BYTES - 1)) == 0, "ALIGN_BYTES must be a power of two");
+    static_assert(MAX_BLOCK_SIZE_BYTES > 0 && MAX_BLOCK_SIZE_BYTES % ALIGN_BYTES == 0, "MAX_BLOCK_SIZE_BYTES must be a multiple of ALIGN_BYTES");
+
+    //! A free block, linking to the next free block of the same size
+    struct ListNode {
+        ListNode* m_next;
+    };
+    static_assert(ALIGN_BYTES >= alignof(ListNode) && ALIGN_BYTES >= sizeof(ListNode), "free blocks must be able to hold a ListNode");
+
+    //! Size of the chunks blocks are carved out of
+    const std::size_t m_chunk_size_bytes;
+
+    //! All allocated chunks, released on destruction
+    std::vector<std::byte*> m_allocated_chunks{};
+
+    //! Free lists, indexed by the number of ALIGN_BYTES units of a block
+    std::array<ListNode*, MAX_BLOCK_SIZE_BYTES / ALIGN_BYTES + 1> m_free_lists{};
+
+    //! The part of the newest chunk that hasn't been handed out yet
+    std::byte* m_available_memory_it{nullptr};
+    std::byte* m_available_memory_end{nullptr};
+
+    static constexpr std::size_t NumElemAlignBytes(std::size_t bytes)
+    {
+        return (bytes + ALIGN_BYTES - 1) / ALIGN_BYTES + (bytes == 0);
+    }
+
+    static constexpr bool IsFreeListUsable(std::size_t bytes, std::size_t alignment)
+    {
+        return alignment <= ALIGN_BYTES && bytes <= MAX_BLOCK_SIZE_BYTES;
+    }
+
+    void PlacementAddToList(void* p, ListNode*& node)
+    {
+        node = new (p) ListNode{node};
+    }
+
+    void AllocateChunk()
+    {
+        // Keep what is left of the current chunk on its free list. Every block
+        // is a multiple of ALIGN_BYTES, so the remainder is too.
+        if (m_available_memory_it != m_available_memory_end) {
+            const std::size_t remaining_num_align{static_cast<std::size_t>(m_available_memory_end - m_available_memory_it) / ALIGN_BYTES};
+            PlacementAddToList(m_available_memory_it, m_free_lists[remaining_num_align]);
+        }
+        m_available_memory_it = static_cast<std::byte*>(::operator new(m_chunk_size_bytes, std::align_val_t{ALIGN_BYTES}));
+        m_available_memory_end = m_available_memory_it + m_chunk_size_bytes;
+        m_allocated_chunks.emplace_back(m_available_memory_it);
+    }
+
+public:
+    /**
+     * @param[in] chunk_size_bytes  Size of the chunks blocks are carved out of,
+     *                              at least MAX_BLOCK_SIZE_BYTES and rounded up
+     *                              to a multiple of ALIGN_BYTES.
+     */
+    explicit PoolResource(std::size_t chunk_size_bytes)
+        : m_chunk_size_bytes{NumElemAlignBytes(std::max(chunk_size_bytes, MAX_BLOCK_SIZE_BYTES)) * ALIGN_BYTES}
+    {
+    }
+
+    //! Use chunks of 256 KiB.
+    PoolResource() : PoolResource(262144) {}
+
+    PoolResource(const PoolResource&) = delete;
+    PoolResource& operator=(const PoolResource&) = delete;
+
+    ~PoolResource()
+    {
+        for (std::byte* chunk : m_allocated_chunks) {
+            ::operator delete(chunk, std::align_val_t{ALIGN_BYTES});
+        }
+    }
+
+    void* Allocate(std::size_t bytes, std::size_t alignment)
+    {
+        if (!IsFreeListUsable(bytes, alignment)) {
+            return ::operator new(bytes, std::align_val_t{alignment});
+        }
+        const std::size_t num_align{NumElemAlignBytes(bytes)};
+        if (ListNode*& free_block{m_free_lists[num_align]}; free_block != nullptr) {
+            // Reuse a freed block of the same size
+            return std::exchange(free_block, free_block->m_next);
+        }
+        if (static_cast<std::size_t>(m_available_memory_end - m_available_memory_it) < num_align * ALIGN_BYTES) {
+            AllocateChunk();
+        }
+        return std::exchange(m_available_memory_it, m_available_memory_it + num_align * ALIGN_BYTES);
+    }
+
+    void Deallocate(void* p, std::size_t bytes, std::size_t alignment) noexcept
+    {
+        if (!IsFreeListUsable(bytes, alignment)) {
+            ::operator delete(p, std::align_val_t{alignment});
+            return;
+        }
+        PlacementAddToList(p, m_free_lists[NumElemAlignBytes(bytes)]);
+    }
+
+    std::size_t NumAllocatedChunks() const { return m_allocated_chunks.size(); }
+
+    std::size_t ChunkSizeBytes() const { return m_chunk_size_bytes; }
+};
+
+/**
+ * Allocator handing out memory from a PoolResource, which it doesn't own.
+ * Containers using it must not outlive the resource.
+ */
+template <class T, std::size_t MAX_BLOCK_SIZE_BYTES, std::size_t ALIGN_BYTES = alignof(T)>
+class PoolAllocator
+{
+    PoolResource<MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>* m_resource;
+
+    template <typename U, std::size_t M, std::size_t A>
+    friend class PoolAllocator;
+
+public:
+    using value_type = T;
+    using ResourceType = PoolResource<MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>;
+
+    PoolAllocator(ResourceType* resource) noexcept : m_resource{resource} {}
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U, MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>& other) noexcept : m_resource{other.m_resource}
+    {
+    }
+
+    template <typename U>
+    struct rebind {
+        using other = PoolAllocator<U, MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>;
+    };
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(m_resource->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        m_resource->Deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    ResourceType* resource() const noexcept { return m_resource; }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U, MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>& other) const noexcept
+    {
+        return m_resource == other.m_resource;
+    }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U, MAX_BLOCK_SIZE_BYTES, ALIGN_BYTES>& other) const noexcept
+    {
+        return !(*this == other);
+    }
+};
+
+#endif // BITCOIN_SUPPORT_ALLOCATORS_POOL_H
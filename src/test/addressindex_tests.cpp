@@ -0,0 +1,140 @@
+// Copyright (c) 2022 The Garikcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <consensus/validation.h>
+#include <index/addressindex.h>
+#include <interfaces/chain.h>
+#include <script/standard.h>
+#include <test/util/mining.h>
+#include <test/util/script.h>
+#include <test/util/setup_common.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+
+BOOST_AUTO_TEST_SUITE(addressindex_tests)
+
+static void IndexWaitSynced(BaseIndex& index)
+{
+    const auto timeout = GetTime<std::chrono::seconds>() + 120s;
+    while (!index.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(timeout > GetTime<std::chrono::milliseconds>());
+        UninterruptibleSleep(100ms);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(addressindex_position_string)
+{
+    const AddressHistoryPosition pos{120, 3, true, 1};
+    BOOST_CHECK_EQUAL(pos.ToString(), "120:3:out:1");
+    const auto parsed{AddressHistoryPosition::FromString("120:3:out:1")};
+    BOOST_REQUIRE(parsed);
+    BOOST_CHECK_EQUAL(parsed->height, 120);
+    BOOST_CHECK_EQUAL(parsed->tx_pos, 3U);
+    BOOST_CHECK(parsed->is_output);
+    BOOST_CHECK_EQUAL(parsed->index, 1U);
+    BOOST_CHECK(!AddressHistoryPosition::FromString("120:3:in:1")->is_output);
+
+    for (const std::string str : {"", "120:3:out", "120:3:spent:1", "-1:3:in:1", "120:x:in:1", "120:3:in:1:0", "120:3:in:4294967296"}) {
+        BOOST_CHECK(!AddressHistoryPosition::FromString(str));
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(addressindex_history_and_rewind, RegTestingSetup)
+{
+    // Mature a coinbase paying to P2WSH_OP_TRUE.
+    std::vector<CTxIn> coinbases;
+    for (int i = 0; i < COINBASE_MATURITY + 1; ++i) {
+        coinbases.push_back(MineBlock(m_node, P2WSH_OP_TRUE));
+    }
+
+    AddressIndex address_index{interfaces::MakeChain(m_node), 1 << 20, true};
+    BOOST_REQUIRE(address_index.Start());
+    IndexWaitSynced(address_index);
+
+    std::vector<AddressHistoryEntry> history;
+    BOOST_REQUIRE(address_index.FindHistory(P2WSH_OP_TRUE, {}, 1000, history));
+    BOOST_REQUIRE_EQUAL(history.size(), coinbases.size());
+    for (size_t i = 0; i < history.size(); ++i) {
+        BOOST_CHECK_EQUAL(history[i].pos.ToString(), AddressHistoryPosition({int(i) + 1, 0, true, 0}).ToString());
+        BOOST_CHECK(history[i].txid == coinbases[i].prevout.hash);
+        BOOST_CHECK(history[i].amount > 0);
+    }
+
+    // Pages continue where the previous one ended.
+    std::vector<AddressHistoryEntry> page;
+    BOOST_REQUIRE(address_index.FindHistory(P2WSH_OP_TRUE, history[10].pos, 5, page));
+    BOOST_REQUIRE_EQUAL(page.size(), 5U);
+    BOOST_CHECK(page[0].txid == history[10].txid);
+    BOOST_CHECK(page[4].txid == history[14].txid);
+
+    // Spend the first coinbase to another script.
+    const CScript other_script{GetScriptForDestination(PKHash(uint160{std::vector<unsigned char>(20, 1)}))};
+    CMutableTransaction mtx;
+    mtx.vin.push_back(coinbases[0]);
+    mtx.vin.back().scriptWitness.stack.push_back(WITNESS_STACK_ELEM_OP_TRUE);
+    mtx.vout.emplace_back(history[0].amount - 1000, other_script);
+    const CTransactionRef tx{MakeTransactionRef(mtx)};
+    BOOST_REQUIRE(WITH_LOCK(::cs_main, return m_node.chainman->ProcessTransaction(tx)).m_result_type == MempoolAcceptResult::ResultType::VALID);
+    MineBlock(m_node, P2WSH_OP_TRUE);
+    const int spend_height{int(coinbases.size()) + 1};
+    BOOST_REQUIRE(address_index.BlockUntilSyncedToCurrentChain());
+
+    history.clear();
+    BOOST_REQUIRE(address_index.FindHistory(P2WSH_OP_TRUE, {spend_height, 0, false, 0}, 1000, history));
+    BOOST_REQUIRE_EQUAL(history.size(), 2U);
+    BOOST_CHECK_EQUAL(history[0].pos.ToString(), AddressHistoryPosition({spend_height, 0, true, 0}).ToString());
+    BOOST_CHECK_EQUAL(history[1].pos.ToString(), AddressHistoryPosition({spend_height, 1, false, 0}).ToString());
+    BOOST_CHECK(history[1].txid == tx->GetHash());
+    BOOST_CHECK(history[1].prevout == coinbases[0].prevout);
+
+    std::vector<AddressHistoryEntry> other_history;
+    BOOST_REQUIRE(address_index.FindHistory(other_script, {}, 1000, other_history));
+    BOOST_REQUIRE_EQUAL(other_history.size(), 1U);
+    BOOST_CHECK_EQUAL(other_history[0].pos.ToString(), AddressHistoryPosition({spend_height, 1, true, 0}).ToString());
+    BOOST_CHECK_EQUAL(other_history[0].amount, history[1].amount - 1000);
+
+    std::vector<AddressUnspentEntry> unspent;
+    BOOST_REQUIRE(address_index.FindUnspent(P2WSH_OP_TRUE, {}, 1000, unspent));
+    BOOST_CHECK_EQUAL(unspent.size(), coinbases.size());
+    for (const auto& entry : unspent) {
+        BOOST_CHECK(entry.outpoint != coinbases[0].prevout);
+    }
+    unspent.clear();
+    BOOST_REQUIRE(address_index.FindUnspent(other_script, {}, 1000, unspent));
+    BOOST_REQUIRE_EQUAL(unspent.size(), 1U);
+    BOOST_CHECK(unspent[0].outpoint == COutPoint(tx->GetHash(), 0));
+    BOOST_CHECK_EQUAL(unspent[0].height, spend_height);
+
+    // Replace the block of the spend. The index rewinds it when the new block
+    // connects, and the spend is mined again in the new block.
+    {
+        BlockValidationState state;
+        CBlockIndex* tip{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Tip())};
+        BOOST_REQUIRE(m_node.chainman->ActiveChainstate().InvalidateBlock(state, tip));
+    }
+    MineBlock(m_node, other_script);
+    BOOST_REQUIRE(address_index.BlockUntilSyncedToCurrentChain());
+
+    history.clear();
+    BOOST_REQUIRE(address_index.FindHistory(P2WSH_OP_TRUE, {spend_height, 0, false, 0}, 1000, history));
+    BOOST_REQUIRE_EQUAL(history.size(), 1U);
+    BOOST_CHECK_EQUAL(history[0].pos.ToString(), AddressHistoryPosition({spend_height, 1, false, 0}).ToString());
+    other_history.clear();
+    BOOST_REQUIRE(address_index.FindHistory(other_script, {}, 1000, other_history));
+    BOOST_REQUIRE_EQUAL(other_history.size(), 2U);
+    BOOST_CHECK_EQUAL(other_history[0].pos.ToString(), AddressHistoryPosition({spend_height, 0, true, 0}).ToString());
+    BOOST_CHECK(other_history[1].txid == tx->GetHash());
+    unspent.clear();
+    BOOST_REQUIRE(address_index.FindUnspent(P2WSH_OP_TRUE, {}, 1000, unspent));
+    BOOST_CHECK_EQUAL(unspent.size(), coinbases.size() - 1);
+
+    address_index.Stop();
+    SyncWithValidationInterfaceQueue();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
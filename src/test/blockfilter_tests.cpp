@@ -7,9 +7,11 @@
 
 #include <blockfilter.h>
 #include <core_io.h>
+#include <random.h>
 #include <serialize.h>
 #include <streams.h>
 #include <univalue.h>
+#include <util/golombrice.h>
 #include <util/strencodings.h>
 
 #include <boost/test/unit_test.hpp>
@@ -52,6 +54,43 @@ BOOST_AUTO_TEST_CASE(gcsfilter_default_constructor)
     BOOST_CHECK_EQUAL(params.m_M, 1U);
 }
 
+BOOST_AUTO_TEST_CASE(golomb_rice_coder)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    for (const uint8_t P : {0, 1, 7, 19, 32, 45}) {
+        std::vector<uint64_t> values;
+        for (int i = 0; i < 1000; ++i) {
+            // Mostly small quotients as in real filters, with some long runs.
+            const uint64_t q{rng.randrange(8) == 0 ? rng.randrange(300) : rng.randrange(4)};
+            values.push_back((q << P) + (P ? rng.randbits(P) : 0));
+        }
+
+        // The word-at-a-time encoder must match the bit stream based one.
+        std::vector<unsigned char> expected;
+        {
+            CVectorWriter stream(SER_NETWORK, 0, expected, 0);
+            BitStreamWriter<CVectorWriter> bitwriter(stream);
+            for (uint64_t value : values) GolombRiceEncode(bitwriter, P, value);
+            bitwriter.Flush();
+        }
+        std::vector<unsigned char> encoded;
+        GolombRiceEncoder encoder{encoded};
+        for (uint64_t value : values) encoder.Encode(P, value);
+        encoder.Flush();
+        BOOST_CHECK(encoded == expected);
+
+        GolombRiceDecoder decoder{encoded};
+        for (uint64_t value : values) {
+            BOOST_CHECK_EQUAL(decoder.Decode(P), value);
+        }
+        BOOST_CHECK_EQUAL(decoder.RemainingBytes(), 0U);
+
+        // Truncated data fails to decode, like with BitStreamReader.
+        GolombRiceDecoder truncated{Span{encoded}.first(encoded.size() - 1)};
+        BOOST_CHECK_THROW(for (size_t i = 0; i < values.size(); ++i) truncated.Decode(P), std::ios_base::failure);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(blockfilter_basic_test)
 {
     CScript included_scripts[5], excluded_scripts[4];
@@ -0,0 +1,217 @@
+// Copyright (c) 2022 The Garikcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chain.h>
+#include <chainparams.h>
+#include <consensus/validation.h>
+#include <node/blockstorage.h>
+#include <pow.h>
+#include <primitives/block.h>
+#include <test/util/setup_common.h>
+#include <undo.h>
+#include <util/strencodings.h>
+#include <util/system.h>
+#include <validation.h>
+
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+using node::BlockManager;
+using node::DEFAULT_BLOCK_WRITE_BUFFER;
+using node::DEFAULT_PRUNE_BATCH;
+using node::GetBlockPosFilename;
+using node::IsCompressedBlockFile;
+using node::OpenBlockFile;
+using node::PruneLockInfo;
+using node::PrunePlan;
+using node::ReadBlockFromDisk;
+using node::ReadRawBlockFromDisk;
+using node::UndoReadFromDisk;
+
+BOOST_FIXTURE_TEST_SUITE(blockmanager_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(blockmanager_write_read)
+{
+    const CChainParams& params{Params()};
+    const CBlock& genesis{params.GenesisBlock()};
+    const uint256 genesis_hash{genesis.GetHash()};
+
+    // Write synchronously, through a buffer that fills up, and through the default buffer
+    for (const int64_t buffer : {int64_t{0}, int64_t{1}, DEFAULT_BLOCK_WRITE_BUFFER}) {
+        gArgs.ForceSetArg("-blockwritebuffer", ToString(buffer));
+        std::vector<FlatFilePos> positions;
+        {
+            BlockManager blockman{};
+            CChain chain;
+            // About 1.5 MiB of blocks, more than the 1 MiB buffer holds
+            for (int height = 0; height < 5000; ++height) {
+                const FlatFilePos pos{blockman.SaveBlockToDisk(genesis, height, chain, params, nullptr)};
+                BOOST_REQUIRE(!pos.IsNull());
+                positions.push_back(pos);
+                // Blocks can be read back right away, even while they are still queued
+                if (height % 500 == 0) {
+                    CBlock block;
+                    BOOST_CHECK(ReadBlockFromDisk(block, pos, params.GetConsensus()));
+                    BOOST_CHECK_EQUAL(block.GetHash(), genesis_hash);
+                    std::vector<uint8_t> raw_block;
+                    BOOST_CHECK(ReadRawBlockFromDisk(raw_block, pos, params.MessageStart()));
+                    BOOST_CHECK_EQUAL(raw_block.size(), ::GetSerializeSize(genesis, CLIENT_VERSION));
+                }
+            }
+
+            // Undo data too
+            CBlockIndex prev;
+            prev.phashBlock = &genesis_hash;
+            CBlockIndex index;
+            index.pprev = &prev;
+            CBlockUndo blockundo;
+            blockundo.vtxundo.resize(3);
+            BlockValidationState state;
+            LOCK(cs_main);
+            index.nFile = positions.back().nFile;
+            BOOST_CHECK(blockman.WriteUndoDataForBlock(blockundo, state, &index, params));
+            BOOST_CHECK(index.nStatus & BLOCK_HAVE_UNDO);
+            CBlockUndo read_undo;
+            BOOST_CHECK(UndoReadFromDisk(read_undo, &index));
+            BOOST_CHECK_EQUAL(read_undo.vtxundo.size(), 3U);
+        }
+
+        // Everything queued was written before the block manager went away
+        CBlock block;
+        BOOST_CHECK(ReadBlockFromDisk(block, positions.back(), params.GetConsensus()));
+        BOOST_CHECK_EQUAL(block.GetHash(), genesis_hash);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(blockmanager_compress_block_file)
+{
+    // Use block files of 64 KiB
+    gArgs.ForceSetArg("-fastprune", "1");
+    // Regtest blocks are easy to mine
+    const auto regtest_params{CreateChainParams(gArgs, CBaseChainParams::REGTEST)};
+    const CChainParams& params{*regtest_params};
+    BlockManager blockman{};
+    CBlockIndex tip;
+    CChain chain;
+    chain.SetTip(tip);
+
+    // Distinct blocks with a valid proof of work
+    std::vector<CBlock> blocks;
+    std::vector<FlatFilePos> positions;
+    for (int i = 0; blocks.empty() || positions.back().nFile < 2; ++i) {
+        CBlock block{params.GenesisBlock()};
+        block.nTime += i;
+        while (!CheckProofOfWork(block.GetHash(), block.nBits, params.GetConsensus())) ++block.nNonce;
+        positions.push_back(blockman.SaveBlockToDisk(block, i, chain, params, nullptr));
+        blocks.push_back(block);
+    }
+    const FlatFilePos file_pos{0, 0};
+    BOOST_CHECK(!IsCompressedBlockFile(CAutoFile{OpenBlockFile(file_pos, true), SER_DISK, CLIENT_VERSION}.Get(), file_pos));
+
+    // Only blocks in the block index are kept, so leave out the first one
+    {
+        LOCK(cs_main);
+        for (size_t i = 1; i < blocks.size(); ++i) {
+            CBlockIndex* index{blockman.InsertBlockIndex(blocks[i].GetHash())};
+            index->nFile = positions[i].nFile;
+            index->nDataPos = positions[i].nPos;
+            index->nStatus |= BLOCK_HAVE_DATA;
+        }
+    }
+
+    const auto size_before{fs::file_size(GetBlockPosFilename(file_pos))};
+    BOOST_CHECK(blockman.CompressBlockFile(0));
+    BOOST_CHECK_LT(fs::file_size(GetBlockPosFilename(file_pos)), size_before);
+    BOOST_CHECK(IsCompressedBlockFile(CAutoFile{OpenBlockFile(file_pos, true), SER_DISK, CLIENT_VERSION}.Get(), file_pos));
+    // Compressing it again does nothing, and blocks are still added to the last file
+    BOOST_CHECK(blockman.CompressBlockFile(0));
+    BOOST_CHECK(!blockman.CompressBlockFile(2));
+
+    size_t compressed_blocks{0};
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        CBlock block;
+        std::vector<uint8_t> raw_block;
+        const bool dropped{i == 0};
+        BOOST_CHECK_EQUAL(ReadBlockFromDisk(block, positions[i], params.GetConsensus()), !dropped);
+        BOOST_CHECK_EQUAL(ReadRawBlockFromDisk(raw_block, positions[i], params.MessageStart()), !dropped);
+        if (dropped) continue;
+        BOOST_CHECK_EQUAL(block.GetHash(), blocks[i].GetHash());
+        std::vector<uint8_t> expected;
+        CVectorWriter{SER_DISK, CLIENT_VERSION, expected, 0} << blocks[i];
+        BOOST_CHECK(raw_block == expected);
+        if (positions[i].nFile == 0) ++compressed_blocks;
+    }
+    BOOST_CHECK_GT(compressed_blocks, 100U);
+}
+
+BOOST_AUTO_TEST_CASE(blockmanager_prune_plan)
+{
+    // Use small block files, so that there are many of them
+    gArgs.ForceSetArg("-fastprune", "1");
+    const auto regtest_params{CreateChainParams(gArgs, CBaseChainParams::REGTEST)};
+    const CChainParams& params{*regtest_params};
+    BlockManager blockman{};
+    CBlockIndex tip;
+    CChain chain;
+    chain.SetTip(tip);
+
+    const int tip_height{3000};
+    FlatFilePos pos;
+    for (int height = 0; height <= tip_height; ++height) {
+        pos = blockman.SaveBlockToDisk(params.GenesisBlock(), height, chain, params, nullptr);
+        BOOST_REQUIRE(!pos.IsNull());
+    }
+    const auto files_below = [&](const int height) {
+        std::vector<int> files;
+        for (int file = 0; file < pos.nFile; ++file) {
+            if (blockman.GetBlockFileInfo(file)->nHeightLast <= unsigned(height)) files.push_back(file);
+        }
+        return files;
+    };
+
+    node::fPruneMode = true;
+    node::nPruneTarget = 1;
+    LOCK(cs_main);
+
+    // Without prune locks, the files of the blocks within -pruneundodepth of the tip are kept
+    std::optional<std::string> limiting_lock;
+    for (const int depth : {int{MIN_BLOCKS_TO_KEEP}, 500}) {
+        node::g_prune_undo_depth = depth;
+        node::g_prune_batch = 0;
+        BOOST_CHECK_EQUAL(blockman.GetPruneLockHeight(tip_height, limiting_lock), tip_height);
+        BOOST_CHECK(!limiting_lock);
+        const PrunePlan plan{blockman.GetPrunePlan(params.PruneAfterHeight(), tip_height, tip_height, /*is_ibd=*/false)};
+        BOOST_CHECK(plan.files == files_below(tip_height - depth));
+        BOOST_CHECK_GT(plan.files.size(), 2U);
+        BOOST_CHECK_LT(plan.usage_after, plan.usage_before);
+        BOOST_CHECK(!plan.incomplete);
+
+        // With -prunebatch, the oldest files are pruned first
+        node::g_prune_batch = 2;
+        const PrunePlan batch{blockman.GetPrunePlan(params.PruneAfterHeight(), tip_height, tip_height, /*is_ibd=*/false)};
+        BOOST_CHECK(batch.files == std::vector<int>(plan.files.begin(), plan.files.begin() + 2));
+        BOOST_CHECK(batch.incomplete);
+    }
+
+    // A prune lock that needs older blocks limits pruning further
+    node::g_prune_undo_depth = MIN_BLOCKS_TO_KEEP;
+    blockman.UpdatePruneLock("index", PruneLockInfo{.height_first = 300});
+    const int max_prune_height{blockman.GetPruneLockHeight(tip_height, limiting_lock)};
+    BOOST_CHECK_EQUAL(max_prune_height, 300 - 10 - 1);
+    BOOST_CHECK_EQUAL(limiting_lock.value_or(""), "index");
+    const PrunePlan plan{blockman.GetPrunePlan(params.PruneAfterHeight(), tip_height, max_prune_height, /*is_ibd=*/false)};
+    BOOST_CHECK(plan.files == files_below(max_prune_height));
+
+    // Nothing is pruned below the target or before the chain is long enough
+    BOOST_CHECK(blockman.GetPrunePlan(params.PruneAfterHeight(), params.PruneAfterHeight(), max_prune_height, /*is_ibd=*/false).files.empty());
+    node::nPruneTarget = plan.usage_before + node::BLOCKFILE_CHUNK_SIZE + node::UNDOFILE_CHUNK_SIZE + 1;
+    BOOST_CHECK(blockman.GetPrunePlan(params.PruneAfterHeight(), tip_height, max_prune_height, /*is_ibd=*/false).files.empty());
+
+    node::fPruneMode = false;
+    node::nPruneTarget = 0;
+    node::g_prune_batch = DEFAULT_PRUNE_BATCH;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -12,7 +12,9 @@
 #include <undo.h>
 #include <util/strencodings.h>
 
+#include <algorithm>
 #include <map>
+#include <memory>
 #include <vector>
 
 #include <boost/test/unit_test.hpp>
@@ -272,6 +274,59 @@ BOOST_AUTO_TEST_CASE(coins_cache_simulation_test)
     SimulationTest(&db_base, true);
 }
 
+static size_t CountCoins(const std::vector<std::unique_ptr<CCoinsViewCursor>>& cursors)
+{
+    size_t count{0};
+    for (const auto& cursor : cursors) {
+        for (; cursor->Valid(); cursor->Next()) ++count;
+    }
+    return count;
+}
+
+BOOST_AUTO_TEST_CASE(coins_db_range_cursors)
+{
+    CCoinsViewDB db{"test", /*nCacheSize=*/1 << 23, /*fMemory=*/true, /*fWipe=*/false};
+    CCoinsViewCache cache{&db};
+    std::map<COutPoint, Coin> expected;
+    for (int i = 0; i < 1000; ++i) {
+        const COutPoint outpoint{InsecureRand256(), uint32_t(InsecureRandRange(4))};
+        const Coin coin{CTxOut{int64_t(InsecureRand32()), CScript() << std::vector<unsigned char>(InsecureRandBits(6))}, 1, false};
+        cache.AddCoin(outpoint, Coin{coin}, /*possible_overwrite=*/true);
+        expected[outpoint] = coin;
+    }
+    cache.SetBestBlock(InsecureRand256());
+    BOOST_CHECK(cache.Flush());
+
+    for (const size_t num_ranges : {1, 3, 16, 300}) {
+        const auto cursors{db.Cursors(num_ranges)};
+        BOOST_CHECK_EQUAL(cursors.size(), std::min<size_t>(num_ranges, 256));
+        // The ranges follow each other, so together they return all coins in key order.
+        std::vector<COutPoint> found;
+        for (const auto& cursor : cursors) {
+            BOOST_CHECK(cursor->GetBestBlock() == db.GetBestBlock());
+            for (; cursor->Valid(); cursor->Next()) {
+                COutPoint key;
+                Coin coin;
+                BOOST_REQUIRE(cursor->GetKey(key));
+                BOOST_REQUIRE(cursor->GetValue(coin));
+                BOOST_CHECK(expected.at(key) == coin);
+                found.push_back(key);
+            }
+        }
+        BOOST_REQUIRE_EQUAL(found.size(), expected.size());
+        BOOST_CHECK(std::equal(found.begin(), found.end(), expected.begin(), [](const COutPoint& a, const auto& b) { return a == b.first; }));
+    }
+
+    // Cursors keep reading the state they were created on
+    const auto cursors{db.Cursors(4)};
+    for (const auto& [outpoint, coin] : expected) {
+        BOOST_CHECK(cache.SpendCoin(outpoint));
+    }
+    BOOST_CHECK(cache.Flush());
+    BOOST_CHECK_EQUAL(CountCoins(cursors), expected.size());
+    BOOST_CHECK_EQUAL(CountCoins(db.Cursors(4)), 0U);
+}
+
 // Store of all necessary tx and undo data for next test
 typedef std::map<COutPoint, std::tuple<CTransaction,CTxUndo,Coin>> UtxoData;
 UtxoData utxoData;
@@ -5,8 +5,11 @@
 #include <dbwrapper.h>
 #include <test/util/setup_common.h>
 #include <uint256.h>
+#include <util/system.h>
+#include <util/translation.h>
 
 #include <memory>
+#include <thread>
 
 #include <boost/test/unit_test.hpp>
 
@@ -398,6 +401,88 @@ BOOST_AUTO_TEST_CASE(iterator_string_ordering)
     }
 }
 
+BOOST_AUTO_TEST_CASE(dbwrapper_options)
+{
+    const auto read_options{[](const std::vector<const char*>& options, const std::string& name) {
+        ArgsManager args;
+        args.AddArg("-dboption", "", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+        std::vector<const char*> argv{"ignored"};
+        argv.insert(argv.end(), options.begin(), options.end());
+        std::string error;
+        BOOST_REQUIRE(args.ParseParameters(argv.size(), argv.data(), error));
+        return ReadDBOptions(args, name);
+    }};
+
+    // Defaults
+    auto options{read_options({}, "chainstate")};
+    BOOST_REQUIRE(options);
+    BOOST_CHECK_EQUAL(options->block_cache_percent, 50);
+    BOOST_CHECK_EQUAL(options->write_buffer_percent, 25);
+    BOOST_CHECK_EQUAL(options->bloom_bits, 10);
+    BOOST_CHECK_EQUAL(options->block_size, 4U << 10);
+    BOOST_CHECK_EQUAL(options->max_file_size, 2U << 20);
+    BOOST_CHECK_EQUAL(options->max_open_files, 0);
+
+    // Settings for all databases are overridden by later settings for one of them
+    const std::vector<const char*> settings{"-dboption=*:bloombits=0", "-dboption=*:blocksize=16",
+                                            "-dboption=indexes/txindex:blocksize=64", "-dboption=indexes/txindex:maxfilesize=32768",
+                                            "-dboption=chainstate:blockcache=70", "-dboption=chainstate:writebuffer=15", "-dboption=chainstate:maxopenfiles=100"};
+    options = read_options(settings, "chainstate");
+    BOOST_REQUIRE(options);
+    BOOST_CHECK_EQUAL(options->block_cache_percent, 70);
+    BOOST_CHECK_EQUAL(options->write_buffer_percent, 15);
+    BOOST_CHECK_EQUAL(options->bloom_bits, 0);
+    BOOST_CHECK_EQUAL(options->block_size, 16U << 10);
+    BOOST_CHECK_EQUAL(options->max_file_size, 2U << 20);
+    BOOST_CHECK_EQUAL(options->max_open_files, 100);
+    options = read_options(settings, "indexes/txindex");
+    BOOST_REQUIRE(options);
+    BOOST_CHECK_EQUAL(options->block_cache_percent, 50);
+    BOOST_CHECK_EQUAL(options->bloom_bits, 0);
+    BOOST_CHECK_EQUAL(options->block_size, 64U << 10);
+    BOOST_CHECK_EQUAL(options->max_file_size, 32U << 20);
+    BOOST_CHECK_EQUAL(options->max_open_files, 0);
+
+    // Malformed settings are rejected even if they apply to another database
+    for (const char* invalid : {"-dboption=chainstate", "-dboption=chainstate:blockcache", "-dboption=other:blockcache=101",
+                                "-dboption=*:writebuffer=-1", "-dboption=*:bloombits=65", "-dboption=*:blocksize=0",
+                                "-dboption=*:maxfilesize=1048577", "-dboption=*:compression=1", "-dboption=*:blockcache=abc"}) {
+        options = read_options({invalid}, "chainstate");
+        BOOST_CHECK_MESSAGE(!options, invalid);
+        BOOST_CHECK(!util::ErrorString(options).original.empty());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(dbwrapper_compaction)
+{
+    fs::path ph = m_args.GetDataDirBase() / "dbwrapper_compaction";
+    CDBWrapper dbw(ph, (1 << 20));
+    BOOST_CHECK_EQUAL(dbw.GetName(), "dbwrapper_compaction");
+    BOOST_CHECK(!dbw.GetCompactionStatus().running);
+    BOOST_CHECK(!dbw.GetCompactionStatus().duration);
+
+    for (uint32_t i = 0; i < 1000; ++i) {
+        BOOST_CHECK(dbw.Write(std::make_pair(uint8_t{'k'}, i), InsecureRand256()));
+    }
+    BOOST_CHECK(dbw.GetProperty("leveldb.stats"));
+    BOOST_CHECK(!dbw.GetProperty("leveldb.unknown"));
+
+    const std::vector<unsigned char> begin{'k'};
+    BOOST_CHECK(dbw.StartCompaction(begin, {}));
+    while (dbw.GetCompactionStatus().running) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+    const DBCompactionStatus status{dbw.GetCompactionStatus()};
+    BOOST_CHECK(status.begin == begin);
+    BOOST_CHECK(status.end.empty());
+    BOOST_CHECK(status.duration);
+
+    // The compaction moved the keys out of the log into table files
+    BOOST_CHECK_GT(dbw.EstimateRawSize(begin, {}), 0U);
+    uint256 res;
+    BOOST_CHECK(dbw.Read(std::make_pair(uint8_t{'k'}, uint32_t{999}), res));
+}
+
 BOOST_AUTO_TEST_CASE(unicodepath)
 {
     // Attempt to create a database with a UTF8 character in the path.
@@ -0,0 +1,30 @@
+// Copyright (c) 2022 The Garikcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/fuzz/FuzzedDataProvider.h>
+#include <test/fuzz/fuzz.h>
+#include <test/fuzz/util.h>
+#include <util/lz.h>
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+FUZZ_TARGET(lz_roundtrip)
+{
+    const std::vector<uint8_t> compressed{LZCompress(buffer)};
+    assert(compressed.size() <= buffer.size() + buffer.size() / 255 + 16);
+    std::vector<uint8_t> decompressed(buffer.size());
+    assert(LZDecompress(compressed, decompressed));
+    assert(std::equal(decompressed.begin(), decompressed.end(), buffer.begin(), buffer.end()));
+}
+
+FUZZ_TARGET(lz_decompress)
+{
+    FuzzedDataProvider fuzzed_data_provider{buffer.data(), buffer.size()};
+    std::vector<uint8_t> output(fuzzed_data_provider.ConsumeIntegralInRange<size_t>(0, 1 << 20));
+    const std::vector<uint8_t> input{fuzzed_data_provider.ConsumeRemainingBytes<uint8_t>()};
+    // Malformed input must be rejected without reading or writing out of bounds
+    (void)LZDecompress(input, output);
+}
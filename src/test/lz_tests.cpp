@@ -0,0 +1,85 @@
+// Copyright (c) 2022 The Garikcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/util/setup_common.h>
+#include <util/lz.h>
+#include <util/strencodings.h>
+
+#include <cstdint>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(lz_tests, BasicTestingSetup)
+
+static void CheckRoundTrip(const std::vector<uint8_t>& data)
+{
+    const std::vector<uint8_t> compressed{LZCompress(data)};
+    std::vector<uint8_t> decompressed(data.size());
+    BOOST_REQUIRE(LZDecompress(compressed, decompressed));
+    BOOST_CHECK(decompressed == data);
+    // The size has to be exact
+    std::vector<uint8_t> too_large(data.size() + 1);
+    BOOST_CHECK(!LZDecompress(compressed, too_large));
+    if (!data.empty()) {
+        std::vector<uint8_t> too_small(data.size() - 1);
+        BOOST_CHECK(!LZDecompress(compressed, too_small));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(lz_roundtrip)
+{
+    CheckRoundTrip({});
+    CheckRoundTrip({0x42});
+    CheckRoundTrip(ParseHex("000102030405060708"));
+
+    // Runs of one byte are matches that overlap their output
+    const std::vector<uint8_t> zeros(100000, 0);
+    CheckRoundTrip(zeros);
+    BOOST_CHECK_LT(LZCompress(zeros).size(), 500U);
+
+    // Repeated scripts, as in the outputs of a block
+    std::vector<uint8_t> scripts;
+    for (int i = 0; i < 1000; ++i) {
+        const std::vector<uint8_t> script{ParseHex("76a914" + InsecureRand256().ToString().substr(0, 40) + "88ac")};
+        scripts.insert(scripts.end(), script.begin(), script.end());
+    }
+    CheckRoundTrip(scripts);
+    BOOST_CHECK_LT(LZCompress(scripts).size(), scripts.size());
+
+    // Random data doesn't compress, but doesn't grow much either
+    for (const size_t size : {10, 1000, 100000}) {
+        const std::vector<uint8_t> random{g_insecure_rand_ctx.randbytes(size)};
+        CheckRoundTrip(random);
+        BOOST_CHECK_LE(LZCompress(random).size(), size + size / 255 + 16);
+    }
+
+    // Long matches and literal runs
+    std::vector<uint8_t> mixed{g_insecure_rand_ctx.randbytes(60000)};
+    mixed.insert(mixed.end(), mixed.begin(), mixed.begin() + 50000);
+    CheckRoundTrip(mixed);
+    BOOST_CHECK_LT(LZCompress(mixed).size(), 61000U);
+}
+
+BOOST_AUTO_TEST_CASE(lz_malformed)
+{
+    std::vector<uint8_t> output(16);
+    // 4 literals, then a match with an offset of 0
+    BOOST_CHECK(!LZDecompress(ParseHex("4061626364000000"), output));
+    // 4 literals, then a match reaching back before the start of the output
+    BOOST_CHECK(!LZDecompress(ParseHex("40616263640500"), output));
+    // A match without its offset
+    BOOST_CHECK(!LZDecompress(ParseHex("406162636401"), output));
+    // More literals than there is input
+    BOOST_CHECK(!LZDecompress(ParseHex("f0ff"), output));
+    // More output than there is room for
+    std::vector<uint8_t> small(2);
+    BOOST_CHECK(!LZDecompress(ParseHex("30616263"), small));
+
+    // 4 literals, then a match of 8 bytes repeating them, then 4 literals
+    BOOST_CHECK(LZDecompress(ParseHex("446162636404004065666768"), output));
+    BOOST_CHECK_EQUAL(std::string(output.begin(), output.end()), "abcdabcdabcdefgh");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -905,4 +905,44 @@ BOOST_AUTO_TEST_CASE(initial_advertise_from_version_message)
     TestOnlyResetTimeData();
 }
 
+
+BOOST_AUTO_TEST_CASE(v1_transport_fragmented_message)
+{
+    // A payload larger than the initial receive buffer, delivered in small and
+    // irregular fragments, must be reassembled intact with a valid checksum.
+    CSerializedNetMsg msg;
+    msg.m_type = NetMsgType::BLOCK;
+    msg.data.resize(600 * 1000);
+    for (size_t i = 0; i < msg.data.size(); ++i) {
+        msg.data[i] = static_cast<unsigned char>(i * 7 + (i >> 8));
+    }
+    const std::vector<unsigned char> payload{msg.data};
+
+    std::vector<unsigned char> wire;
+    V1TransportSerializer{}.prepareForTransport(msg, wire);
+    wire.insert(wire.end(), msg.data.begin(), msg.data.end());
+
+    V1TransportDeserializer deserializer{Params(), /*node_id=*/0, SER_NETWORK, INIT_PROTO_VERSION};
+    Span<const uint8_t> remaining{wire};
+    size_t fragment_size{1};
+    while (!remaining.empty()) {
+        Span<const uint8_t> fragment{remaining.first(std::min(fragment_size, remaining.size()))};
+        while (!fragment.empty()) {
+            BOOST_REQUIRE(deserializer.Read(fragment) >= 0);
+        }
+        remaining = remaining.subspan(std::min(fragment_size, remaining.size()));
+        BOOST_CHECK_EQUAL(deserializer.Complete(), remaining.empty());
+        fragment_size = fragment_size * 3 + 1;
+        if (fragment_size > 100 * 1000) fragment_size = 13;
+    }
+
+    bool reject_message{true};
+    CNetMessage received{deserializer.GetMessage(GetTime<std::chrono::microseconds>(), reject_message)};
+    BOOST_CHECK(!reject_message);
+    BOOST_CHECK_EQUAL(received.m_type, NetMsgType::BLOCK);
+    BOOST_CHECK_EQUAL(received.m_message_size, payload.size());
+    BOOST_CHECK(std::equal(payload.begin(), payload.end(), UCharCast(received.m_recv.data()), UCharCast(received.m_recv.data() + received.m_recv.size())));
+    BOOST_CHECK_EQUAL(received.m_recv.size(), payload.size());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,122 @@
+// Copyright (c) 2022 The Garikcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <arith_uint256.h>
+#include <chain.h>
+#include <node/blockstorage.h>
+#include <support/allocators/pool.h>
+#include <test/util/setup_common.h>
+#include <uint256.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(pool_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(basic_allocating)
+{
+    auto resource = PoolResource<8, 8>(1024);
+    BOOST_CHECK_EQUAL(resource.ChunkSizeBytes(), 1024U);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 0U);
+
+    // Blocks are carved out of one chunk, one after another
+    void* block = resource.Allocate(8, 8);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 1U);
+    void* next_block = resource.Allocate(8, 8);
+    BOOST_CHECK_EQUAL(static_cast<std::byte*>(next_block) - static_cast<std::byte*>(block), 8);
+
+    // A freed block is handed out again
+    resource.Deallocate(block, 8, 8);
+    BOOST_CHECK_EQUAL(resource.Allocate(8, 8), block);
+
+    // Allocations that are too large or too strictly aligned bypass the pool
+    void* large = resource.Allocate(16, 8);
+    void* aligned = resource.Allocate(8, 16);
+    BOOST_CHECK(large != nullptr && aligned != nullptr);
+    resource.Deallocate(large, 16, 8);
+    resource.Deallocate(aligned, 8, 16);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 1U);
+
+    // A new chunk is only needed once the first one is used up
+    for (size_t i = 2; i < 1024 / 8; ++i) {
+        resource.Allocate(8, 8);
+    }
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 1U);
+    resource.Allocate(8, 8);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 2U);
+    resource.Deallocate(next_block, 8, 8);
+}
+
+BOOST_AUTO_TEST_CASE(chunk_remainder)
+{
+    // The rest of a chunk that is too small for an allocation is kept for smaller ones
+    auto resource = PoolResource<64, 8>(100);
+    BOOST_CHECK_EQUAL(resource.ChunkSizeBytes(), 104U);
+    void* first = resource.Allocate(64, 8);
+    void* second = resource.Allocate(64, 8);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 2U);
+    void* remainder = resource.Allocate(40, 8);
+    BOOST_CHECK_EQUAL(static_cast<std::byte*>(remainder) - static_cast<std::byte*>(first), 64);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 2U);
+    resource.Deallocate(first, 64, 8);
+    resource.Deallocate(second, 64, 8);
+    resource.Deallocate(remainder, 40, 8);
+}
+
+BOOST_AUTO_TEST_CASE(pool_allocated_map)
+{
+    using Map = std::unordered_map<uint64_t, uint64_t, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                                   PoolAllocator<std::pair<const uint64_t, uint64_t>, 4 * sizeof(void*), alignof(void*)>>;
+    auto resource = Map::allocator_type::ResourceType(4096);
+    {
+        Map map{0, std::hash<uint64_t>{}, std::equal_to<uint64_t>{}, &resource};
+        for (uint64_t i = 0; i < 1000; ++i) {
+            map[i] = i * i;
+        }
+        const size_t chunks{resource.NumAllocatedChunks()};
+        BOOST_CHECK_LE(chunks * resource.ChunkSizeBytes(), 1000 * 4 * sizeof(void*) + resource.ChunkSizeBytes());
+
+        // Erased entries make room for new ones
+        for (uint64_t i = 0; i < 500; ++i) {
+            map.erase(i);
+        }
+        for (uint64_t i = 1000; i < 1500; ++i) {
+            map[i] = i * i;
+        }
+        BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), chunks);
+        for (uint64_t i = 500; i < 1500; ++i) {
+            BOOST_CHECK_EQUAL(map.at(i), i * i);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(block_index_entries_are_contiguous)
+{
+    node::BlockManager blockman{};
+    LOCK(cs_main);
+    // As when loading the block index, reserve the buckets up front so that
+    // only entries are allocated from the pool
+    blockman.m_block_index.reserve(100);
+    std::vector<CBlockIndex*> entries;
+    for (uint64_t i = 0; i < 100; ++i) {
+        CBlockIndex* pindex{blockman.InsertBlockIndex(ArithToUint256(arith_uint256{i + 1}))};
+        pindex->pprev = entries.empty() ? nullptr : entries.back();
+        pindex->nHeight = i;
+        entries.push_back(pindex);
+    }
+    // Entries added one after another are a constant distance apart
+    const std::ptrdiff_t stride{reinterpret_cast<std::byte*>(entries[1]) - reinterpret_cast<std::byte*>(entries[0])};
+    BOOST_CHECK_GE(stride, std::ptrdiff_t(sizeof(CBlockIndex)));
+    BOOST_CHECK_LE(stride, std::ptrdiff_t(sizeof(std::pair<const uint256, CBlockIndex>) + 2 * sizeof(void*)));
+    for (size_t i = 1; i < entries.size(); ++i) {
+        BOOST_CHECK_EQUAL(reinterpret_cast<std::byte*>(entries[i]) - reinterpret_cast<std::byte*>(entries[i - 1]), stride);
+    }
+    BOOST_CHECK_EQUAL(entries.back()->GetAncestor(10), entries[10]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -330,6 +330,56 @@ BOOST_AUTO_TEST_CASE(streams_buffered_file)
     fs::remove(streams_test_filename);
 }
 
+BOOST_AUTO_TEST_CASE(streams_buffered_file_skip)
+{
+    fs::path streams_test_filename = m_args.GetDataDirBase() / "streams_test_tmp";
+    FILE* file = fsbridge::fopen(streams_test_filename, "w+b");
+    // The value at each offset is the offset.
+    for (uint8_t j = 0; j < 40; ++j) {
+        fwrite(&j, 1, 1, file);
+    }
+    rewind(file);
+
+    // The buffer is 25 bytes, allow rewinding 10 bytes.
+    CBufferedFile bf(file, 25, 10, 222, 333);
+    uint8_t i;
+    // Skip to the current position, a no-op.
+    bf.SkipTo(0);
+    bf >> i;
+    BOOST_CHECK_EQUAL(i, 0);
+
+    // Skip further than the buffer size in one go.
+    bf.SkipTo(30);
+    BOOST_CHECK_EQUAL(bf.GetPos(), 30U);
+    bf >> i;
+    BOOST_CHECK_EQUAL(i, 30);
+
+    // The skipped bytes within the rewind window can be read again.
+    BOOST_CHECK(bf.SetPos(25));
+    bf >> i;
+    BOOST_CHECK_EQUAL(i, 25);
+
+    // Skipping past the limit throws and leaves the position unchanged.
+    BOOST_CHECK(bf.SetLimit(35));
+    BOOST_CHECK_THROW(bf.SkipTo(36), std::ios_base::failure);
+    BOOST_CHECK_EQUAL(bf.GetPos(), 26U);
+    bf.SetLimit();
+
+    // Skipping past the end of the file throws.
+    try {
+        bf.SkipTo(41);
+        BOOST_CHECK(false);
+    } catch (const std::exception& e) {
+        BOOST_CHECK(strstr(e.what(),
+                        "CBufferedFile::Fill: end of file") != nullptr);
+    }
+    BOOST_CHECK_EQUAL(bf.GetPos(), 40U);
+    BOOST_CHECK(bf.eof());
+
+    bf.fclose();
+    fs::remove(streams_test_filename);
+}
+
 BOOST_AUTO_TEST_CASE(streams_buffered_file_rand)
 {
     // Make this test deterministic.
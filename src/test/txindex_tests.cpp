@@ -6,10 +6,14 @@
 #include <index/txindex.h>
 #include <interfaces/chain.h>
 #include <script/standard.h>
+#include <test/util/mining.h>
+#include <test/util/script.h>
 #include <test/util/setup_common.h>
 #include <util/time.h>
 #include <validation.h>
 
+#include <algorithm>
+
 #include <boost/test/unit_test.hpp>
 
 BOOST_AUTO_TEST_SUITE(txindex_tests)
@@ -76,4 +80,74 @@ BOOST_FIXTURE_TEST_CASE(txindex_initial_sync, TestChain100Setup)
     SyncWithValidationInterfaceQueue();
 }
 
+BOOST_FIXTURE_TEST_CASE(txindex_find_txs, RegTestingSetup)
+{
+    std::vector<uint256> txids;
+    for (int i = 0; i < 20; ++i) {
+        txids.push_back(MineBlock(m_node, P2WSH_OP_TRUE).prevout.hash);
+    }
+
+    TxIndex txindex(interfaces::MakeChain(m_node), 1 << 20, true);
+    BOOST_REQUIRE(txindex.Start());
+    constexpr int64_t timeout_ms = 10 * 1000;
+    int64_t time_start = GetTimeMillis();
+    while (!txindex.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+        UninterruptibleSleep(std::chrono::milliseconds{100});
+    }
+
+    // Look up the transactions out of file order, with a duplicate and an unknown transaction.
+    std::vector<uint256> lookups{txids.rbegin(), txids.rend()};
+    std::swap(lookups[3], lookups[12]);
+    lookups.push_back(txids[5]);
+    lookups.push_back(uint256::ONE);
+
+    std::vector<uint256> block_hashes;
+    std::vector<CTransactionRef> txs;
+    BOOST_CHECK_EQUAL(txindex.FindTxs(lookups, block_hashes, txs), lookups.size() - 1);
+    BOOST_REQUIRE_EQUAL(txs.size(), lookups.size());
+    BOOST_REQUIRE_EQUAL(block_hashes.size(), lookups.size());
+    for (size_t i = 0; i < lookups.size() - 1; ++i) {
+        BOOST_REQUIRE(txs[i]);
+        BOOST_CHECK(txs[i]->GetHash() == lookups[i]);
+        WITH_LOCK(::cs_main, BOOST_CHECK(m_node.chainman->m_blockman.LookupBlockIndex(block_hashes[i])));
+    }
+    BOOST_CHECK(!txs.back());
+    BOOST_CHECK(block_hashes.back().IsNull());
+
+    // All found transactions are cached, so they are found again without reading them.
+    IndexCacheStats stats{txindex.GetTxCacheStats()};
+    BOOST_CHECK_EQUAL(stats.entries, txids.size());
+    BOOST_CHECK_EQUAL(stats.hits, 0U);
+    BOOST_CHECK_EQUAL(stats.misses, lookups.size());
+    uint256 block_hash;
+    CTransactionRef tx;
+    BOOST_CHECK(txindex.FindTx(txids[7], block_hash, tx));
+    BOOST_CHECK(tx->GetHash() == txids[7]);
+    BOOST_CHECK(block_hash == block_hashes[std::find(lookups.begin(), lookups.end(), txids[7]) - lookups.begin()]);
+    BOOST_CHECK(!txindex.FindTx(uint256::ONE, block_hash, tx));
+    stats = txindex.GetTxCacheStats();
+    BOOST_CHECK_EQUAL(stats.hits, 1U);
+    BOOST_CHECK_EQUAL(stats.misses, lookups.size() + 1);
+
+    // Without a cache, transactions are always read from disk.
+    TxIndex uncached_txindex(interfaces::MakeChain(m_node), 1 << 20, true, false, /*tx_cache_size=*/0);
+    BOOST_REQUIRE(uncached_txindex.Start());
+    time_start = GetTimeMillis();
+    while (!uncached_txindex.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+        UninterruptibleSleep(std::chrono::milliseconds{100});
+    }
+    std::vector<CTransactionRef> uncached_txs;
+    BOOST_CHECK_EQUAL(uncached_txindex.FindTxs(lookups, block_hashes, uncached_txs), lookups.size() - 1);
+    BOOST_CHECK_EQUAL(uncached_txindex.GetTxCacheStats().entries, 0U);
+    for (size_t i = 0; i < lookups.size() - 1; ++i) {
+        BOOST_CHECK(*uncached_txs[i] == *txs[i]);
+    }
+
+    txindex.Stop();
+    uncached_txindex.Stop();
+    SyncWithValidationInterfaceQueue();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
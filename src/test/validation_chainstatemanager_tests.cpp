@@ -194,14 +194,19 @@ BOOST_FIXTURE_TEST_CASE(chainstatemanager_activate_snapshot, TestChain100Setup)
     // Should not load malleated snapshots
     BOOST_REQUIRE(!CreateAndActivateUTXOSnapshot(
         m_node, m_path_root, [](AutoFile& auto_infile, SnapshotMetadata& metadata) {
-            // A UTXO is missing but count is correct
-            metadata.m_coins_count -= 1;
-
-            COutPoint outpoint;
-            Coin coin;
-
-            auto_infile >> outpoint;
-            auto_infile >> coin;
+            // The UTXOs of a transaction are missing but count is correct
+            uint256 txid;
+            auto_infile >> txid;
+            const uint64_t num_coins{ReadCompactSize(auto_infile)};
+            metadata.m_coins_count -= num_coins;
+
+            for (uint64_t i = 0; i < num_coins; ++i) {
+                uint32_t n;
+                Coin coin;
+
+                auto_infile >> VARINT(n);
+                auto_infile >> coin;
+            }
     }));
     BOOST_REQUIRE(!CreateAndActivateUTXOSnapshot(
         m_node, m_path_root, [](AutoFile& auto_infile, SnapshotMetadata& metadata) {
@@ -6,6 +6,7 @@
 #include <txdb.h>
 
 #include <chain.h>
+#include <kernel/coinstats.h>
 #include <pow.h>
 #include <random.h>
 #include <shutdown.h>
@@ -14,6 +15,8 @@
 #include <util/translation.h>
 #include <util/vector.h>
 
+#include <algorithm>
+#include <optional>
 #include <stdint.h>
 
 static constexpr uint8_t DB_COIN{'C'};
@@ -25,6 +28,9 @@ static constexpr uint8_t DB_HEAD_BLOCKS{'H'};
 static constexpr uint8_t DB_FLAG{'F'};
 static constexpr uint8_t DB_REINDEX_FLAG{'R'};
 static constexpr uint8_t DB_LAST_BLOCK{'l'};
+static constexpr uint8_t DB_RUNNING_STATS{'U'};
+static constexpr uint8_t DB_BLOCK_INDEX_SNAPSHOT{'S'};
+static constexpr uint8_t DB_VERIFY_CHAIN_PROGRESS{'V'};
 
 // Keys used in previous version that might still be found in the DB:
 static constexpr uint8_t DB_COINS{'c'};
@@ -172,6 +178,20 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
     return ret;
 }
 
+bool CCoinsViewDB::ReadRunningCoinsStats(uint256& block_hash, kernel::RunningCoinsStats& stats) const
+{
+    std::pair<uint256, kernel::RunningCoinsStats> value;
+    if (!m_db->Read(DB_RUNNING_STATS, value)) return false;
+    block_hash = value.first;
+    stats = std::move(value.second);
+    return true;
+}
+
+bool CCoinsViewDB::WriteRunningCoinsStats(const uint256& block_hash, const kernel::RunningCoinsStats& stats)
+{
+    return m_db->Write(DB_RUNNING_STATS, std::make_pair(block_hash, stats));
+}
+
 size_t CCoinsViewDB::EstimateSize() const
 {
     return m_db->EstimateSize(DB_COIN, uint8_t(DB_COIN + 1));
@@ -218,6 +238,13 @@ public:
 private:
     std::unique_ptr<CDBIterator> pcursor;
     std::pair<char, COutPoint> keyTmp;
+    //! If set, iteration stops before the first coin whose txid is not below this one.
+    std::optional<uint256> m_end_txid;
+
+    //! Position the cursor at the first coin whose txid is not below begin_txid.
+    void Seek(const uint256& begin_txid);
+    //! Cache the key the iterator points at, invalidating the cursor at the end of its range.
+    void CacheKey();
 
     friend class CCoinsViewDB;
 };
@@ -229,16 +256,48 @@ std::unique_ptr<CCoinsViewCursor> CCoinsViewDB::Cursor() const
     /* It seems that there are no "const iterators" for LevelDB.  Since we
        only need read operations on it, use a const-cast to get around
        that restriction.  */
-    i->pcursor->Seek(DB_COIN);
+    i->Seek(uint256{});
+    return i;
+}
+
+std::vector<std::unique_ptr<CCoinsViewCursor>> CCoinsViewDB::Cursors(size_t num_ranges) const
+{
+    // Txids are uniformly distributed, so splitting on the first byte of the
+    // txid (the first byte of the key after DB_COIN) balances the ranges.
+    num_ranges = std::clamp<size_t>(num_ranges, 1, 256);
+    auto iterators{const_cast<CDBWrapper&>(*m_db).NewIterators(num_ranges)};
+    const uint256 best_block{GetBestBlock()};
+
+    std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
+    for (size_t n = 0; n < num_ranges; ++n) {
+        auto i = std::make_unique<CCoinsViewDBCursor>(iterators[n].release(), best_block);
+        if (n + 1 < num_ranges) {
+            i->m_end_txid = uint256{};
+            *i->m_end_txid->begin() = (n + 1) * 256 / num_ranges;
+        }
+        uint256 begin_txid;
+        *begin_txid.begin() = n * 256 / num_ranges;
+        i->Seek(begin_txid);
+        cursors.push_back(std::move(i));
+    }
+    return cursors;
+}
+
+void CCoinsViewDBCursor::Seek(const uint256& begin_txid)
+{
+    pcursor->Seek(std::make_pair(DB_COIN, begin_txid));
     // Cache key of first record
-    if (i->pcursor->Valid()) {
-        CoinEntry entry(&i->keyTmp.second);
-        i->pcursor->GetKey(entry);
-        i->keyTmp.first = entry.key;
+    CacheKey();
+}
+
+void CCoinsViewDBCursor::CacheKey()
+{
+    CoinEntry entry(&keyTmp.second);
+    if (!pcursor->Valid() || !pcursor->GetKey(entry) || (m_end_txid && !(keyTmp.second.hash < *m_end_txid))) {
+        keyTmp.first = 0; // Make sure Valid() and GetKey() return false after the last record
     } else {
-        i->keyTmp.first = 0; // Make sure Valid() and GetKey() return false
+        keyTmp.first = entry.key;
     }
-    return i;
 }
 
 bool CCoinsViewDBCursor::GetKey(COutPoint &key) const
@@ -264,12 +323,7 @@ bool CCoinsViewDBCursor::Valid() const
 void CCoinsViewDBCursor::Next()
 {
     pcursor->Next();
-    CoinEntry entry(&keyTmp.second);
-    if (!pcursor->Valid() || !pcursor->GetKey(entry)) {
-        keyTmp.first = 0; // Invalidate cached key after last record so that Valid() and GetKey() return false
-    } else {
-        keyTmp.first = entry.key;
-    }
+    CacheKey();
 }
 
 bool CBlockTreeDB::WriteBatchSync(const std::vector<std::pair<int, const CBlockFileInfo*> >& fileInfo, int nLastFile, const std::vector<const CBlockIndex*>& blockinfo) {
@@ -281,9 +335,36 @@ bool CBlockTreeDB::WriteBatchSync(const std::vector<std::pair<int, const CBlockF
     for (std::vector<const CBlockIndex*>::const_iterator it=blockinfo.begin(); it != blockinfo.end(); it++) {
         batch.Write(std::make_pair(DB_BLOCK_INDEX, (*it)->GetBlockHash()), CDiskBlockIndex(*it));
     }
+    // Any block index snapshot no longer matches the database
+    batch.Erase(DB_BLOCK_INDEX_SNAPSHOT);
     return WriteBatch(batch, true);
 }
 
+bool CBlockTreeDB::WriteBlockIndexSnapshotChecksum(const uint256& checksum)
+{
+    return Write(DB_BLOCK_INDEX_SNAPSHOT, checksum, /*fSync=*/true);
+}
+
+bool CBlockTreeDB::ReadBlockIndexSnapshotChecksum(uint256& checksum)
+{
+    return Read(DB_BLOCK_INDEX_SNAPSHOT, checksum);
+}
+
+bool CBlockTreeDB::WriteVerifyChainProgress(const VerifyChainProgress& progress)
+{
+    return Write(DB_VERIFY_CHAIN_PROGRESS, progress);
+}
+
+bool CBlockTreeDB::ReadVerifyChainProgress(VerifyChainProgress& progress)
+{
+    return Read(DB_VERIFY_CHAIN_PROGRESS, progress);
+}
+
+bool CBlockTreeDB::EraseVerifyChainProgress()
+{
+    return Erase(DB_VERIFY_CHAIN_PROGRESS);
+}
+
 bool CBlockTreeDB::WriteFlag(const std::string &name, bool fValue) {
     return Write(std::make_pair(DB_FLAG, name), fValue ? uint8_t{'1'} : uint8_t{'0'});
 }
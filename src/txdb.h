@@ -8,7 +8,9 @@
 
 #include <coins.h>
 #include <dbwrapper.h>
+#include <serialize.h>
 #include <sync.h>
+#include <uint256.h>
 
 #include <memory>
 #include <optional>
@@ -18,10 +20,12 @@
 
 class CBlockFileInfo;
 class CBlockIndex;
-class uint256;
 namespace Consensus {
 struct Params;
 };
+namespace kernel {
+struct RunningCoinsStats;
+} // namespace kernel
 struct bilingual_str;
 
 //! -dbcache default (MiB)
@@ -38,6 +42,8 @@ static const int64_t nMaxBlockDBCache = 2;
 // Unlike for the UTXO database, for the txindex scenario the leveldb cache make
 // a meaningful difference: https://github.com/bitcoin/bitcoin/pull/8273#issuecomment-229601991
 static const int64_t nMaxTxIndexCache = 1024;
+//! Max memory allocated to the address index DB specific cache, if -addressindex (MiB)
+static const int64_t nMaxAddressIndexCache = 1024;
 //! Max memory allocated to all block filter index caches combined in MiB.
 static const int64_t max_filter_index_cache = 1024;
 //! Max memory allocated to coin DB specific cache (MiB)
@@ -65,6 +71,8 @@ public:
     std::vector<uint256> GetHeadBlocks() const override;
     bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
     std::unique_ptr<CCoinsViewCursor> Cursor() const override;
+    //! Split the coins into ranges of txids that share the same first byte, which hold about the same number of coins.
+    std::vector<std::unique_ptr<CCoinsViewCursor>> Cursors(size_t num_ranges) const override;
 
     //! Whether an unsupported database format is used.
     bool NeedsUpgrade();
@@ -72,6 +80,27 @@ public:
 
     //! Dynamically alter the underlying leveldb cache size.
     void ResizeCache(size_t new_cache_size) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
+    //! Read the running UTXO set statistics, along with the block whose coins they describe.
+    bool ReadRunningCoinsStats(uint256& block_hash, kernel::RunningCoinsStats& stats) const;
+    //! Write the running UTXO set statistics of the coins at block_hash.
+    bool WriteRunningCoinsStats(const uint256& block_hash, const kernel::RunningCoinsStats& stats);
+};
+
+/** Progress of a chain verification running in the background, to resume it after a restart */
+struct VerifyChainProgress {
+    int check_level{0};
+    //! The blocks above this height are verified
+    int target_height{0};
+    //! The next block to check at levels 0 to 2, null once they are done
+    uint256 next_block;
+    int blocks_checked{0};
+    int blocks_total{0};
+
+    SERIALIZE_METHODS(VerifyChainProgress, obj)
+    {
+        READWRITE(obj.check_level, obj.target_height, obj.next_block, obj.blocks_checked, obj.blocks_total);
+    }
 };
 
 /** Access to the block database (blocks/index/) */
@@ -87,6 +116,14 @@ public:
     void ReadReindexing(bool &fReindexing);
     bool WriteFlag(const std::string &name, bool fValue);
     bool ReadFlag(const std::string &name, bool &fValue);
+    //! Record the checksum of the block index snapshot that matches the
+    //! database. The next WriteBatchSync() erases it.
+    bool WriteBlockIndexSnapshotChecksum(const uint256& checksum);
+    bool ReadBlockIndexSnapshotChecksum(uint256& checksum);
+    //! Record the progress of a background chain verification; it is erased once the verification is done.
+    bool WriteVerifyChainProgress(const VerifyChainProgress& progress);
+    bool ReadVerifyChainProgress(VerifyChainProgress& progress);
+    bool EraseVerifyChainProgress();
     bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex)
         EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 };
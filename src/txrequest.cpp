@@ -53,6 +53,27 @@ enum class State : uint8_t {
 //! Type alias for sequence numbers.
 using SequenceNumber = uint64_t;
 
+//! Type alias for priorities.
+using Priority = uint64_t;
+
+/** A functor with embedded salt that computes priority of an announcement.
+ *
+ * Higher priorities are selected first.
+ */
+class PriorityComputer {
+    const uint64_t m_k0, m_k1;
+public:
+    explicit PriorityComputer(bool deterministic) :
+        m_k0{deterministic ? 0 : GetRand(0xFFFFFFFFFFFFFFFF)},
+        m_k1{deterministic ? 0 : GetRand(0xFFFFFFFFFFFFFFFF)} {}
+
+    Priority operator()(const uint256& txhash, NodeId peer, bool preferred) const
+    {
+        uint64_t low_bits = CSipHasher(m_k0, m_k1).Write(txhash.begin(), txhash.size()).Write(peer).Finalize() >> 1;
+        return low_bits | uint64_t{preferred} << 63;
+    }
+};
+
 /** An announcement. This is the data we track for each txid or wtxid that is announced to us by each peer. */
 struct Announcement {
     /** Txid or wtxid that was announced. */
@@ -61,6 +82,9 @@ struct Announcement {
     std::chrono::microseconds m_time;
     /** What peer the request was from. */
     const NodeId m_peer;
+    /** The priority of this announcement. Only relevant while CANDIDATE_READY, but cached from construction so
+     *  that ordering comparisons in the ByTxHash index do not need to recompute a SipHash each time. */
+    const Priority m_priority;
     /** What sequence number this announcement has. */
     const SequenceNumber m_sequence : 59;
     /** Whether the request is preferred. */
@@ -99,37 +123,12 @@ struct Announcement {
 
     /** Construct a new announcement from scratch, initially in CANDIDATE_DELAYED state. */
     Announcement(const GenTxid& gtxid, NodeId peer, bool preferred, std::chrono::microseconds reqtime,
-        SequenceNumber sequence) :
-        m_txhash(gtxid.GetHash()), m_time(reqtime), m_peer(peer), m_sequence(sequence), m_preferred(preferred),
+        SequenceNumber sequence, const PriorityComputer& computer) :
+        m_txhash(gtxid.GetHash()), m_time(reqtime), m_peer(peer),
+        m_priority(computer(gtxid.GetHash(), peer, preferred)), m_sequence(sequence), m_preferred(preferred),
         m_is_wtxid(gtxid.IsWtxid()), m_state(static_cast<uint8_t>(State::CANDIDATE_DELAYED)) {}
 };
 
-//! Type alias for priorities.
-using Priority = uint64_t;
-
-/** A functor with embedded salt that computes priority of an announcement.
- *
- * Higher priorities are selected first.
- */
-class PriorityComputer {
-    const uint64_t m_k0, m_k1;
-public:
-    explicit PriorityComputer(bool deterministic) :
-        m_k0{deterministic ? 0 : GetRand(0xFFFFFFFFFFFFFFFF)},
-        m_k1{deterministic ? 0 : GetRand(0xFFFFFFFFFFFFFFFF)} {}
-
-    Priority operator()(const uint256& txhash, NodeId peer, bool preferred) const
-    {
-        uint64_t low_bits = CSipHasher(m_k0, m_k1).Write(txhash.begin(), txhash.size()).Write(peer).Finalize() >> 1;
-        return low_bits | uint64_t{preferred} << 63;
-    }
-
-    Priority operator()(const Announcement& ann) const
-    {
-        return operator()(ann.m_txhash, ann.m_peer, ann.m_preferred);
-    }
-};
-
 // Definitions for the 3 indexes used in the main data structure.
 //
 // Each index has a By* type to identify it, a By*View data type to represent the view of announcement it is sorted
@@ -166,14 +165,12 @@ struct ByPeerViewExtractor
 //   deleted.
 struct ByTxHash {};
 using ByTxHashView = std::tuple<const uint256&, State, Priority>;
-class ByTxHashViewExtractor {
-    const PriorityComputer& m_computer;
-public:
-    explicit ByTxHashViewExtractor(const PriorityComputer& computer) : m_computer(computer) {}
+struct ByTxHashViewExtractor
+{
     using result_type = ByTxHashView;
     result_type operator()(const Announcement& ann) const
     {
-        const Priority prio = (ann.GetState() == State::CANDIDATE_READY) ? m_computer(ann) : 0;
+        const Priority prio = (ann.GetState() == State::CANDIDATE_READY) ? ann.m_priority : 0;
         return ByTxHashView{ann.m_txhash, ann.GetState(), prio};
     }
 };
@@ -233,6 +230,7 @@ struct PeerInfo {
     size_t m_total = 0; //!< Total number of announcements for this peer.
     size_t m_completed = 0; //!< Number of COMPLETED announcements for this peer.
     size_t m_requested = 0; //!< Number of REQUESTED announcements for this peer.
+    size_t m_candidate_best = 0; //!< Number of CANDIDATE_BEST announcements for this peer.
 };
 
 /** Per-txhash statistics object. Only used for sanity checking. */
@@ -257,8 +255,8 @@ struct TxHashInfo
 /** Compare two PeerInfo objects. Only used for sanity checking. */
 bool operator==(const PeerInfo& a, const PeerInfo& b)
 {
-    return std::tie(a.m_total, a.m_completed, a.m_requested) ==
-           std::tie(b.m_total, b.m_completed, b.m_requested);
+    return std::tie(a.m_total, a.m_completed, a.m_requested, a.m_candidate_best) ==
+           std::tie(b.m_total, b.m_completed, b.m_requested, b.m_candidate_best);
 };
 
 /** (Re)compute the PeerInfo map from the index. Only used for sanity checking. */
@@ -270,6 +268,7 @@ std::unordered_map<NodeId, PeerInfo> RecomputePeerInfo(const Index& index)
         ++info.m_total;
         info.m_requested += (ann.GetState() == State::REQUESTED);
         info.m_completed += (ann.GetState() == State::COMPLETED);
+        info.m_candidate_best += (ann.GetState() == State::CANDIDATE_BEST);
     }
     return ret;
 }
@@ -287,10 +286,11 @@ std::map<uint256, TxHashInfo> ComputeTxHashInfo(const Index& index, const Priori
         info.m_requested += (ann.GetState() == State::REQUESTED);
         // And track the priority of the best CANDIDATE_READY/CANDIDATE_BEST announcements.
         if (ann.GetState() == State::CANDIDATE_BEST) {
-            info.m_priority_candidate_best = computer(ann);
+            info.m_priority_candidate_best = computer(ann.m_txhash, ann.m_peer, ann.m_preferred);
         }
         if (ann.GetState() == State::CANDIDATE_READY) {
-            info.m_priority_best_candidate_ready = std::max(info.m_priority_best_candidate_ready, computer(ann));
+            info.m_priority_best_candidate_ready = std::max(info.m_priority_best_candidate_ready,
+                computer(ann.m_txhash, ann.m_peer, ann.m_preferred));
         }
         // Also keep track of which peers this txhash has an announcement for (so we can detect duplicates).
         info.m_peers.push_back(ann.m_peer);
@@ -327,6 +327,12 @@ public:
         // on m_index. It also verifies the invariant that no PeerInfo announcements with m_total==0 exist.
         assert(m_peerinfo == RecomputePeerInfo(m_index));
 
+        // Verify that the priorities cached in each announcement (and used for ordering the ByTxHash index) match
+        // what the priority computer produces.
+        for (const Announcement& ann : m_index) {
+            assert(ann.m_priority == m_computer(ann.m_txhash, ann.m_peer, ann.m_preferred));
+        }
+
         // Calculate per-txhash statistics from m_index, and validate invariants.
         for (auto& item : ComputeTxHashInfo(m_index, m_computer)) {
             TxHashInfo& info = item.second;
@@ -378,6 +384,7 @@ private:
         auto peerit = m_peerinfo.find(it->m_peer);
         peerit->second.m_completed -= it->GetState() == State::COMPLETED;
         peerit->second.m_requested -= it->GetState() == State::REQUESTED;
+        peerit->second.m_candidate_best -= it->GetState() == State::CANDIDATE_BEST;
         if (--peerit->second.m_total == 0) m_peerinfo.erase(peerit);
         return m_index.get<Tag>().erase(it);
     }
@@ -389,9 +396,11 @@ private:
         auto peerit = m_peerinfo.find(it->m_peer);
         peerit->second.m_completed -= it->GetState() == State::COMPLETED;
         peerit->second.m_requested -= it->GetState() == State::REQUESTED;
+        peerit->second.m_candidate_best -= it->GetState() == State::CANDIDATE_BEST;
         m_index.get<Tag>().modify(it, std::move(modifier));
         peerit->second.m_completed += it->GetState() == State::COMPLETED;
         peerit->second.m_requested += it->GetState() == State::REQUESTED;
+        peerit->second.m_candidate_best += it->GetState() == State::CANDIDATE_BEST;
     }
 
     //! Convert a CANDIDATE_DELAYED announcement into a CANDIDATE_READY. If this makes it the new best
@@ -414,8 +423,8 @@ private:
             // already.
             Modify<ByTxHash>(it, [](Announcement& ann){ ann.SetState(State::CANDIDATE_BEST); });
         } else if (it_next->GetState() == State::CANDIDATE_BEST) {
-            Priority priority_old = m_computer(*it_next);
-            Priority priority_new = m_computer(*it);
+            Priority priority_old = it_next->m_priority;
+            Priority priority_new = it->m_priority;
             if (priority_new > priority_old) {
                 // There is a CANDIDATE_BEST announcement already, but this one is better.
                 Modify<ByTxHash>(it_next, [](Announcement& ann){ ann.SetState(State::CANDIDATE_READY); });
@@ -522,15 +531,9 @@ private:
 
 public:
     explicit Impl(bool deterministic) :
-        m_computer(deterministic),
-        // Explicitly initialize m_index as we need to pass a reference to m_computer to ByTxHashViewExtractor.
-        m_index(boost::make_tuple(
-            boost::make_tuple(ByPeerViewExtractor(), std::less<ByPeerView>()),
-            boost::make_tuple(ByTxHashViewExtractor(m_computer), std::less<ByTxHashView>()),
-            boost::make_tuple(ByTimeViewExtractor(), std::less<ByTimeView>())
-        )) {}
-
-    // Disable copying and assigning (a default copy won't work due the stateful ByTxHashViewExtractor).
+        m_computer(deterministic) {}
+
+    // Disable copying and assigning.
     Impl(const Impl&) = delete;
     Impl& operator=(const Impl&) = delete;
 
@@ -584,7 +587,7 @@ public:
         // Try creating the announcement with CANDIDATE_DELAYED state (which will fail due to the uniqueness
         // of the ByPeer index if a non-CANDIDATE_BEST announcement already exists with the same txhash and peer).
         // Bail out in that case.
-        auto ret = m_index.get<ByPeer>().emplace(gtxid, peer, preferred, reqtime, m_current_sequence);
+        auto ret = m_index.get<ByPeer>().emplace(gtxid, peer, preferred, reqtime, m_current_sequence, m_computer);
         if (!ret.second) return;
 
         // Update accounting metadata.
@@ -599,8 +602,14 @@ public:
         // Move time.
         SetTimePoint(now, expired);
 
+        // GetRequestable is called for every peer on every SendMessages pass, and most of the time there is
+        // nothing to request. Use the per-peer statistics to avoid walking the ByPeer index in that case.
+        auto peerit = m_peerinfo.find(peer);
+        if (peerit == m_peerinfo.end() || peerit->second.m_candidate_best == 0) return {};
+
         // Find all CANDIDATE_BEST announcements for this peer.
         std::vector<const Announcement*> selected;
+        selected.reserve(peerit->second.m_candidate_best);
         auto it_peer = m_index.get<ByPeer>().lower_bound(ByPeerView{peer, true, uint256::ZERO});
         while (it_peer != m_index.get<ByPeer>().end() && it_peer->m_peer == peer &&
             it_peer->GetState() == State::CANDIDATE_BEST) {
@@ -5,11 +5,14 @@
 #ifndef BITCOIN_UTIL_GOLOMBRICE_H
 #define BITCOIN_UTIL_GOLOMBRICE_H
 
-#include <util/fastrange.h>
-
+#include <crypto/common.h>
+#include <span.h>
 #include <streams.h>
+#include <util/fastrange.h>
 
 #include <cstdint>
+#include <ios>
+#include <vector>
 
 template <typename OStream>
 void GolombRiceEncode(BitStreamWriter<OStream>& bitwriter, uint8_t P, uint64_t x)
@@ -42,4 +45,144 @@ uint64_t GolombRiceDecode(BitStreamReader<IStream>& bitreader, uint8_t P)
     return (q << P) + r;
 }
 
+/** Golomb-Rice encoder appending to a byte vector. Produces the same encoding
+ * as GolombRiceEncode() with a BitStreamWriter, but collects bits in a 64-bit
+ * buffer and writes whole bytes, instead of going through the stream one
+ * partial byte at a time. */
+class GolombRiceEncoder
+{
+private:
+    std::vector<unsigned char>& m_out;
+
+    /// Pending bits, in the m_bits least significant bits of m_buffer.
+    uint64_t m_buffer{0};
+    int m_bits{0};
+
+    /** Append the nbits (at most 32) least significant bits of value. */
+    void WriteBits(uint64_t value, int nbits)
+    {
+        while (m_bits >= 8) {
+            m_bits -= 8;
+            m_out.push_back(static_cast<unsigned char>(m_buffer >> m_bits));
+        }
+        m_buffer = (m_buffer << nbits) | (value & ((uint64_t{1} << nbits) - 1));
+        m_bits += nbits;
+    }
+
+public:
+    explicit GolombRiceEncoder(std::vector<unsigned char>& out) : m_out(out) {}
+
+    void Encode(uint8_t P, uint64_t x)
+    {
+        // Write quotient as unary-encoded: q 1's followed by one 0.
+        for (uint64_t q = x >> P; q > 0;) {
+            const int nbits = q < 32 ? static_cast<int>(q) : 32;
+            WriteBits(~uint64_t{0}, nbits);
+            q -= nbits;
+        }
+        WriteBits(0, 1);
+
+        // Write the remainder in P bits.
+        if (P > 32) WriteBits(x >> 32, P - 32);
+        WriteBits(x, P > 32 ? 32 : P);
+    }
+
+    /** Write out any pending bits, padding the last byte with zeros. */
+    void Flush()
+    {
+        while (m_bits >= 8) {
+            m_bits -= 8;
+            m_out.push_back(static_cast<unsigned char>(m_buffer >> m_bits));
+        }
+        if (m_bits > 0) {
+            m_out.push_back(static_cast<unsigned char>(m_buffer << (8 - m_bits)));
+            m_bits = 0;
+        }
+    }
+};
+
+/** Golomb-Rice decoder reading from a byte span. Decodes the same encoding as
+ * GolombRiceDecode() with a BitStreamReader, but refills a 64-bit buffer a
+ * word at a time and reads runs of the unary quotient by counting leading
+ * ones, rather than extracting one bit per call. Throws std::ios_base::failure
+ * when reading past the end of the data. */
+class GolombRiceDecoder
+{
+private:
+    Span<const unsigned char> m_data;
+
+    /// Buffered bits not returned yet, in the m_bits most significant bits of
+    /// m_buffer. The remaining bits are zero.
+    uint64_t m_buffer{0};
+    int m_bits{0};
+
+    void Refill()
+    {
+        if (m_bits > 56) return;
+        if (m_data.size() >= 8) {
+            // Load as many whole bytes as fit into the buffer at once.
+            const int nbytes{(64 - m_bits) / 8};
+            uint64_t word{ReadBE64(m_data.data())};
+            if (nbytes < 8) word &= ~(~uint64_t{0} >> (8 * nbytes));
+            m_buffer |= word >> m_bits;
+            m_bits += 8 * nbytes;
+            m_data = m_data.subspan(nbytes);
+        } else {
+            while (m_bits <= 56 && !m_data.empty()) {
+                m_buffer |= uint64_t{m_data[0]} << (56 - m_bits);
+                m_bits += 8;
+                m_data = m_data.subspan(1);
+            }
+        }
+    }
+
+    void Consume(int nbits)
+    {
+        m_buffer = nbits < 64 ? m_buffer << nbits : 0;
+        m_bits -= nbits;
+    }
+
+    /** Read nbits (at most 32) bits. */
+    uint64_t ReadBits(int nbits)
+    {
+        if (nbits == 0) return 0;
+        Refill();
+        if (m_bits < nbits) throw std::ios_base::failure("GolombRiceDecoder: end of data");
+        const uint64_t ret{m_buffer >> (64 - nbits)};
+        Consume(nbits);
+        return ret;
+    }
+
+public:
+    explicit GolombRiceDecoder(Span<const unsigned char> data) : m_data(data) {}
+
+    uint64_t Decode(uint8_t P)
+    {
+        // Read unary-encoded quotient: q 1's followed by one 0.
+        uint64_t q = 0;
+        while (true) {
+            Refill();
+            if (m_bits == 0) throw std::ios_base::failure("GolombRiceDecoder: end of data");
+            // Bits past m_bits are zero, so the run of ones ends within the
+            // buffer; it may continue into the next refill though.
+            const int ones{64 - static_cast<int>(CountBits(~m_buffer))};
+            if (ones < m_bits) {
+                q += ones;
+                Consume(ones + 1);
+                break;
+            }
+            q += m_bits;
+            Consume(m_bits);
+        }
+
+        uint64_t r = P > 32 ? ReadBits(P - 32) << 32 : 0;
+        r |= ReadBits(P > 32 ? 32 : P);
+
+        return (q << P) + r;
+    }
+
+    /** Number of whole bytes not read from at all. */
+    size_t RemainingBytes() const { return m_data.size() + m_bits / 8; }
+};
+
 #endif // BITCOIN_UTIL_GOLOMBRICE_H
@@ -54,7 +54,8 @@ public:
 
 struct FilterHeaderHasher
 {
-    size_t operator()(const uint256& hash) const { return ReadLE64(hash.begin()); }
+    //! noexcept so that hash maps don't store the cheap hash in each node
+    size_t operator()(const uint256& hash) const noexcept { return ReadLE64(hash.begin()); }
 };
 
 /**
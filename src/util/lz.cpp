@@ -0,0 +1,134 @@
+// Copyright (c) 2022 The Garikcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/lz.h>
+
+#include <crypto/common.h>
+
+#include <algorithm>
+#include <cstring>
+
+/**
+ * Each sequence starts with a token holding the number of literals in its high
+ * nibble and the match length minus MIN_MATCH in its low nibble. A nibble of
+ * 15 means the length continues in the following bytes, which are added to it
+ * up to and including the first byte that is not 255. The literals follow,
+ * then the match as a 2-byte little-endian offset back from the current output
+ * position, then the rest of the match length. The last sequence has no match.
+ */
+static constexpr size_t MIN_MATCH{4};
+static constexpr size_t MAX_OFFSET{0xffff};
+//! The input ends with at least this many literals, so that matches are
+//! always followed by some and never run into the end of the input.
+static constexpr size_t LAST_LITERALS{5};
+static constexpr int HASH_BITS{16};
+
+static uint32_t HashSequence(const uint8_t* p)
+{
+    return (ReadLE32(p) * 2654435761U) >> (32 - HASH_BITS);
+}
+
+static void WriteLength(std::vector<uint8_t>& output, size_t length)
+{
+    for (length -= 15; length >= 255; length -= 255) output.push_back(255);
+    output.push_back(length);
+}
+
+static void WriteSequence(std::vector<uint8_t>& output, Span<const uint8_t> literals, size_t offset, size_t match_length)
+{
+    const size_t match_code{match_length > 0 ? match_length - MIN_MATCH : 0};
+    output.push_back((std::min<size_t>(literals.size(), 15) << 4) | std::min<size_t>(match_code, 15));
+    if (literals.size() >= 15) WriteLength(output, literals.size());
+    output.insert(output.end(), literals.begin(), literals.end());
+    if (match_length == 0) return;
+    output.push_back(offset & 0xff);
+    output.push_back(offset >> 8);
+    if (match_code >= 15) WriteLength(output, match_code);
+}
+
+std::vector<uint8_t> LZCompress(Span<const uint8_t> input)
+{
+    std::vector<uint8_t> output;
+    output.reserve(input.size() + input.size() / 255 + 16);
+    const uint8_t* const data{input.data()};
+    size_t anchor{0};
+    if (input.size() > MIN_MATCH + LAST_LITERALS) {
+        // Position plus one of the last sequence with each hash, 0 for none
+        std::vector<uint32_t> table(size_t{1} << HASH_BITS);
+        const size_t match_limit{input.size() - LAST_LITERALS};
+        size_t pos{0};
+        size_t misses{0};
+        while (pos + MIN_MATCH <= match_limit) {
+            const uint32_t hash{HashSequence(data + pos)};
+            size_t match{table[hash]};
+            table[hash] = pos + 1;
+            if (match == 0 || pos - (match - 1) > MAX_OFFSET || ReadLE32(data + match - 1) != ReadLE32(data + pos)) {
+                // Step faster through data that doesn't compress
+                pos += 1 + (misses++ >> 5);
+                continue;
+            }
+            misses = 0;
+            --match;
+            size_t length{MIN_MATCH};
+            while (pos + length + 8 <= match_limit && ReadLE64(data + match + length) == ReadLE64(data + pos + length)) length += 8;
+            while (pos + length < match_limit && data[match + length] == data[pos + length]) ++length;
+            // The match may start within the literals before it
+            while (pos > anchor && match > 0 && data[pos - 1] == data[match - 1]) {
+                --pos;
+                --match;
+                ++length;
+            }
+            WriteSequence(output, input.subspan(anchor, pos - anchor), pos - match, length);
+            pos += length;
+            anchor = pos;
+            table[HashSequence(data + pos - 2)] = pos - 2 + 1;
+        }
+    }
+    WriteSequence(output, input.subspan(anchor), 0, 0);
+    return output;
+}
+
+bool LZDecompress(Span<const uint8_t> input, Span<uint8_t> output)
+{
+    size_t in{0};
+    size_t out{0};
+    const auto read_length{[&](size_t& length) {
+        if (length < 15) return true;
+        uint8_t byte;
+        do {
+            if (in == input.size()) return false;
+            byte = input[in++];
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }};
+    while (in < input.size()) {
+        const uint8_t token{input[in++]};
+        size_t literals{size_t{token} >> 4};
+        if (!read_length(literals)) return false;
+        if (literals > input.size() - in || literals > output.size() - out) return false;
+        std::memcpy(output.data() + out, input.data() + in, literals);
+        in += literals;
+        out += literals;
+        if (in == input.size()) break;
+
+        if (input.size() - in < 2) return false;
+        const size_t offset{ReadLE16(input.data() + in)};
+        in += 2;
+        size_t length{size_t{token} & 15};
+        if (!read_length(length)) return false;
+        length += MIN_MATCH;
+        if (offset == 0 || offset > out || length > output.size() - out) return false;
+        uint8_t* const dst{output.data() + out};
+        const uint8_t* const src{dst - offset};
+        if (offset >= length) {
+            std::memcpy(dst, src, length);
+        } else {
+            // The match overlaps the bytes it produces, such as a run of one byte
+            for (size_t i = 0; i < length; ++i) dst[i] = src[i];
+        }
+        out += length;
+    }
+    return out == output.size();
+}
@@ -0,0 +1,33 @@
+// Copyright (c) 2022 The Garikcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_LZ_H
+#define BITCOIN_UTIL_LZ_H
+
+#include <span.h>
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * A fast LZ77 codec for buffers of known size, in the spirit of LZ4: it
+ * trades compression ratio for speed, decompressing at memory bandwidth.
+ *
+ * The compressed data is a sequence of literal runs, each followed by a back
+ * reference of at least 4 bytes into the previous 64 KiB of output. The size
+ * of the uncompressed data is not part of it and has to be stored by the
+ * caller. Inputs must be smaller than 4 GiB.
+ */
+std::vector<uint8_t> LZCompress(Span<const uint8_t> input);
+
+/**
+ * Decompress data produced by LZCompress() into output, which must have the
+ * size of the uncompressed data.
+ *
+ * @returns false if the data is malformed or doesn't decompress to exactly
+ *          output.size() bytes. Never reads or writes out of bounds.
+ */
+[[nodiscard]] bool LZDecompress(Span<const uint8_t> input, Span<uint8_t> output);
+
+#endif // BITCOIN_UTIL_LZ_H
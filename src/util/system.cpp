@@ -1273,6 +1273,11 @@ void AllocateFileRange(FILE *file, unsigned int offset, unsigned int length) {
     }
     ftruncate(fileno(file), static_cast<off_t>(offset) + length);
 #else
+    #if defined(__linux__)
+    // Unlike posix_fallocate(), fallocate() only reserves the new range and
+    // fails rather than writing zeros on file systems that don't support it
+    if (0 == fallocate(fileno(file), 0, offset, length)) return;
+    #endif
     #if defined(HAVE_POSIX_FALLOCATE)
     // Version using posix_fallocate
     off_t nEndPos = (off_t)offset + length;
@@ -50,6 +50,7 @@
 #include <util/rbf.h>
 #include <util/strencodings.h>
 #include <util/system.h>
+#include <util/thread.h>
 #include <util/time.h>
 #include <util/trace.h>
 #include <util/translation.h>
@@ -59,19 +60,22 @@
 #include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
 #include <deque>
+#include <future>
+#include <map>
 #include <numeric>
 #include <optional>
 #include <string>
+#include <thread>
 
 using kernel::CCoinsStats;
-using kernel::CoinStatsHashType;
-using kernel::ComputeUTXOStats;
 using kernel::LoadMempool;
 
 using fsbridge::FopenFn;
 using node::BlockManager;
 using node::BlockMap;
+using node::BlockPrefetcher;
 using node::CBlockIndexHeightOnlyComparator;
 using node::CBlockIndexWorkComparator;
 using node::fImporting;
@@ -101,12 +105,6 @@ const std::vector<std::string> CHECKLEVEL_DOC {
     "level 4 tries to reconnect the blocks",
     "each level includes the checks of the previous levels",
 };
-/** The number of blocks to keep below the deepest prune lock.
- *  There is nothing special about this number. It is higher than what we
- *  expect to see in regular mainnet reorgs, but not so high that it would
- *  noticeably interfere with the pruning mechanism.
- * */
-static constexpr int PRUNE_LOCK_BUFFER{10};
 
 /**
  * Mutex to guard access to validation specific variables, such as reading
@@ -2348,20 +2346,8 @@ bool Chainstate::FlushStateToDisk(
         CoinsCacheSizeState cache_state = GetCoinsCacheSizeState();
         LOCK(m_blockman.cs_LastBlockFile);
         if (fPruneMode && (m_blockman.m_check_for_pruning || nManualPruneHeight > 0) && !fReindex) {
-            // make sure we don't prune above any of the prune locks bestblocks
-            // pruning is height-based
-            int last_prune{m_chain.Height()}; // last height we can prune
             std::optional<std::string> limiting_lock; // prune lock that actually was the limiting factor, only used for logging
-
-            for (const auto& prune_lock : m_blockman.m_prune_locks) {
-                if (prune_lock.second.height_first == std::numeric_limits<int>::max()) continue;
-                // Remove the buffer and one additional block here to get actual height that is outside of the buffer
-                const int lock_height{prune_lock.second.height_first - PRUNE_LOCK_BUFFER - 1};
-                last_prune = std::max(1, std::min(last_prune, lock_height));
-                if (last_prune == lock_height) {
-                    limiting_lock = prune_lock.first;
-                }
-            }
+            const int last_prune{m_blockman.GetPruneLockHeight(m_chain.Height(), limiting_lock)}; // last height we can prune
 
             if (limiting_lock) {
                 LogPrint(BCLog::PRUNE, "%s limited pruning to height %d\n", limiting_lock.value(), last_prune);
@@ -2374,8 +2360,8 @@ bool Chainstate::FlushStateToDisk(
             } else {
                 LOG_TIME_MILLIS_WITH_CATEGORY("find files to prune", BCLog::BENCH);
 
-                m_blockman.FindFilesToPrune(setFilesToPrune, m_params.PruneAfterHeight(), m_chain.Height(), last_prune, IsInitialBlockDownload());
-                m_blockman.m_check_for_pruning = false;
+                // Check again at the next flush if -prunebatch left files to prune
+                m_blockman.m_check_for_pruning = !m_blockman.FindFilesToPrune(setFilesToPrune, m_params.PruneAfterHeight(), m_chain.Height(), last_prune, IsInitialBlockDownload());
             }
             if (!setFilesToPrune.empty()) {
                 fFlushForPrune = true;
@@ -2448,6 +2434,12 @@ bool Chainstate::FlushStateToDisk(
             // Flush the chainstate (which may refer to block index entries).
             if (!CoinsTip().Flush())
                 return AbortNode(state, "Failed to write to coin database");
+            // Persist the running statistics for the coins just written. This is a separate write,
+            // so they are tagged with the block they belong to and ignored on load if they don't
+            // match the coins database.
+            if (m_coins_stats && !CoinsDB().WriteRunningCoinsStats(CoinsTip().GetBestBlock(), *m_coins_stats)) {
+                return AbortNode(state, "Failed to write UTXO set statistics to coin database");
+            }
             nLastFlush = nNow;
             full_flush_completed = true;
             TRACE5(utxocache, flush,
@@ -2458,7 +2450,7 @@ bool Chainstate::FlushStateToDisk(
                    (bool)fFlushForPrune);
         }
     }
-    if (full_flush_completed) {
+    if (full_flush_completed && this == &m_chainman.ActiveChainstate()) {
         // Update best block in wallet (so we can detect restored wallets).
         GetMainSignals().ChainStateFlushed(m_chain.GetLocator());
     }
@@ -2579,6 +2571,22 @@ void Chainstate::UpdateTip(const CBlockIndex* pindexNew)
   * disconnectpool (note that the caller is responsible for mempool consistency
   * in any case).
   */
+/**
+ * Apply the changes that flushing view would make to its base to the running statistics of the
+ * base: coins that are overwritten or spent are removed, and new unspent coins are added.
+ */
+static void UpdateRunningCoinsStats(kernel::RunningCoinsStats& stats, const CCoinsViewCache& base, const CCoinsViewCache& view)
+{
+    view.ForEachDirtyCoin([&](const COutPoint& outpoint, const Coin& coin, bool fresh) {
+        if (!fresh) {
+            // Not FRESH, so the coin was fetched from (and is cached in) the base.
+            const Coin& prev{base.AccessCoin(outpoint)};
+            if (!prev.IsSpent()) stats.RemoveCoin(outpoint, prev);
+        }
+        if (!coin.IsSpent()) stats.AddCoin(outpoint, coin);
+    });
+}
+
 bool Chainstate::DisconnectTip(BlockValidationState& state, DisconnectedBlockTransactions* disconnectpool)
 {
     AssertLockHeld(cs_main);
@@ -2600,6 +2608,7 @@ bool Chainstate::DisconnectTip(BlockValidationState& state, DisconnectedBlockTra
         assert(view.GetBestBlock() == pindexDelete->GetBlockHash());
         if (DisconnectBlock(block, pindexDelete, view) != DISCONNECT_OK)
             return error("DisconnectTip(): DisconnectBlock %s failed", pindexDelete->GetBlockHash().ToString());
+        if (m_coins_stats) UpdateRunningCoinsStats(*m_coins_stats, CoinsTip(), view);
         bool flushed = view.Flush();
         assert(flushed);
     }
@@ -2728,6 +2737,7 @@ bool Chainstate::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew,
                 InvalidBlockFound(pindexNew, state);
             return error("%s: ConnectBlock %s failed, %s", __func__, pindexNew->GetBlockHash().ToString(), state.ToString());
         }
+        if (m_coins_stats) UpdateRunningCoinsStats(*m_coins_stats, CoinsTip(), view);
         nTime3 = GetTimeMicros(); nTimeConnectTotal += nTime3 - nTime2;
         assert(nBlocksTotal > 0);
         LogPrint(BCLog::BENCH, "  - Connect total: %.2fms [%.2fs (%.2fms/blk)]\n", (nTime3 - nTime2) * MILLI, nTimeConnectTotal * MICRO, nTimeConnectTotal * MILLI / nBlocksTotal);
@@ -2993,6 +3003,7 @@ bool Chainstate::ActivateBestChain(BlockValidationState& state, std::shared_ptr<
             LOCK(cs_main);
             // Lock transaction pool for at least as long as it takes for connectTrace to be consumed
             LOCK(MempoolMutex());
+            const bool is_active{this == &m_chainman.ActiveChainstate()};
             CBlockIndex* starting_tip = m_chain.Tip();
             bool blocks_connected = false;
             do {
@@ -3023,9 +3034,13 @@ bool Chainstate::ActivateBestChain(BlockValidationState& state, std::shared_ptr<
                 }
                 pindexNewTip = m_chain.Tip();
 
-                for (const PerBlockConnectTrace& trace : connectTrace.GetBlocksConnected()) {
-                    assert(trace.pblock && trace.pindex);
-                    GetMainSignals().BlockConnected(trace.pblock, trace.pindex);
+                // Blocks connected by a background chainstate are beneath the
+                // active tip, so subscribers (wallets, indexes) aren't told about them.
+                if (is_active) {
+                    for (const PerBlockConnectTrace& trace : connectTrace.GetBlocksConnected()) {
+                        assert(trace.pblock && trace.pindex);
+                        GetMainSignals().BlockConnected(trace.pblock, trace.pindex);
+                    }
                 }
             } while (!m_chain.Tip() || (starting_tip && CBlockIndexWorkComparator()(m_chain.Tip(), starting_tip)));
             if (!blocks_connected) return true;
@@ -3035,7 +3050,7 @@ bool Chainstate::ActivateBestChain(BlockValidationState& state, std::shared_ptr<
 
             // Notify external listeners about the new tip.
             // Enqueue while holding cs_main to ensure that UpdatedBlockTip is called in the order in which blocks are connected
-            if (pindexFork != pindexNewTip) {
+            if (is_active && pindexFork != pindexNewTip) {
                 // Notify ValidationInterface subscribers
                 GetMainSignals().UpdatedBlockTip(pindexNewTip, pindexFork, fInitialDownload);
 
@@ -3446,8 +3461,7 @@ arith_uint256 CalculateHeadersWork(const std::vector<CBlockHeader>& headers)
 {
     arith_uint256 total_work{0};
     for (const CBlockHeader& header : headers) {
-        CBlockIndex dummy(header);
-        total_work += GetBlockProof(dummy);
+        total_work += GetBlockProof(header.nBits);
     }
     return total_work;
 }
@@ -3934,6 +3948,16 @@ bool Chainstate::LoadChainTip()
     assert(!coins_cache.GetBestBlock().IsNull()); // Never called when the coins view is empty
     const CBlockIndex* tip = m_chain.Tip();
 
+    if (m_chainman.m_options.running_coins_stats && !m_coins_stats) {
+        uint256 stats_block;
+        kernel::RunningCoinsStats stats;
+        if (CoinsDB().ReadRunningCoinsStats(stats_block, stats) && stats_block == coins_cache.GetBestBlock()) {
+            m_coins_stats = std::move(stats);
+        } else {
+            LogPrintf("No UTXO set statistics for the current chainstate, they will be computed on first use\n");
+        }
+    }
+
     if (tip && tip->GetBlockHash() == coins_cache.GetBestBlock()) {
         return true;
     }
@@ -3955,6 +3979,37 @@ bool Chainstate::LoadChainTip()
     return true;
 }
 
+std::optional<CCoinsStats> Chainstate::GetRunningCoinsStats(const std::function<void()>& interruption_point)
+{
+    if (!m_chainman.m_options.running_coins_stats) return std::nullopt;
+    {
+        LOCK(::cs_main);
+        if (m_coins_stats) {
+            const CBlockIndex* tip{Assert(m_chain.Tip())};
+            CCoinsStats stats{m_coins_stats->ToStats(tip->nHeight, tip->GetBlockHash())};
+            stats.nDiskSize = CoinsDB().EstimateSize();
+            return stats;
+        }
+    }
+
+    // The statistics are not known yet, e.g. after an upgrade or an unclean shutdown. Compute
+    // them from a snapshot of the coins database without holding cs_main, and adopt them if
+    // no block was connected in the meantime.
+    ForceFlushStateToDisk();
+    const auto cursors{WITH_LOCK(::cs_main, return CoinsDB().Cursors(kernel::GetCoinsScanRanges()))};
+    std::optional<kernel::RunningCoinsStats> running_stats{kernel::ComputeRunningCoinsStats(cursors, interruption_point)};
+    if (!running_stats) return std::nullopt;
+
+    LOCK(::cs_main);
+    const CBlockIndex* pindex{Assert(m_blockman.LookupBlockIndex(cursors.front()->GetBestBlock()))};
+    if (!m_coins_stats && CoinsTip().GetBestBlock() == pindex->GetBlockHash()) {
+        m_coins_stats = running_stats;
+    }
+    CCoinsStats stats{running_stats->ToStats(pindex->nHeight, pindex->GetBlockHash())};
+    stats.nDiskSize = CoinsDB().EstimateSize();
+    return stats;
+}
+
 CVerifyDB::CVerifyDB()
 {
     uiInterface.ShowProgress(_("Verifying blocks…").translated, 0, false);
@@ -3965,11 +4020,35 @@ CVerifyDB::~CVerifyDB()
     uiInterface.ShowProgress("", 100, false);
 }
 
+//! Run the checks of levels 1 and 2 of VerifyDB() on a block read from disk.
+//! They don't need cs_main, so the position of the undo data is passed in.
+//! Returns a description of the failure, if any.
+static std::optional<std::string> CheckBlockData(const CBlock& block, const CBlockIndex& index, const FlatFilePos& undo_pos, int check_level, const Consensus::Params& consensus_params)
+{
+    if (block.GetHash() != index.GetBlockHash()) {
+        return strprintf("ReadBlockFromDisk returned a different block at %d, hash=%s", index.nHeight, index.GetBlockHash().ToString());
+    }
+    // check level 1: verify block validity
+    BlockValidationState state;
+    if (check_level >= 1 && !CheckBlock(block, state, consensus_params)) {
+        return strprintf("found bad block at %d, hash=%s (%s)", index.nHeight, index.GetBlockHash().ToString(), state.ToString());
+    }
+    // check level 2: verify undo validity
+    if (check_level >= 2 && !undo_pos.IsNull()) {
+        CBlockUndo undo;
+        if (!UndoReadFromDisk(undo, undo_pos, index.pprev->GetBlockHash())) {
+            return strprintf("found bad undo data at %d, hash=%s", index.nHeight, index.GetBlockHash().ToString());
+        }
+    }
+    return std::nullopt;
+}
+
 bool CVerifyDB::VerifyDB(
     Chainstate& chainstate,
     const Consensus::Params& consensus_params,
     CCoinsView& coinsview,
-    int nCheckLevel, int nCheckDepth)
+    int nCheckLevel, int nCheckDepth,
+    int threads, bool stop_at_coins_limit)
 {
     AssertLockHeld(cs_main);
 
@@ -3983,24 +4062,14 @@ bool CVerifyDB::VerifyDB(
     }
     nCheckLevel = std::max(0, std::min(4, nCheckLevel));
     LogPrintf("Verifying last %i blocks at level %i\n", nCheckDepth, nCheckLevel);
-    CCoinsViewCache coins(&coinsview);
-    CBlockIndex* pindex;
-    CBlockIndex* pindexFailure = nullptr;
-    int nGoodTransactions = 0;
-    BlockValidationState state;
-    int reportDone = 0;
-    LogPrintf("[0%%]..."); /* Continued */
 
     const bool is_snapshot_cs{!chainstate.m_from_snapshot_blockhash};
 
-    for (pindex = chainstate.m_chain.Tip(); pindex && pindex->pprev; pindex = pindex->pprev) {
-        const int percentageDone = std::max(1, std::min(99, (int)(((double)(chainstate.m_chain.Height() - pindex->nHeight)) / (double)nCheckDepth * (nCheckLevel >= 4 ? 50 : 100))));
-        if (reportDone < percentageDone / 10) {
-            // report every 10% step
-            LogPrintf("[%d%%]...", percentageDone); /* Continued */
-            reportDone = percentageDone / 10;
-        }
-        uiInterface.ShowProgress(_("Verifying blocks…").translated, percentageDone, false);
+    // The blocks to verify, from the tip down
+    std::vector<CBlockIndex*> indexes;
+    std::vector<FlatFilePos> positions;
+    std::vector<FlatFilePos> undo_positions;
+    for (CBlockIndex* pindex = chainstate.m_chain.Tip(); pindex && pindex->pprev; pindex = pindex->pprev) {
         if (pindex->nHeight <= chainstate.m_chain.Height() - nCheckDepth) {
             break;
         }
@@ -4010,53 +4079,78 @@ bool CVerifyDB::VerifyDB(
             LogPrintf("VerifyDB(): block verification stopping at height %d (pruning, no data)\n", pindex->nHeight);
             break;
         }
-        CBlock block;
-        // check level 0: read from disk
-        if (!ReadBlockFromDisk(block, pindex, consensus_params)) {
-            return error("VerifyDB(): *** ReadBlockFromDisk failed at %d, hash=%s", pindex->nHeight, pindex->GetBlockHash().ToString());
-        }
-        // check level 1: verify block validity
-        if (nCheckLevel >= 1 && !CheckBlock(block, state, consensus_params)) {
-            return error("%s: *** found bad block at %d, hash=%s (%s)\n", __func__,
-                         pindex->nHeight, pindex->GetBlockHash().ToString(), state.ToString());
-        }
-        // check level 2: verify undo validity
-        if (nCheckLevel >= 2 && pindex) {
-            CBlockUndo undo;
-            if (!pindex->GetUndoPos().IsNull()) {
-                if (!UndoReadFromDisk(undo, pindex)) {
-                    return error("VerifyDB(): *** found bad undo data at %d, hash=%s\n", pindex->nHeight, pindex->GetBlockHash().ToString());
-                }
-            }
-        }
-        // check level 3: check for inconsistencies during memory-only disconnect of tip blocks
-        size_t curr_coins_usage = coins.DynamicMemoryUsage() + chainstate.CoinsTip().DynamicMemoryUsage();
+        indexes.push_back(pindex);
+        positions.push_back(pindex->GetBlockPos());
+        undo_positions.push_back(pindex->GetUndoPos());
+    }
 
-        if (nCheckLevel >= 3 && curr_coins_usage <= chainstate.m_coinstip_cache_size_bytes) {
-            assert(coins.GetBestBlock() == pindex->GetBlockHash());
-            DisconnectResult res = chainstate.DisconnectBlock(block, pindex, coins);
-            if (res == DISCONNECT_FAILED) {
-                return error("VerifyDB(): *** irrecoverable inconsistency in block data at %d, hash=%s", pindex->nHeight, pindex->GetBlockHash().ToString());
+    CCoinsViewCache coins(&coinsview);
+    CBlockIndex* pindexFailure = nullptr;
+    int nGoodTransactions = 0;
+    BlockValidationState state;
+    int reportDone = 0;
+    // The first `disconnected` blocks of indexes were disconnected at level 3
+    size_t disconnected{0};
+    size_t checked{0};
+    LogPrintf("[0%%]..."); /* Continued */
+
+    {
+        // Checks of levels 1 and 2, written by the reading threads before they hand over the block
+        std::vector<std::optional<std::string>> failures(indexes.size());
+        BlockPrefetcher prefetcher{positions, threads, consensus_params, [&](size_t i, const CBlock& block) {
+            failures[i] = CheckBlockData(block, *indexes[i], undo_positions[i], nCheckLevel, consensus_params);
+        }};
+        for (CBlockIndex* pindex : indexes) {
+            const int percentageDone = std::max(1, std::min(99, (int)(((double)(chainstate.m_chain.Height() - pindex->nHeight)) / (double)nCheckDepth * (nCheckLevel >= 4 ? 50 : 100))));
+            if (reportDone < percentageDone / 10) {
+                // report every 10% step
+                LogPrintf("[%d%%]...", percentageDone); /* Continued */
+                reportDone = percentageDone / 10;
             }
-            if (res == DISCONNECT_UNCLEAN) {
-                nGoodTransactions = 0;
-                pindexFailure = pindex;
-            } else {
-                nGoodTransactions += block.vtx.size();
+            uiInterface.ShowProgress(_("Verifying blocks…").translated, percentageDone, false);
+            // check level 0: read from disk
+            const std::shared_ptr<const CBlock> block{prefetcher.Next()};
+            if (!block) {
+                return error("VerifyDB(): *** ReadBlockFromDisk failed at %d, hash=%s", pindex->nHeight, pindex->GetBlockHash().ToString());
+            }
+            // check levels 1 and 2 ran on the reading thread
+            if (const auto& failure{failures[checked]}) {
+                return error("%s: *** %s\n", __func__, *failure);
+            }
+            // check level 3: check for inconsistencies during memory-only disconnect of tip blocks
+            if (nCheckLevel >= 3) {
+                size_t curr_coins_usage = coins.DynamicMemoryUsage() + chainstate.CoinsTip().DynamicMemoryUsage();
+                if (disconnected == checked && curr_coins_usage <= chainstate.m_coinstip_cache_size_bytes) {
+                    assert(coins.GetBestBlock() == pindex->GetBlockHash());
+                    DisconnectResult res = chainstate.DisconnectBlock(*block, pindex, coins);
+                    if (res == DISCONNECT_FAILED) {
+                        return error("VerifyDB(): *** irrecoverable inconsistency in block data at %d, hash=%s", pindex->nHeight, pindex->GetBlockHash().ToString());
+                    }
+                    if (res == DISCONNECT_UNCLEAN) {
+                        nGoodTransactions = 0;
+                        pindexFailure = pindex;
+                    } else {
+                        nGoodTransactions += block->vtx.size();
+                    }
+                    ++disconnected;
+                } else if (stop_at_coins_limit) {
+                    break;
+                }
             }
+            ++checked;
+            if (ShutdownRequested()) return true;
         }
-        if (ShutdownRequested()) return true;
     }
     if (pindexFailure) {
         return error("VerifyDB(): *** coin database inconsistencies found (last %i blocks, %i good transactions before that)\n", chainstate.m_chain.Height() - pindexFailure->nHeight + 1, nGoodTransactions);
     }
 
-    // store block count as we move pindex at check level >= 4
-    int block_count = chainstate.m_chain.Height() - pindex->nHeight;
-
-    // check level 4: try reconnecting blocks
-    if (nCheckLevel >= 4) {
-        while (pindex != chainstate.m_chain.Tip()) {
+    // check level 4: try reconnecting the disconnected blocks
+    if (nCheckLevel >= 4 && disconnected > 0) {
+        std::vector<FlatFilePos> reconnect_positions(positions.rend() - disconnected, positions.rend());
+        BlockPrefetcher prefetcher{std::move(reconnect_positions), threads, consensus_params};
+        for (size_t i = disconnected; i-- > 0;) {
+            CBlockIndex* pindex{indexes[i]};
             const int percentageDone = std::max(1, std::min(99, 100 - (int)(((double)(chainstate.m_chain.Height() - pindex->nHeight)) / (double)nCheckDepth * 50)));
             if (reportDone < percentageDone / 10) {
                 // report every 10% step
@@ -4064,11 +4158,10 @@ bool CVerifyDB::VerifyDB(
                 reportDone = percentageDone / 10;
             }
             uiInterface.ShowProgress(_("Verifying blocks…").translated, percentageDone, false);
-            pindex = chainstate.m_chain.Next(pindex);
-            CBlock block;
-            if (!ReadBlockFromDisk(block, pindex, consensus_params))
+            const std::shared_ptr<const CBlock> block{prefetcher.Next()};
+            if (!block)
                 return error("VerifyDB(): *** ReadBlockFromDisk failed at %d, hash=%s", pindex->nHeight, pindex->GetBlockHash().ToString());
-            if (!chainstate.ConnectBlock(block, state, pindex, coins)) {
+            if (!chainstate.ConnectBlock(*block, state, pindex, coins)) {
                 return error("VerifyDB(): *** found unconnectable block at %d, hash=%s (%s)", pindex->nHeight, pindex->GetBlockHash().ToString(), state.ToString());
             }
             if (ShutdownRequested()) return true;
@@ -4076,7 +4169,7 @@ bool CVerifyDB::VerifyDB(
     }
 
     LogPrintf("[DONE].\n");
-    LogPrintf("No coin database inconsistencies in last %i blocks (%i transactions)\n", block_count, nGoodTransactions);
+    LogPrintf("No coin database inconsistencies in last %i blocks (%i transactions)\n", checked, nGoodTransactions);
 
     return true;
 }
@@ -4284,6 +4377,7 @@ bool ChainstateManager::LoadBlockIndex()
 
         LogPrintf("Initializing databases...\n");
     }
+    m_blockman.m_block_index_loaded = true;
     return true;
 }
 
@@ -4440,6 +4534,49 @@ void Chainstate::LoadExternalBlockFile(
     LogPrintf("Loaded %i blocks from external file in %dms\n", nLoaded, Ticks<std::chrono::milliseconds>(SteadyClock::now() - start));
 }
 
+void Chainstate::ReindexBlocks(const std::vector<FlatFilePos>& positions, int threads)
+{
+    AssertLockNotHeld(m_chainstate_mutex);
+
+    const auto start{SteadyClock::now()};
+    // Check the blocks while reading them, AcceptBlock() skips the checks of a checked block
+    BlockPrefetcher prefetcher{positions, threads, m_params.GetConsensus(), [&](size_t, const CBlock& block) {
+        BlockValidationState state;
+        CheckBlock(block, state, m_params.GetConsensus());
+    }};
+
+    int loaded{0};
+    for (size_t i = 0; i < positions.size() && !ShutdownRequested(); ++i) {
+        const std::shared_ptr<const CBlock> pblock{prefetcher.Next()};
+        if (!pblock) {
+            LogPrintf("%s: failed to read block at %s\n", __func__, positions[i].ToString());
+            continue;
+        }
+
+        {
+            LOCK(cs_main);
+            const CBlockIndex* pindex{m_blockman.LookupBlockIndex(pblock->GetHash())};
+            if (pindex && (pindex->nStatus & BLOCK_HAVE_DATA)) continue;
+            BlockValidationState state;
+            FlatFilePos pos{positions[i]};
+            if (!AcceptBlock(pblock, state, nullptr, true, &pos, nullptr, true)) {
+                if (state.IsError()) break;
+                continue;
+            }
+        }
+        ++loaded;
+        NotifyHeaderTip(*this);
+
+        // Connect the block while it is in memory
+        BlockValidationState state;
+        if (!ActivateBestChain(state, pblock)) {
+            LogPrintf("%s: failed to connect block %s (%s)\n", __func__, pblock->GetHash().ToString(), state.ToString());
+            break;
+        }
+    }
+    LogPrintf("Loaded %i blocks from block files in %dms\n", loaded, Ticks<std::chrono::milliseconds>(SteadyClock::now() - start));
+}
+
 void Chainstate::CheckBlockIndex()
 {
     if (!fCheckBlockIndex) {
@@ -4796,6 +4933,16 @@ bool ChainstateManager::ActivateSnapshot(
         return false;
     }
 
+    {
+        LOCK(::cs_main);
+        // The mempool is handed over to the snapshot chainstate below, which is
+        // only sound if it holds no transactions validated against the old tip.
+        if (const CTxMemPool* mempool{ActiveChainstate().GetMempool()}; mempool && mempool->size() > 0) {
+            LogPrintf("[snapshot] can't activate a snapshot when mempool not empty\n");
+            return false;
+        }
+    }
+
     int64_t current_coinsdb_cache_size{0};
     int64_t current_coinstip_cache_size{0};
 
@@ -4836,7 +4983,7 @@ bool ChainstateManager::ActivateSnapshot(
         LOCK(::cs_main);
         snapshot_chainstate->InitCoinsDB(
             static_cast<size_t>(current_coinsdb_cache_size * SNAPSHOT_CACHE_PERC),
-            in_memory, false, "chainstate");
+            in_memory, /*should_wipe=*/true, "chainstate");
         snapshot_chainstate->InitCoinsCache(
             static_cast<size_t>(current_coinstip_cache_size * SNAPSHOT_CACHE_PERC));
     }
@@ -4856,6 +5003,10 @@ bool ChainstateManager::ActivateSnapshot(
         const bool chaintip_loaded = m_snapshot_chainstate->LoadChainTip();
         assert(chaintip_loaded);
 
+        // Transfer possession of the mempool to the snapshot chainstate, which
+        // is the one following the tip from now on.
+        m_snapshot_chainstate->m_mempool = m_active_chainstate->m_mempool;
+        m_active_chainstate->m_mempool = nullptr;
         m_active_chainstate = m_snapshot_chainstate.get();
 
         LogPrintf("[snapshot] successfully activated snapshot %s\n", base_blockhash.ToString());
@@ -4864,6 +5015,7 @@ bool ChainstateManager::ActivateSnapshot(
 
         this->MaybeRebalanceCaches();
     }
+    StartBackgroundValidation();
     return true;
 }
 
@@ -4878,6 +5030,180 @@ static void FlushSnapshotToDisk(CCoinsViewCache& coins_cache, bool snapshot_load
     coins_cache.Flush();
 }
 
+namespace {
+/**
+ * Batches of coins handed from the thread reading a UTXO snapshot to the
+ * thread adding them to the coins cache. At most MAX_BATCHES batches are
+ * queued, which bounds the memory used when reading is faster than adding.
+ */
+class SnapshotCoinsQueue
+{
+public:
+    using Batch = std::vector<std::pair<COutPoint, Coin>>;
+
+    //! Number of coins per batch. The coins cache size is checked after each
+    //! batch; if our average Coin size is roughly 41 bytes, 120,000 coins
+    //! means <5MB of memory imprecision.
+    static constexpr size_t BATCH_SIZE{120000};
+    static constexpr size_t MAX_BATCHES{2};
+
+    //! Queue a batch, waiting while the queue is full. Returns false if the queue was aborted.
+    bool Push(Batch&& batch) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        while (!m_aborted && m_batches.size() >= MAX_BATCHES) m_cv.wait(lock);
+        if (m_aborted) return false;
+        m_batches.push_back(std::move(batch));
+        m_cv.notify_all();
+        return true;
+    }
+
+    //! Wait for the next batch. Returns nullopt once the queue is closed and empty, or aborted.
+    std::optional<Batch> Pop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        while (!m_aborted && !m_closed && m_batches.empty()) m_cv.wait(lock);
+        if (m_aborted || m_batches.empty()) return std::nullopt;
+        Batch batch{std::move(m_batches.front())};
+        m_batches.pop_front();
+        m_cv.notify_all();
+        return batch;
+    }
+
+    //! Signal that no more batches will be pushed.
+    void Close() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        m_closed = true;
+        m_cv.notify_all();
+    }
+
+    //! Stop handing over batches, because either side failed.
+    void Abort() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        m_aborted = true;
+        m_cv.notify_all();
+    }
+
+private:
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Batch> m_batches GUARDED_BY(m_mutex);
+    bool m_closed GUARDED_BY(m_mutex){false};
+    bool m_aborted GUARDED_BY(m_mutex){false};
+};
+} // namespace
+
+//! Read the coins of a snapshot, check them, add them to the UTXO set hash ss
+//! and hand them to the queue in batches.
+static bool ReadSnapshotCoins(AutoFile& coins_file, const uint64_t coins_count, const int base_height, HashWriter& ss, SnapshotCoinsQueue& queue)
+{
+    uint64_t coins_left = coins_count;
+    std::optional<uint256> last_txid;
+    SnapshotCoinsQueue::Batch batch;
+    batch.reserve(SnapshotCoinsQueue::BATCH_SIZE);
+
+    while (coins_left > 0) {
+        uint256 txid;
+        std::map<uint32_t, Coin> outputs;
+        try {
+            coins_file >> txid;
+            const uint64_t num_coins{ReadCompactSize(coins_file)};
+            // Transactions must be listed in increasing txid order, so that no
+            // coin can appear twice and the hash matches the loaded coins.
+            if (num_coins == 0 || num_coins > coins_left || (last_txid && !(*last_txid < txid))) {
+                LogPrintf("[snapshot] bad snapshot data after deserializing %d coins\n",
+                          coins_count - coins_left);
+                return false;
+            }
+            for (uint64_t i = 0; i < num_coins; ++i) {
+                uint32_t n;
+                Coin coin;
+                coins_file >> VARINT(n);
+                coins_file >> coin;
+                if (coin.nHeight > base_height ||
+                    n >= std::numeric_limits<decltype(n)>::max() || // Avoid integer wrap-around in coinstats.cpp:ApplyHash
+                    (!outputs.empty() && n <= outputs.rbegin()->first)
+                ) {
+                    LogPrintf("[snapshot] bad snapshot data after deserializing %d coins\n",
+                              coins_count - coins_left);
+                    return false;
+                }
+                outputs.emplace_hint(outputs.end(), n, std::move(coin));
+            }
+        } catch (const std::ios_base::failure&) {
+            LogPrintf("[snapshot] bad snapshot format or truncated snapshot after deserializing %d coins\n",
+                      coins_count - coins_left);
+            return false;
+        }
+
+        kernel::ApplyCoinHash(ss, txid, outputs);
+        for (auto& [n, coin] : outputs) {
+            batch.emplace_back(COutPoint{txid, n}, std::move(coin));
+        }
+        coins_left -= outputs.size();
+        last_txid = txid;
+
+        if (batch.size() >= SnapshotCoinsQueue::BATCH_SIZE) {
+            if (ShutdownRequested() || !queue.Push(std::move(batch))) {
+                return false;
+            }
+            batch.clear();
+        }
+    }
+    if (!batch.empty() && !queue.Push(std::move(batch))) {
+        return false;
+    }
+
+    bool out_of_coins{false};
+    try {
+        uint8_t trailing;
+        coins_file >> trailing;
+    } catch (const std::ios_base::failure&) {
+        // We expect an exception since we should be at the end of the file.
+        out_of_coins = true;
+    }
+    if (!out_of_coins) {
+        LogPrintf("[snapshot] bad snapshot - coins left over after deserializing %d coins\n",
+            coins_count);
+        return false;
+    }
+    return true;
+}
+
+//! Add the coins handed over by the queue to the coins cache of the snapshot
+//! chainstate, flushing it whenever it gets full.
+static void AddSnapshotCoins(Chainstate& snapshot_chainstate, CCoinsViewCache& coins_cache, SnapshotCoinsQueue& queue, const uint64_t coins_count)
+{
+    int64_t coins_processed{0};
+    while (auto batch{queue.Pop()}) {
+        for (auto& [outpoint, coin] : *batch) {
+            coins_cache.EmplaceCoinInternalDANGER(std::move(outpoint), std::move(coin));
+
+            if (++coins_processed % 1000000 == 0) {
+                LogPrintf("[snapshot] %d coins loaded (%.2f%%, %.2f MB)\n",
+                    coins_processed,
+                    static_cast<float>(coins_processed) * 100 / static_cast<float>(coins_count),
+                    coins_cache.DynamicMemoryUsage() / (1000 * 1000));
+            }
+        }
+
+        const auto snapshot_cache_state = WITH_LOCK(::cs_main,
+            return snapshot_chainstate.GetCoinsCacheSizeState());
+
+        if (snapshot_cache_state >= CoinsCacheSizeState::CRITICAL) {
+            // This is a hack - we don't know what the actual best block is, but that
+            // doesn't matter for the purposes of flushing the cache here. We'll set this
+            // to its correct value (`base_blockhash`) below after the coins are loaded.
+            coins_cache.SetBestBlock(GetRandHash());
+
+            // No need to acquire cs_main since this chainstate isn't being used yet.
+            FlushSnapshotToDisk(coins_cache, /*snapshot_loaded=*/false);
+        }
+    }
+}
+
 bool ChainstateManager::PopulateAndValidateSnapshot(
     Chainstate& snapshot_chainstate,
     AutoFile& coins_file,
@@ -4892,7 +5218,7 @@ bool ChainstateManager::PopulateAndValidateSnapshot(
     CBlockIndex* snapshot_start_block = WITH_LOCK(::cs_main, return m_blockman.LookupBlockIndex(base_blockhash));
 
     if (!snapshot_start_block) {
-        // Needed for ComputeUTXOStats and ExpectedAssumeutxo to determine the
+        // Needed for ExpectedAssumeutxo to determine the
         // height and to avoid a crash when base_blockhash.IsNull()
         LogPrintf("[snapshot] Did not find snapshot start blockheader %s\n",
                   base_blockhash.ToString());
@@ -4910,65 +5236,42 @@ bool ChainstateManager::PopulateAndValidateSnapshot(
 
     const AssumeutxoData& au_data = *maybe_au_data;
 
-    COutPoint outpoint;
-    Coin coin;
     const uint64_t coins_count = metadata.m_coins_count;
-    uint64_t coins_left = metadata.m_coins_count;
 
     LogPrintf("[snapshot] loading coins from snapshot %s\n", base_blockhash.ToString());
-    int64_t coins_processed{0};
 
-    while (coins_left > 0) {
+    // Coins are read, checked and hashed on this thread, while another thread
+    // adds them to the coins cache and flushes it whenever it gets full. As the
+    // snapshot lists the coins in the order of the coins database, the UTXO set
+    // hash can be computed while reading them, instead of in a second pass over
+    // the loaded coins database.
+    SnapshotCoinsQueue queue;
+    auto coins_added = std::async(std::launch::async, [&] {
         try {
-            coins_file >> outpoint;
-            coins_file >> coin;
-        } catch (const std::ios_base::failure&) {
-            LogPrintf("[snapshot] bad snapshot format or truncated snapshot after deserializing %d coins\n",
-                      coins_count - coins_left);
-            return false;
-        }
-        if (coin.nHeight > base_height ||
-            outpoint.n >= std::numeric_limits<decltype(outpoint.n)>::max() // Avoid integer wrap-around in coinstats.cpp:ApplyHash
-        ) {
-            LogPrintf("[snapshot] bad snapshot data after deserializing %d coins\n",
-                      coins_count - coins_left);
-            return false;
+            AddSnapshotCoins(snapshot_chainstate, coins_cache, queue, coins_count);
+        } catch (...) {
+            queue.Abort();
+            throw;
         }
+    });
 
-        coins_cache.EmplaceCoinInternalDANGER(std::move(outpoint), std::move(coin));
-
-        --coins_left;
-        ++coins_processed;
-
-        if (coins_processed % 1000000 == 0) {
-            LogPrintf("[snapshot] %d coins loaded (%.2f%%, %.2f MB)\n",
-                coins_processed,
-                static_cast<float>(coins_processed) * 100 / static_cast<float>(coins_count),
-                coins_cache.DynamicMemoryUsage() / (1000 * 1000));
-        }
-
-        // Batch write and flush (if we need to) every so often.
-        //
-        // If our average Coin size is roughly 41 bytes, checking every 120,000 coins
-        // means <5MB of memory imprecision.
-        if (coins_processed % 120000 == 0) {
-            if (ShutdownRequested()) {
-                return false;
-            }
-
-            const auto snapshot_cache_state = WITH_LOCK(::cs_main,
-                return snapshot_chainstate.GetCoinsCacheSizeState());
-
-            if (snapshot_cache_state >= CoinsCacheSizeState::CRITICAL) {
-                // This is a hack - we don't know what the actual best block is, but that
-                // doesn't matter for the purposes of flushing the cache here. We'll set this
-                // to its correct value (`base_blockhash`) below after the coins are loaded.
-                coins_cache.SetBestBlock(GetRandHash());
-
-                // No need to acquire cs_main since this chainstate isn't being used yet.
-                FlushSnapshotToDisk(coins_cache, /*snapshot_loaded=*/false);
-            }
-        }
+    HashWriter ss{};
+    ss << base_blockhash;
+    bool coins_read{false};
+    try {
+        coins_read = ReadSnapshotCoins(coins_file, coins_count, base_height, ss, queue);
+    } catch (...) {
+        queue.Abort();
+        throw;
+    }
+    if (coins_read) {
+        queue.Close();
+    } else {
+        queue.Abort();
+    }
+    coins_added.get();
+    if (!coins_read) {
+        return false;
     }
 
     // Important that we set this. This and the coins_cache accesses above are
@@ -4978,19 +5281,6 @@ bool ChainstateManager::PopulateAndValidateSnapshot(
     // method.
     coins_cache.SetBestBlock(base_blockhash);
 
-    bool out_of_coins{false};
-    try {
-        coins_file >> outpoint;
-    } catch (const std::ios_base::failure&) {
-        // We expect an exception since we should be out of coins.
-        out_of_coins = true;
-    }
-    if (!out_of_coins) {
-        LogPrintf("[snapshot] bad snapshot - coins left over after deserializing %d coins\n",
-            coins_count);
-        return false;
-    }
-
     LogPrintf("[snapshot] loaded %d (%.2f MB) coins from snapshot %s\n",
         coins_count,
         coins_cache.DynamicMemoryUsage() / (1000 * 1000),
@@ -5001,22 +5291,11 @@ bool ChainstateManager::PopulateAndValidateSnapshot(
 
     assert(coins_cache.GetBestBlock() == base_blockhash);
 
-    auto breakpoint_fnc = [] { /* TODO insert breakpoint here? */ };
-
-    // As above, okay to immediately release cs_main here since no other context knows
-    // about the snapshot_chainstate.
-    CCoinsViewDB* snapshot_coinsdb = WITH_LOCK(::cs_main, return &snapshot_chainstate.CoinsDB());
-
-    const std::optional<CCoinsStats> maybe_stats = ComputeUTXOStats(CoinStatsHashType::HASH_SERIALIZED, snapshot_coinsdb, m_blockman, breakpoint_fnc);
-    if (!maybe_stats.has_value()) {
-        LogPrintf("[snapshot] failed to generate coins stats\n");
-        return false;
-    }
-
     // Assert that the deserialized chainstate contents match the expected assumeutxo value.
-    if (AssumeutxoHash{maybe_stats->hashSerialized} != au_data.hash_serialized) {
+    const uint256 hash_serialized{ss.GetHash()};
+    if (AssumeutxoHash{hash_serialized} != au_data.hash_serialized) {
         LogPrintf("[snapshot] bad snapshot content hash: expected %s, got %s\n",
-            au_data.hash_serialized.ToString(), maybe_stats->hashSerialized.ToString());
+            au_data.hash_serialized.ToString(), hash_serialized.ToString());
         return false;
     }
 
@@ -5096,7 +5375,7 @@ void ChainstateManager::MaybeRebalanceCaches()
         // Allocate everything to the IBD chainstate.
         m_ibd_chainstate->ResizeCoinsCaches(m_total_coinstip_cache, m_total_coinsdb_cache);
     }
-    else if (m_snapshot_chainstate && !m_ibd_chainstate) {
+    else if (m_snapshot_chainstate && (!m_ibd_chainstate || m_snapshot_validated)) {
         LogPrintf("[snapshot] allocating all cache to the snapshot chainstate\n");
         // Allocate everything to the snapshot chainstate.
         m_snapshot_chainstate->ResizeCoinsCaches(m_total_coinstip_cache, m_total_coinsdb_cache);
@@ -5119,8 +5398,332 @@ void ChainstateManager::MaybeRebalanceCaches()
     }
 }
 
+const CBlockIndex* ChainstateManager::GetSnapshotBaseBlock() const
+{
+    AssertLockHeld(::cs_main);
+    if (!m_snapshot_chainstate) return nullptr;
+    return m_blockman.LookupBlockIndex(*m_snapshot_chainstate->m_from_snapshot_blockhash);
+}
+
+Chainstate* ChainstateManager::BackgroundSyncChainstate() const
+{
+    AssertLockHeld(::cs_main);
+    if (!m_snapshot_chainstate || m_snapshot_validated) return nullptr;
+    return m_ibd_chainstate.get();
+}
+
+std::optional<BackgroundValidationProgress> ChainstateManager::GetBackgroundValidationProgress() const
+{
+    AssertLockHeld(::cs_main);
+    const Chainstate* background{BackgroundSyncChainstate()};
+    if (!background) return std::nullopt;
+
+    BackgroundValidationProgress progress;
+    progress.height = background->m_chain.Height();
+    progress.target_height = GetSnapshotBaseBlock()->nHeight;
+    progress.paused = m_snapshot_chainstate->IsInitialBlockDownload();
+    progress.blocks_per_second = 0;
+    if (m_background_validation_start) {
+        const auto elapsed{std::chrono::duration<double>{SteadyClock::now() - *m_background_validation_start}.count()};
+        const int connected{progress.height - m_background_validation_start_height};
+        if (elapsed > 0 && connected > 0) {
+            progress.blocks_per_second = connected / elapsed;
+            progress.eta = std::chrono::seconds{int64_t((progress.target_height - progress.height) / progress.blocks_per_second)};
+        }
+    }
+    return progress;
+}
+
+//! Maximum number of blocks the background chainstate connects in one
+//! ActivateBestChain() call, between which the time budget is checked.
+static constexpr int BACKGROUND_VALIDATION_BATCH{16};
+
+bool ChainstateManager::BackgroundValidationStep(std::chrono::microseconds budget)
+{
+    AssertLockNotHeld(::cs_main);
+    const auto start{SteadyClock::now()};
+    bool reached_base{false};
+    do {
+        Chainstate* background;
+        int old_height;
+        {
+            LOCK(::cs_main);
+            background = BackgroundSyncChainstate();
+            if (!background) return false;
+            if (budget <= 0us || m_snapshot_chainstate->IsInitialBlockDownload()) return true;
+
+            CBlockIndex* base{m_blockman.LookupBlockIndex(*m_snapshot_chainstate->m_from_snapshot_blockhash)};
+            const CBlockIndex* tip{background->m_chain.Tip()};
+            if (tip == base) {
+                reached_base = true;
+                break;
+            }
+
+            // Connect the next blocks beneath the snapshot base block that are
+            // already on disk; the rest are still being downloaded.
+            const int fork_height{LastCommonAncestor(tip, base)->nHeight};
+            const int last_height{std::min(base->nHeight, fork_height + BACKGROUND_VALIDATION_BATCH)};
+            CBlockIndex* target{nullptr};
+            for (int height = fork_height + 1; height <= last_height; ++height) {
+                CBlockIndex* pindex{base->GetAncestor(height)};
+                if (pindex->nStatus & BLOCK_FAILED_MASK) {
+                    AbortNode(strprintf("Block %s beneath the UTXO snapshot base block %s is invalid",
+                                        pindex->GetBlockHash().ToString(), base->GetBlockHash().ToString()),
+                              _("The loaded UTXO snapshot is based on an invalid chain. Please restart with a new data directory."));
+                    return false;
+                }
+                if (!(pindex->nStatus & BLOCK_HAVE_DATA)) break;
+                target = pindex;
+            }
+            if (!target) return true;
+
+            if (!m_background_validation_start) {
+                m_background_validation_start = start;
+                m_background_validation_start_height = tip->nHeight;
+            }
+            background->setBlockIndexCandidates.insert(target);
+            old_height = tip->nHeight;
+        }
+
+        BlockValidationState state;
+        if (!background->ActivateBestChain(state, nullptr)) {
+            LogPrintf("[snapshot] background validation failed: %s\n", state.ToString());
+            return false;
+        }
+        // A block that failed validation is reported above on the next step.
+        if (WITH_LOCK(::cs_main, return background->m_chain.Height()) == old_height) return true;
+    } while (SteadyClock::now() - start < budget && !ShutdownRequested());
+
+    if (reached_base) {
+        CompleteSnapshotValidation();
+        return false;
+    }
+    return true;
+}
+
+bool ChainstateManager::CompleteSnapshotValidation()
+{
+    AssertLockNotHeld(::cs_main);
+    CCoinsViewDB* coins_db;
+    const CBlockIndex* base;
+    {
+        LOCK(::cs_main);
+        Chainstate* background{BackgroundSyncChainstate()};
+        base = GetSnapshotBaseBlock();
+        if (!background || background->m_chain.Tip() != base) return false;
+        background->ForceFlushStateToDisk();
+        coins_db = &background->CoinsDB();
+    }
+
+    const AssumeutxoData* au_data{Assert(ExpectedAssumeutxo(base->nHeight, GetParams()))};
+    LogPrintf("[snapshot] background chainstate reached the snapshot base block %s; computing its UTXO set hash\n",
+              base->GetBlockHash().ToString());
+    std::optional<kernel::CCoinsStats> stats;
+    try {
+        stats = kernel::ComputeUTXOStats(kernel::CoinStatsHashType::HASH_SERIALIZED, coins_db, m_blockman, [] {
+            if (ShutdownRequested()) throw std::runtime_error("Shutting down");
+        });
+    } catch (const std::runtime_error& e) {
+        LogPrintf("[snapshot] interrupted computing the UTXO set hash of the background chainstate: %s\n", e.what());
+        return false;
+    }
+    if (!stats) {
+        LogPrintf("[snapshot] failed to compute the UTXO set hash of the background chainstate\n");
+        return false;
+    }
+    if (AssumeutxoHash{stats->hashSerialized} != au_data->hash_serialized) {
+        AbortNode(strprintf("The UTXO set hash of the background chainstate at height %d (%s) does not match the UTXO snapshot (%s)",
+                            base->nHeight, stats->hashSerialized.ToString(), au_data->hash_serialized.ToString()),
+                  _("The loaded UTXO snapshot does not match the validated chain. Please restart with a new data directory."));
+        return false;
+    }
+
+    LOCK(::cs_main);
+    m_snapshot_validated = true;
+    LogPrintf("[snapshot] snapshot beginning at %s has been fully validated\n", base->GetBlockHash().ToString());
+    MaybeRebalanceCaches();
+    return true;
+}
+
+//! How often background validation is scheduled; it spends
+//! background_validation_budget percent of each interval connecting blocks.
+static constexpr auto BACKGROUND_VALIDATION_INTERVAL{1s};
+
+void ChainstateManager::ThreadBackgroundValidation()
+{
+    while (!m_interrupt_background_validation && !ShutdownRequested()) {
+        const auto start{SteadyClock::now()};
+        const auto budget{std::chrono::duration_cast<std::chrono::microseconds>(BACKGROUND_VALIDATION_INTERVAL) * m_options.background_validation_budget / 100};
+        if (!BackgroundValidationStep(budget)) break;
+        if (!m_interrupt_background_validation.sleep_for(BACKGROUND_VALIDATION_INTERVAL - (SteadyClock::now() - start))) break;
+    }
+}
+
+void ChainstateManager::StartBackgroundValidation()
+{
+    assert(!m_background_validation.joinable());
+    m_background_validation = std::thread(&util::TraceThread, "bgvalidation", [this] { ThreadBackgroundValidation(); });
+}
+
+void ChainstateManager::StopBackgroundValidation()
+{
+    m_interrupt_background_validation();
+    if (m_background_validation.joinable()) m_background_validation.join();
+}
+
+//! Number of blocks checked at levels 0 to 2 between recording the progress
+//! of a background verification.
+static constexpr int BACKGROUND_VERIFICATION_BATCH{1000};
+
+bool ChainstateManager::StartBackgroundVerification(int check_level, int check_depth)
+{
+    VerifyChainProgress progress;
+    {
+        LOCK(::cs_main);
+        const CBlockIndex* tip{ActiveChain().Tip()};
+        if (!tip) return false;
+        if (check_depth <= 0 || check_depth > tip->nHeight) check_depth = tip->nHeight;
+        progress.check_level = std::clamp(check_level, 0, 4);
+        progress.target_height = tip->nHeight - check_depth;
+        progress.next_block = tip->GetBlockHash();
+        progress.blocks_total = check_depth;
+    }
+    return LaunchBackgroundVerification(progress);
+}
+
+void ChainstateManager::ResumeBackgroundVerification()
+{
+    VerifyChainProgress progress;
+    if (!WITH_LOCK(::cs_main, return m_blockman.m_block_tree_db->ReadVerifyChainProgress(progress))) return;
+    LogPrintf("Resuming background chain verification at level %d, %d of %d blocks checked\n",
+              progress.check_level, progress.blocks_checked, progress.blocks_total);
+    LaunchBackgroundVerification(progress);
+}
+
+bool ChainstateManager::LaunchBackgroundVerification(const VerifyChainProgress& progress)
+{
+    LOCK(m_background_verification_mutex);
+    if (m_background_verification_status && m_background_verification_status->running) return false;
+    // The thread of the last verification has finished
+    if (m_background_verification.joinable()) m_background_verification.join();
+    m_background_verification_status = BackgroundVerificationStatus{progress};
+    m_interrupt_background_verification.reset();
+    m_background_verification = std::thread(&util::TraceThread, "verifychain", [this, progress] { ThreadBackgroundVerification(progress); });
+    return true;
+}
+
+void ChainstateManager::ThreadBackgroundVerification(VerifyChainProgress progress)
+{
+    const int threads{m_options.check_threads};
+    const auto update_status{[&](bool paused) {
+        LOCK(m_background_verification_mutex);
+        m_background_verification_status->progress = progress;
+        m_background_verification_status->paused = paused;
+    }};
+    const auto finish{[&](bool verified) {
+        WITH_LOCK(::cs_main, m_blockman.m_block_tree_db->EraseVerifyChainProgress());
+        LOCK(m_background_verification_mutex);
+        m_background_verification_status->progress = progress;
+        m_background_verification_status->running = false;
+        m_background_verification_status->verified = verified;
+    }};
+
+    WITH_LOCK(::cs_main, m_blockman.m_block_tree_db->WriteVerifyChainProgress(progress));
+    // Don't slow down the initial block download
+    while (WITH_LOCK(::cs_main, return ActiveChainstate().IsInitialBlockDownload())) {
+        update_status(/*paused=*/true);
+        if (!m_interrupt_background_verification.sleep_for(1s)) return;
+    }
+    update_status(/*paused=*/false);
+    LogPrintf("Verifying %d blocks at level %d in the background\n", progress.blocks_total - progress.blocks_checked, progress.check_level);
+
+    // The checks of levels 0 to 2, which don't need the chain to stay as it is
+    while (!progress.next_block.IsNull()) {
+        if (m_interrupt_background_verification || ShutdownRequested()) return;
+        std::vector<const CBlockIndex*> indexes;
+        std::vector<FlatFilePos> positions;
+        std::vector<FlatFilePos> undo_positions;
+        {
+            LOCK(::cs_main);
+            const CBlockIndex* pindex{m_blockman.LookupBlockIndex(progress.next_block)};
+            for (; pindex && pindex->pprev && pindex->nHeight > progress.target_height; pindex = pindex->pprev) {
+                // Stop at pruned blocks, and at the blocks beneath a UTXO snapshot
+                if (!(pindex->nStatus & BLOCK_HAVE_DATA)) {
+                    LogPrintf("Background chain verification stopping at height %d (no data)\n", pindex->nHeight);
+                    pindex = nullptr;
+                    break;
+                }
+                if (indexes.size() == BACKGROUND_VERIFICATION_BATCH) break;
+                indexes.push_back(pindex);
+                positions.push_back(pindex->GetBlockPos());
+                undo_positions.push_back(pindex->GetUndoPos());
+            }
+            const bool more{pindex && pindex->pprev && pindex->nHeight > progress.target_height};
+            progress.next_block = more ? pindex->GetBlockHash() : uint256{};
+        }
+
+        std::vector<std::optional<std::string>> failures(indexes.size());
+        BlockPrefetcher prefetcher{positions, threads, GetConsensus(), [&](size_t i, const CBlock& block) {
+            failures[i] = CheckBlockData(block, *indexes[i], undo_positions[i], progress.check_level, GetConsensus());
+        }};
+        for (size_t i = 0; i < indexes.size(); ++i) {
+            if (m_interrupt_background_verification || ShutdownRequested()) return;
+            std::optional<std::string> failure;
+            if (!prefetcher.Next()) {
+                // The block may have been pruned since
+                if (!WITH_LOCK(::cs_main, return indexes[i]->nStatus & BLOCK_HAVE_DATA)) {
+                    LogPrintf("Background chain verification stopping at height %d (no data)\n", indexes[i]->nHeight);
+                    progress.next_block.SetNull();
+                    break;
+                }
+                failure = strprintf("ReadBlockFromDisk failed at %d, hash=%s", indexes[i]->nHeight, indexes[i]->GetBlockHash().ToString());
+            } else {
+                failure = failures[i];
+            }
+            if (failure) {
+                LogPrintf("Background chain verification: *** %s\n", *failure);
+                finish(/*verified=*/false);
+                return;
+            }
+            ++progress.blocks_checked;
+            if (progress.blocks_checked % 100 == 0) update_status(/*paused=*/false);
+        }
+        WITH_LOCK(::cs_main, m_blockman.m_block_tree_db->WriteVerifyChainProgress(progress));
+        update_status(/*paused=*/false);
+    }
+
+    // Levels 3 and 4 disconnect and reconnect blocks on the coins of the tip,
+    // which have to stay as they are while the blocks fit in the coins cache.
+    bool verified{true};
+    if (progress.check_level >= 3) {
+        LOCK(::cs_main);
+        Chainstate& chainstate{ActiveChainstate()};
+        const int depth{chainstate.m_chain.Height() - progress.target_height};
+        if (depth > 0) {
+            verified = CVerifyDB().VerifyDB(chainstate, GetConsensus(), chainstate.CoinsTip(), progress.check_level, depth, threads, /*stop_at_coins_limit=*/true);
+        }
+    }
+    if (ShutdownRequested()) return;
+    LogPrintf("Background chain verification of %d blocks at level %d %s\n", progress.blocks_checked, progress.check_level, verified ? "found no errors" : "failed");
+    finish(verified);
+}
+
+void ChainstateManager::StopBackgroundVerification()
+{
+    m_interrupt_background_verification();
+    if (m_background_verification.joinable()) m_background_verification.join();
+}
+
+std::optional<BackgroundVerificationStatus> ChainstateManager::GetBackgroundVerificationStatus() const
+{
+    LOCK(m_background_verification_mutex);
+    return m_background_verification_status;
+}
+
 ChainstateManager::~ChainstateManager()
 {
+    StopBackgroundValidation();
+    StopBackgroundVerification();
     LOCK(::cs_main);
 
     m_versionbitscache.Clear();
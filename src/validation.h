@@ -15,6 +15,7 @@
 #include <chain.h>
 #include <chainparams.h>
 #include <kernel/chainstatemanager_opts.h>
+#include <kernel/coinstats.h>
 #include <consensus/amount.h>
 #include <deploymentstatus.h>
 #include <fs.h>
@@ -24,15 +25,18 @@
 #include <policy/policy.h>
 #include <script/script_error.h>
 #include <sync.h>
+#include <threadinterrupt.h>
 #include <txdb.h>
 #include <txmempool.h> // For CTxMemPool::cs
 #include <uint256.h>
 #include <util/check.h>
 #include <util/hasher.h>
+#include <util/time.h>
 #include <util/translation.h>
 #include <versionbits.h>
 
 #include <atomic>
+#include <chrono>
 #include <map>
 #include <memory>
 #include <optional>
@@ -348,12 +352,24 @@ class CVerifyDB {
 public:
     CVerifyDB();
     ~CVerifyDB();
+    /**
+     * Verify the last nCheckDepth blocks of the chain at nCheckLevel. Up to
+     * `threads` threads read the blocks and run the checks of levels 1 and 2
+     * ahead of the level 3 disconnects, and read the blocks again ahead of the
+     * level 4 reconnects.
+     *
+     * @param[in] stop_at_coins_limit  Stop once the coins cache can't hold
+     *     more disconnected blocks, for callers that have checked the blocks
+     *     beneath at levels 0 to 2 already.
+     */
     bool VerifyDB(
         Chainstate& chainstate,
         const Consensus::Params& consensus_params,
         CCoinsView& coinsview,
         int nCheckLevel,
-        int nCheckDepth) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+        int nCheckDepth,
+        int threads = 1,
+        bool stop_at_coins_limit = false) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 };
 
 enum DisconnectResult
@@ -467,6 +483,11 @@ protected:
     //! Manages the UTXO set, which is a reflection of the contents of `m_chain`.
     std::unique_ptr<CoinsViews> m_coins_views;
 
+    //! Running statistics of the coins in CoinsTip(), updated as blocks are connected and
+    //! disconnected. Only tracked with ChainstateManager::Options::running_coins_stats, and
+    //! nullopt until they are known.
+    std::optional<kernel::RunningCoinsStats> m_coins_stats GUARDED_BY(::cs_main);
+
 public:
     //! Reference to a BlockManager instance which itself is shared across all
     //! Chainstate instances.
@@ -609,6 +630,15 @@ public:
         std::multimap<uint256, FlatFilePos>* blocks_with_unknown_parent = nullptr)
         EXCLUSIVE_LOCKS_REQUIRED(!m_chainstate_mutex);
 
+    /**
+     * Accept and connect the blocks at the given positions in the block files,
+     * for a reindex with -reindexthreads. Every block has to come after its
+     * parent. Up to `threads` threads read and check the blocks ahead of the
+     * one being accepted, which is then connected from memory.
+     */
+    void ReindexBlocks(const std::vector<FlatFilePos>& positions, int threads)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_chainstate_mutex);
+
     /**
      * Update the on-disk chain state.
      * The caches and indexes are flushed depending on the mode we're called with
@@ -628,6 +658,14 @@ public:
     //! Unconditionally flush all changes to disk.
     void ForceFlushStateToDisk();
 
+    /**
+     * Get the MuHash and basic statistics of the UTXO set from the running statistics, if they
+     * are tracked. The first call after they became unknown scans the coins database.
+     *
+     * The returned statistics do not include the number of transactions.
+     */
+    std::optional<kernel::CCoinsStats> GetRunningCoinsStats(const std::function<void()>& interruption_point) LOCKS_EXCLUDED(::cs_main);
+
     //! Prune blockfiles from the disk if necessary and then flush chainstate changes
     //! if we pruned.
     void PruneAndFlush();
@@ -766,6 +804,30 @@ private:
     friend ChainstateManager;
 };
 
+/** Progress of the background chainstate towards the base block of a UTXO snapshot. */
+struct BackgroundValidationProgress {
+    //! Height of the background chainstate's tip
+    int height;
+    //! Height of the snapshot base block
+    int target_height;
+    //! Whether background validation is waiting for the snapshot chainstate to catch up with the tip
+    bool paused;
+    //! Blocks connected per second since background validation started
+    double blocks_per_second;
+    //! Estimated time until the snapshot base block is reached, if blocks have been connected
+    std::optional<std::chrono::seconds> eta;
+};
+
+/** State of the chain verification running in the background, or of the last one. */
+struct BackgroundVerificationStatus {
+    VerifyChainProgress progress;
+    bool running{true};
+    //! Whether it is waiting for the initial block download to finish
+    bool paused{false};
+    //! Once finished, whether no errors were found
+    std::optional<bool> verified;
+};
+
 /**
  * Provides an interface for creating and interacting with one or two
  * chainstates: an IBD chainstate generated by downloading blocks, and
@@ -841,6 +903,36 @@ private:
 
     CBlockIndex* m_best_invalid GUARDED_BY(::cs_main){nullptr};
 
+    //! When background validation of the snapshot connected its first block,
+    //! and the height of the background chainstate's tip at that time.
+    std::optional<SteadyClock::time_point> m_background_validation_start GUARDED_BY(::cs_main);
+    int m_background_validation_start_height GUARDED_BY(::cs_main){0};
+
+    std::thread m_background_validation;
+    CThreadInterrupt m_interrupt_background_validation;
+
+    std::thread m_background_verification;
+    CThreadInterrupt m_interrupt_background_verification;
+    mutable Mutex m_background_verification_mutex;
+    std::optional<BackgroundVerificationStatus> m_background_verification_status GUARDED_BY(m_background_verification_mutex);
+
+    //! Start a background chain verification from progress, unless one is running.
+    bool LaunchBackgroundVerification(const VerifyChainProgress& progress) EXCLUSIVE_LOCKS_REQUIRED(!m_background_verification_mutex);
+
+    //! Check the blocks at levels 0 to 2 in batches without holding cs_main,
+    //! recording the progress after each batch, then run the level 3 and 4
+    //! checks under cs_main on the blocks the coins cache can hold.
+    void ThreadBackgroundVerification(VerifyChainProgress progress) EXCLUSIVE_LOCKS_REQUIRED(!m_background_verification_mutex);
+
+    //! Run BackgroundValidationStep() once per second within the
+    //! background_validation_budget until the snapshot has been validated.
+    void ThreadBackgroundValidation();
+
+    //! Compare the UTXO set hash of the background chainstate, once it has
+    //! reached the snapshot base block, with the assumeutxo hash and mark the
+    //! snapshot as validated if they match.
+    bool CompleteSnapshotValidation() LOCKS_EXCLUDED(::cs_main);
+
     //! Internal helper for ActivateSnapshot().
     [[nodiscard]] bool PopulateAndValidateSnapshot(
         Chainstate& snapshot_chainstate,
@@ -983,6 +1075,54 @@ public:
     //! Is there a snapshot in use and has it been fully validated?
     bool IsSnapshotValidated() const EXCLUSIVE_LOCKS_REQUIRED(::cs_main) { return m_snapshot_validated; }
 
+    //! The base block of the snapshot in use, if any.
+    const CBlockIndex* GetSnapshotBaseBlock() const EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+    //! The chainstate validating the blocks beneath the snapshot base block,
+    //! or nullptr if no snapshot is in use or it has been validated.
+    Chainstate* BackgroundSyncChainstate() const EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+    //! Progress of the background chainstate, if background validation is in progress.
+    std::optional<BackgroundValidationProgress> GetBackgroundValidationProgress() const EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+    /**
+     * Connect blocks on the background chainstate towards the snapshot base
+     * block for at most `budget`, in batches of blocks whose data is on disk.
+     * Does nothing while the snapshot chainstate is still catching up with
+     * the tip, so that following the tip is never slowed down by background
+     * validation.
+     *
+     * @returns false once there is nothing left to validate.
+     */
+    bool BackgroundValidationStep(std::chrono::microseconds budget) LOCKS_EXCLUDED(::cs_main);
+
+    //! Start background validation of a snapshot chainstate in a separate thread.
+    void StartBackgroundValidation();
+
+    //! Interrupt background validation and wait for its thread to exit.
+    void StopBackgroundValidation();
+
+    /**
+     * Verify the last check_depth blocks (0 = all) of the active chain at
+     * check_level in the background, once the initial block download is done.
+     * The progress is recorded in the block tree database, so that a
+     * verification interrupted by a shutdown continues on the next start.
+     *
+     * @returns false if a background verification is already running.
+     */
+    bool StartBackgroundVerification(int check_level, int check_depth)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_background_verification_mutex) LOCKS_EXCLUDED(::cs_main);
+
+    //! Continue a background verification that was interrupted by a shutdown, if any.
+    void ResumeBackgroundVerification() EXCLUSIVE_LOCKS_REQUIRED(!m_background_verification_mutex) LOCKS_EXCLUDED(::cs_main);
+
+    //! Interrupt background verification and wait for its thread to exit.
+    void StopBackgroundVerification();
+
+    //! State of the running or the last background verification since startup, if any.
+    std::optional<BackgroundVerificationStatus> GetBackgroundVerificationStatus() const
+        EXCLUSIVE_LOCKS_REQUIRED(!m_background_verification_mutex);
+
     /**
      * Process an incoming block. This only returns after the best known valid
      * block is made active. Note that it does not, however, guarantee that the
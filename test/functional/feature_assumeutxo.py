@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 The Garikcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test loading a UTXO snapshot with loadtxoutset.
+
+A node with only the headers chain loads a snapshot written by another
+node's dumptxoutset, then follows the tip from the snapshot's base block
+while downloading and validating the blocks beneath it in the background.
+The snapshot height and its UTXO set hash are the regtest assumeutxo values
+in chainparams.
+"""
+
+from test_framework.test_framework import GarikcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_raises_rpc_error,
+)
+
+SNAPSHOT_BASE_HEIGHT = 299
+FINAL_HEIGHT = 310
+
+
+class AssumeutxoTest(GarikcoinTestFramework):
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 2
+
+    def setup_network(self):
+        # The nodes are connected only once the snapshot is loaded
+        self.setup_nodes()
+
+    def run_test(self):
+        n0 = self.nodes[0]
+        n1 = self.nodes[1]
+
+        # The snapshot depends on the blocks, which are deterministic with a mocked time
+        mocktime = n0.getblockheader(n0.getblockhash(0))['time'] + 1
+        n0.setmocktime(mocktime)
+        # Keep node1's tip recent enough to leave initial block download, which background validation waits for
+        n1.setmocktime(mocktime)
+        self.generate(n0, SNAPSHOT_BASE_HEIGHT, sync_fun=self.no_op)
+
+        self.log.info("Write a snapshot of the UTXO set")
+        dump_output = n0.dumptxoutset('utxos.dat')
+        assert_equal(dump_output['coins_written'], SNAPSHOT_BASE_HEIGHT)
+        assert_equal(dump_output['base_height'], SNAPSHOT_BASE_HEIGHT)
+        assert_equal(dump_output['txoutset_hash'], 'aa6b0043c9e4ef331cf2fbd05e98827767c9b00aa767eb1c3753194022994ec7')
+        assert_equal(dump_output['nchaintx'], SNAPSHOT_BASE_HEIGHT + 1)
+        with open(dump_output['path'], 'rb') as f:
+            snapshot = f.read()
+
+        self.log.info("Test loading a snapshot that cannot be opened or parsed")
+        assert_raises_rpc_error(-8, "Couldn't open file", n1.loadtxoutset, 'missing.dat')
+        bad_magic_path = n1.chain_path / 'bad_magic.dat'
+        with open(bad_magic_path, 'wb') as f:
+            f.write(b'\x00' + snapshot[1:])
+        assert_raises_rpc_error(-22, "Unable to parse snapshot metadata: Invalid UTXO snapshot magic bytes", n1.loadtxoutset, str(bad_magic_path))
+        bad_version_path = n1.chain_path / 'bad_version.dat'
+        with open(bad_version_path, 'wb') as f:
+            f.write(snapshot[:5] + b'\x01\x00' + snapshot[7:])
+        assert_raises_rpc_error(-22, "Unable to parse snapshot metadata: Unsupported UTXO snapshot version", n1.loadtxoutset, str(bad_version_path))
+
+        snapshot_path = n1.chain_path / 'utxos.dat'
+        with open(snapshot_path, 'wb') as f:
+            f.write(snapshot)
+
+        self.log.info("Test that the base block header must be known")
+        assert_raises_rpc_error(-5, "must appear in the headers chain", n1.loadtxoutset, str(snapshot_path))
+        for height in range(1, SNAPSHOT_BASE_HEIGHT + 1):
+            n1.submitheader(n0.getblockheader(n0.getblockhash(height), False))
+        assert_equal(n1.getblockcount(), 0)
+
+        self.log.info("Test that malleated snapshots are rejected")
+        # The metadata is 5 magic bytes, a 2-byte version, the base block hash and an 8-byte coins count
+        first_coins = 5 + 2 + 32 + 8
+        for name, data in [
+            ("truncated", snapshot[:-1]),
+            ("trailing data", snapshot + b'\x00'),
+            ("tampered txid", snapshot[:first_coins] + bytes([snapshot[first_coins] ^ 1]) + snapshot[first_coins + 1:]),
+            ("tampered coin", snapshot[:-1] + bytes([snapshot[-1] ^ 1])),
+        ]:
+            self.log.debug(f"Load {name} snapshot")
+            bad_path = n1.chain_path / 'bad.dat'
+            with open(bad_path, 'wb') as f:
+                f.write(data)
+            assert_raises_rpc_error(-32603, "Unable to load UTXO snapshot", n1.loadtxoutset, str(bad_path))
+        assert_equal(n1.getblockcount(), 0)
+
+        self.log.info("Load the snapshot")
+        load_output = n1.loadtxoutset(str(snapshot_path))
+        assert_equal(load_output['coins_loaded'], SNAPSHOT_BASE_HEIGHT)
+        assert_equal(load_output['base_height'], SNAPSHOT_BASE_HEIGHT)
+        assert_equal(load_output['tip_hash'], dump_output['base_hash'])
+        assert_equal(load_output['path'], str(snapshot_path))
+        assert_equal(n1.getbestblockhash(), dump_output['base_hash'])
+        for hash_type in ["hash_serialized_2", "muhash"]:
+            info0 = n0.gettxoutsetinfo(hash_type)
+            info1 = n1.gettxoutsetinfo(hash_type)
+            for key in ["height", "bestblock", "txouts", "bogosize", hash_type, "total_amount"]:
+                assert_equal(info1[key], info0[key])
+        assert_raises_rpc_error(-1, "already at or past the snapshot's base block", n1.loadtxoutset, str(snapshot_path))
+
+        chainstates = n1.getchainstates()
+        assert_equal(chainstates['headers'], SNAPSHOT_BASE_HEIGHT)
+        background, snapshot_chainstate = chainstates['chainstates']
+        assert_equal(background['blocks'], 0)
+        assert_equal(background['active'], False)
+        assert_equal(background['validated'], True)
+        assert 'snapshot_blockhash' not in background
+        assert_equal(snapshot_chainstate['blocks'], SNAPSHOT_BASE_HEIGHT)
+        assert_equal(snapshot_chainstate['snapshot_blockhash'], dump_output['base_hash'])
+        assert_equal(snapshot_chainstate['active'], True)
+        assert_equal(snapshot_chainstate['validated'], False)
+        assert_equal(chainstates['background_validation']['blocks'], 0)
+        assert_equal(chainstates['background_validation']['target'], SNAPSHOT_BASE_HEIGHT)
+        assert_equal(chainstates['background_validation']['budget'], 50)
+        assert_equal(chainstates['background_validation']['paused'], False)
+
+        self.log.info("Follow the tip from the snapshot's base block")
+        self.generate(n0, FINAL_HEIGHT - SNAPSHOT_BASE_HEIGHT, sync_fun=self.no_op)
+        self.connect_nodes(0, 1)
+        self.sync_blocks()
+        assert_equal(n1.getblockcount(), FINAL_HEIGHT)
+        assert_equal(n1.gettxoutsetinfo("muhash")["muhash"], n0.gettxoutsetinfo("muhash")["muhash"])
+
+        self.log.info("Validate the blocks beneath the snapshot in the background")
+        self.wait_until(lambda: len(n1.getchainstates()['chainstates']) == 1)
+        chainstates = n1.getchainstates()
+        assert 'background_validation' not in chainstates
+        assert_equal(chainstates['chainstates'][0]['blocks'], FINAL_HEIGHT)
+        assert_equal(chainstates['chainstates'][0]['validated'], True)
+        assert_equal(n1.getblock(n1.getblockhash(1))['hash'], n0.getblockhash(1))
+        assert_equal(n1.gettxoutsetinfo("muhash")["muhash"], n0.gettxoutsetinfo("muhash")["muhash"])
+
+
+if __name__ == '__main__':
+    AssumeutxoTest().main()
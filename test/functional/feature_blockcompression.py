@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 The Garikcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test compressing block files with -blockcompression.
+
+Complete block files are compressed in the background. Their blocks stay
+readable, also without -blockcompression, through the transaction index and
+for reindexing. The last block file, which blocks are added to, is left alone.
+"""
+
+from test_framework.test_framework import GarikcoinTestFramework
+from test_framework.util import assert_equal
+
+
+class BlockCompressionTest(GarikcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+        # Use block files of 64 KiB
+        self.extra_args = [["-fastprune", "-txindex"]]
+
+    def blocks_readable(self, node):
+        blocks = [node.getblock(node.getblockhash(height), 2) for height in range(1, node.getblockcount() + 1, 25)]
+        # Transactions of many blocks are read from the same file, before they are cached
+        coinbases = [block['tx'][0] for block in reversed(blocks)]
+        assert_equal(node.getrawtransactions([tx['txid'] for tx in coinbases]), [tx['hex'] for tx in coinbases])
+        for height, block in zip(range(1, node.getblockcount() + 1, 25), blocks):
+            assert_equal(block['height'], height)
+            coinbase = block['tx'][0]
+            assert_equal(node.getrawtransaction(coinbase['txid'], True)['blockhash'], block['hash'])
+
+    def run_test(self):
+        node = self.nodes[0]
+        blocks_dir = node.chain_path / 'blocks'
+        self.generate(node, 500)
+        best_block = node.getbestblockhash()
+        height = node.getblockcount()
+        sizes = {name: (blocks_dir / name).stat().st_size for name in ['blk00000.dat', 'blk00001.dat']}
+        self.wait_until(lambda: node.getindexinfo()['txindex']['synced'])
+
+        self.log.info("Compress the complete block files")
+        with node.assert_debug_log(["Compressed block file blk00000.dat", "Compressed block file blk00001.dat"], timeout=30):
+            self.restart_node(0, extra_args=self.extra_args[0] + ["-blockcompression"])
+        for name, size in sizes.items():
+            assert (blocks_dir / name).stat().st_size < size
+        assert not (blocks_dir / 'blk00000.dat.new').exists()
+        assert_equal(node.getbestblockhash(), best_block)
+        self.blocks_readable(node)
+
+        self.log.info("Test that compressed block files stay readable without -blockcompression")
+        self.restart_node(0)
+        self.blocks_readable(node)
+
+        self.log.info("Test reindexing from compressed block files")
+        self.restart_node(0, extra_args=self.extra_args[0] + ["-reindex"])
+        self.wait_until(lambda: node.getblockcount() == height)
+        assert_equal(node.getbestblockhash(), best_block)
+        self.wait_until(lambda: node.getindexinfo()['txindex']['synced'])
+        self.blocks_readable(node)
+
+        self.log.info("Test reindexing from compressed block files with -reindexthreads")
+        self.restart_node(0, extra_args=self.extra_args[0] + ["-reindex", "-reindexthreads=2"])
+        self.wait_until(lambda: node.getblockcount() == height)
+        assert_equal(node.getbestblockhash(), best_block)
+        self.blocks_readable(node)
+
+        self.log.info("Test that new blocks are still added")
+        self.generate(node, 10)
+        self.blocks_readable(node)
+
+
+if __name__ == '__main__':
+    BlockCompressionTest().main()
@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 The Garikcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test loading the block index from the snapshot written on clean shutdown.
+
+The snapshot is only used while the block tree database has not changed
+since it was written. Otherwise, or if the file is damaged, the block index
+is loaded from the database.
+"""
+
+from test_framework.address import ADDRESS_BCRT1_UNSPENDABLE
+from test_framework.test_framework import GarikcoinTestFramework
+from test_framework.util import assert_equal
+
+
+class BlockIndexSnapshotTest(GarikcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+
+    def run_test(self):
+        node = self.nodes[0]
+        snapshot_path = node.chain_path / 'blocks' / 'blockindex.dat'
+
+        self.log.info("Test that a clean shutdown writes a snapshot that the next startup loads")
+        # Keep an invalid fork to check that block status survives the snapshot
+        fork_tip = self.generatetoaddress(node, 2, ADDRESS_BCRT1_UNSPENDABLE)[-1]
+        node.invalidateblock(fork_tip)
+        self.generate(node, 3)
+        chain_tips = node.getchaintips()
+        best_block = node.getbestblockhash()
+        with node.assert_debug_log(["Wrote block index snapshot of 206 entries"]):
+            self.stop_node(0)
+        assert snapshot_path.exists()
+        with node.assert_debug_log(["Loaded block index snapshot of 206 entries"], unexpected_msgs=["Block index snapshot"]):
+            self.start_node(0)
+        assert_equal(node.getbestblockhash(), best_block)
+        assert_equal(node.getchaintips(), chain_tips)
+        assert_equal(node.getblock(fork_tip)['confirmations'], -1)
+
+        self.log.info("Test that a snapshot is not used once the database has changed")
+        self.generate(node, 1)
+        # Flush the block index to the database, then shut down uncleanly
+        node.gettxoutsetinfo()
+        node.process.kill()
+        node.process.wait()
+        with node.assert_debug_log([], unexpected_msgs=["Loaded block index snapshot"]):
+            node.start()
+            node.wait_for_rpc_connection()
+        assert_equal(node.getblockcount(), 205)
+
+        self.log.info("Test that a damaged snapshot is not used")
+        self.stop_node(0)
+        with open(snapshot_path, 'r+b') as f:
+            f.seek(100)
+            byte = f.read(1)
+            f.seek(100)
+            f.write(bytes([byte[0] ^ 1]))
+        with node.assert_debug_log(["does not match the database, loading the block index from the database"]):
+            self.start_node(0)
+        assert_equal(node.getblockcount(), 205)
+
+        self.log.info("Test that a missing snapshot is not used")
+        self.stop_node(0)
+        snapshot_path.unlink()
+        with node.assert_debug_log(["is missing, loading the block index from the database"]):
+            self.start_node(0)
+        assert_equal(node.getblockcount(), 205)
+
+
+if __name__ == '__main__':
+    BlockIndexSnapshotTest().main()
@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 The Garikcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test -pruneundodepth, -prunebatch and the getpruneplan RPC."""
+from test_framework.test_framework import GarikcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_greater_than,
+    assert_raises_rpc_error,
+)
+
+PRUNE_ARGS = ["-fastprune", "-prune=1"]
+
+
+class PrunePlanTest(GarikcoinTestFramework):
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 1
+
+    def run_test(self):
+        node = self.nodes[0]
+        assert_raises_rpc_error(-1, "Cannot prune blocks because node is not in prune mode.", node.getpruneplan)
+
+        self.log.info("Test invalid pruning options")
+        self.stop_node(0)
+        node.assert_start_raises_init_error(PRUNE_ARGS + ["-pruneundodepth=287"], "Error: -pruneundodepth must be at least 288")
+        node.assert_start_raises_init_error(PRUNE_ARGS + ["-prunebatch=-1"], "Error: -prunebatch must not be negative")
+
+        self.log.info("Test the plan of a node that prunes manually")
+        self.start_node(0, extra_args=PRUNE_ARGS + ["-blockfilterindex"])
+        self.generate(node, 1000)
+        self.wait_until(lambda: node.getindexinfo()['basic block filter index']['best_block_height'] == 1000)
+        size_on_disk = node.getblockchaininfo()['size_on_disk']
+        assert_equal(node.getpruneplan(), {
+            'pruneheight': 0,
+            'undodepth': 288,
+            'maxpruneheight': 712,
+            'prunelocks': [{'name': 'basic block filter index', 'height': 1000}],
+            'automatic_pruning': False,
+            'batch': 8,
+            'size_on_disk': size_on_disk,
+            'size_after_pruning': size_on_disk,
+            'files': [],
+            'incomplete': False,
+        })
+
+        self.log.info("Test that -pruneundodepth keeps more blocks and undo data")
+        self.restart_node(0, extra_args=PRUNE_ARGS + ["-pruneundodepth=500", "-prunebatch=0"])
+        plan = node.getpruneplan()
+        assert_equal(plan['undodepth'], 500)
+        assert_equal(plan['maxpruneheight'], 500)
+        assert_equal(plan['prunelocks'], [])
+        assert_equal(plan['batch'], 0)
+        pruneheight = node.pruneblockchain(800)
+        assert_greater_than(pruneheight, 0)
+        assert pruneheight <= 500
+        assert_equal(node.getpruneplan()['pruneheight'], pruneheight + 1)
+        assert_raises_rpc_error(-1, "Block not available (pruned data)", node.getblock, node.getblockhash(pruneheight))
+        node.getblock(node.getblockhash(501))
+
+if __name__ == '__main__':
+    PrunePlanTest().main()
@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 The Garikcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test -reindex with -reindexthreads.
+
+The block files are scanned in parallel and the blocks are then accepted
+parent first, so the result has to match a sequential reindex, also with
+stale blocks, blocks stored out of order and blocks spread over many files.
+"""
+
+from test_framework.address import ADDRESS_BCRT1_UNSPENDABLE
+from test_framework.p2p import MAGIC_BYTES
+from test_framework.test_framework import GarikcoinTestFramework
+from test_framework.util import assert_equal
+
+
+class ReindexParallelTest(GarikcoinTestFramework):
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 1
+        # Small block files, so that there are many of them to scan
+        self.extra_args = [["-fastprune"]]
+
+    def reindex(self, threads, expected_msgs=[]):
+        node = self.nodes[0]
+        with node.assert_debug_log([f"Reindexing block files with {threads} threads"] + expected_msgs):
+            self.restart_node(0, extra_args=["-fastprune", "-reindex", f"-reindexthreads={threads}"])
+
+    def read_records(self, path):
+        """Split a block file into the records of its blocks."""
+        magic = MAGIC_BYTES[self.chain]
+        with open(path, 'rb') as f:
+            data = f.read()
+        records = []
+        pos = 0
+        while data[pos:pos + 4] == magic:
+            size = int.from_bytes(data[pos + 4:pos + 8], 'little')
+            records.append(data[pos:pos + 8 + size])
+            pos += 8 + size
+        return records
+
+    def run_test(self):
+        node = self.nodes[0]
+        self.generate(node, 600)
+        # A stale fork of two blocks
+        fork_tip = self.generatetoaddress(node, 2, ADDRESS_BCRT1_UNSPENDABLE)[-1]
+        node.invalidateblock(node.getblockhash(601))
+        self.generate(node, 3)
+        best_block = node.getbestblockhash()
+        # The status of the stale fork isn't kept by a reindex
+        chain_tips = [(tip['height'], tip['hash']) for tip in node.getchaintips()]
+        assert (node.chain_path / 'blocks' / 'blk00002.dat').exists()
+
+        self.log.info("Test that a parallel reindex rebuilds the same block index and chain")
+        self.reindex(3)
+        assert_equal(node.getbestblockhash(), best_block)
+        assert_equal([(tip['height'], tip['hash']) for tip in node.getchaintips()], chain_tips)
+        assert_equal(node.getblock(fork_tip)['confirmations'], -1)
+        assert_equal(node.gettxoutsetinfo()['height'], 603)
+
+        self.log.info("Test blocks stored before their parent")
+        self.stop_node(0)
+        blk0 = node.chain_path / 'blocks' / 'blk00000.dat'
+        records = self.read_records(blk0)
+        # Keep the genesis block first and store blocks 1 and 2 after blocks 3 and 4
+        with open(blk0, 'r+b') as f:
+            f.write(b''.join([records[0]] + records[3:5] + records[1:3] + records[5:]))
+        self.reindex(1)
+        assert_equal(node.getbestblockhash(), best_block)
+        assert_equal([(tip['height'], tip['hash']) for tip in node.getchaintips()], chain_tips)
+
+        self.log.info("Test that blocks whose parent is missing are skipped")
+        self.stop_node(0)
+        records = self.read_records(blk0)
+        # Overwrite the magic of the tenth record, block 9, which orphans all blocks after it
+        with open(blk0, 'r+b') as f:
+            f.seek(sum(len(r) for r in records[:9]))
+            f.write(b'\x00' * 4)
+        # Of the 605 blocks left, only the genesis block and blocks 1 to 8 can be connected
+        self.reindex(2, ["Skipping 596 blocks with unknown parent"])
+        assert_equal(node.getblockcount(), 8)
+
+
+if __name__ == '__main__':
+    ReindexParallelTest().main()
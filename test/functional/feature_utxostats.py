@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 The Garikcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the running UTXO set statistics kept with -utxostats.
+
+Test that gettxoutsetinfo returns the same values from the running
+statistics as a node scanning its UTXO set, across blocks, reorgs and
+restarts.
+"""
+
+from test_framework.messages import COIN
+from test_framework.script import (
+    CScript,
+    OP_RETURN,
+)
+from test_framework.test_framework import GarikcoinTestFramework
+from test_framework.util import assert_equal
+from test_framework.wallet import (
+    MiniWallet,
+    getnewdestination,
+)
+
+
+class UTXOStatsTest(GarikcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 2
+        self.supports_cli = False
+        self.extra_args = [
+            ["-utxostats"],
+            [],
+        ]
+
+    def assert_stats_match(self):
+        self.sync_blocks()
+        running = self.nodes[0].gettxoutsetinfo("muhash")
+        scanned = self.nodes[1].gettxoutsetinfo("muhash")
+        for key in ["height", "bestblock", "txouts", "bogosize", "muhash", "total_amount"]:
+            assert_equal(running[key], scanned[key])
+        assert "transactions" not in running
+        assert "transactions" in scanned
+        assert running["disk_size"] > 0
+
+        running_none = self.nodes[0].gettxoutsetinfo("none")
+        assert_equal(running_none["txouts"], scanned["txouts"])
+        assert "muhash" not in running_none
+
+        # The legacy hash still scans the UTXO set
+        assert_equal(self.nodes[0].gettxoutsetinfo()["hash_serialized_2"], self.nodes[1].gettxoutsetinfo()["hash_serialized_2"])
+
+    def run_test(self):
+        node = self.nodes[0]
+        wallet = MiniWallet(node)
+        wallet.rescan_utxos()
+
+        self.log.info("Test statistics are computed on first use")
+        self.assert_stats_match()
+
+        self.log.info("Test statistics follow connected blocks")
+        for _ in range(5):
+            wallet.send_self_transfer(from_node=node)
+        wallet.send_to(from_node=node, scriptPubKey=getnewdestination()[1], amount=2 * COIN)
+        # Unspendable outputs are never added to the UTXO set
+        wallet.send_to(from_node=node, scriptPubKey=CScript([OP_RETURN, b'\x01']), amount=COIN)
+        self.generate(node, 1)
+        self.assert_stats_match()
+
+        # Spend outputs created in the same block
+        tx = wallet.send_self_transfer(from_node=node)
+        wallet.send_self_transfer(from_node=node, utxo_to_spend=tx["new_utxo"])
+        self.generate(node, 2)
+        self.assert_stats_match()
+
+        self.log.info("Test statistics follow disconnected blocks")
+        tip = node.getbestblockhash()
+        invalid = node.getblockhash(node.getblockcount() - 2)
+        for n in self.nodes:
+            n.invalidateblock(invalid)
+        self.assert_stats_match()
+        for n in self.nodes:
+            n.reconsiderblock(invalid)
+        assert_equal(node.getbestblockhash(), tip)
+        self.assert_stats_match()
+
+        self.log.info("Test statistics are persisted across restarts")
+        with node.assert_debug_log(expected_msgs=[], unexpected_msgs=["No UTXO set statistics"]):
+            self.restart_node(0)
+        self.connect_nodes(0, 1)
+        self.assert_stats_match()
+
+        self.log.info("Test stale statistics are ignored")
+        self.restart_node(0, extra_args=[])
+        self.generate(self.nodes[1], 3, sync_fun=self.no_op)
+        self.connect_nodes(0, 1)
+        self.sync_blocks()
+        with node.assert_debug_log(expected_msgs=["No UTXO set statistics"]):
+            self.restart_node(0)
+        self.connect_nodes(0, 1)
+        self.assert_stats_match()
+
+
+if __name__ == '__main__':
+    UTXOStatsTest().main()
@@ -288,10 +288,10 @@ class RESTTest (GarikcoinTestFramework):
 
         # See if we can get 5 headers in one response
         self.generate(self.nodes[1], 5)
-        expected_filter = {
-            'basic block filter index': {'synced': True, 'best_block_height': 208},
-        }
-        self.wait_until(lambda: self.nodes[0].getindexinfo() == expected_filter)
+        def filter_index_synced():
+            info = self.nodes[0].getindexinfo()['basic block filter index']
+            return info['synced'] and info['best_block_height'] == 208
+        self.wait_until(filter_index_synced)
         json_obj = self.test_rest_request(f"/headers/{bb_hash}", query_params={"count": 5})
         assert_equal(len(json_obj), 5)  # now we should have 5 header objects
         json_obj = self.test_rest_request(f"/blockfilterheaders/basic/{bb_hash}", query_params={"count": 5})
@@ -46,6 +46,19 @@ class GetBlockFilterTest(GarikcoinTestFramework):
                 result = self.nodes[0].getblockfilter(block_hash, filter_type)
                 assert_is_hex_string(result['filter'])
 
+        # Test filters are served from the cache once they have been read from disk
+        def filter_cache():
+            return self.nodes[0].getindexinfo("basic block filter index")["basic block filter index"]["filter_cache"]
+        cache_before = filter_cache()
+        for block_hash in chain0_hashes + chain1_hashes:
+            self.nodes[0].getblockfilter(block_hash, "basic")
+        cache_after = filter_cache()
+        assert_equal(cache_after["entries"], len(set(chain0_hashes + chain1_hashes)))
+        assert_equal(cache_after["hits"] - cache_before["hits"], len(chain0_hashes + chain1_hashes))
+        assert_equal(cache_after["misses"], cache_before["misses"])
+        assert cache_after["usage"] > 0
+        assert 0 < cache_after["hit_ratio"] <= 1
+
         # Test getblockfilter with unknown block
         bad_block_hash = "0123456789abcdef" * 4
         assert_raises_rpc_error(-5, "Block not found", self.nodes[0].getblockfilter, bad_block_hash, "basic")
@@ -85,21 +85,54 @@ class RpcMiscTest(GarikcoinTestFramework):
 
         # Returns a list of all running indices by default
         values = {"synced": True, "best_block_height": 200}
+        empty_cache = {"entries": 0, "usage": 0, "hits": 0, "misses": 0, "hit_ratio": 0}
+        tx_values = {**values, "tx_cache": empty_cache}
+        filter_values = {**values, "filter_cache": empty_cache}
         assert_equal(
             node.getindexinfo(),
             {
-                "txindex": values,
-                "basic block filter index": values,
+                "txindex": tx_values,
+                "basic block filter index": filter_values,
                 "coinstatsindex": values,
             }
         )
         # Specifying an index by name returns only the status of that index
-        for i in {"txindex", "basic block filter index", "coinstatsindex"}:
-            assert_equal(node.getindexinfo(i), {i: values})
+        assert_equal(node.getindexinfo("txindex"), {"txindex": tx_values})
+        assert_equal(node.getindexinfo("coinstatsindex"), {"coinstatsindex": values})
+        assert_equal(node.getindexinfo("basic block filter index"), {"basic block filter index": filter_values})
 
         # Specifying an unknown index name returns an empty result
         assert_equal(node.getindexinfo("foo"), {})
 
+        self.log.info("test getdatabaseinfo and compactdatabase")
+        self.restart_node(0, ["-txindex", "-dboption=*:bloombits=0", "-dboption=chainstate:blocksize=16"])
+        self.wait_until(lambda: node.getindexinfo()["txindex"]["synced"])
+        databases = node.getdatabaseinfo()
+        assert_equal(sorted(databases), ["blocks/index", "chainstate", "indexes/txindex"])
+        chainstate = databases["chainstate"]
+        assert_equal(chainstate["options"]["bloombits"], 0)
+        assert_equal(chainstate["options"]["blocksize"], 16 << 10)
+        assert_equal(databases["blocks/index"]["options"]["blocksize"], 4 << 10)
+        assert_greater_than(chainstate["memory_usage"], 0)
+        assert "compaction" not in chainstate
+        assert_equal(node.getdatabaseinfo("chainstate"), {"chainstate": node.getdatabaseinfo()["chainstate"]})
+        assert_raises_rpc_error(-8, "No open database named foo", node.getdatabaseinfo, "foo")
+
+        assert_raises_rpc_error(-8, "No open database named foo", node.compactdatabase, "foo")
+        compaction = node.compactdatabase("indexes/txindex", "74", "75")
+        assert_equal(compaction["begin"], "74")
+        assert_equal(compaction["end"], "75")
+        self.wait_until(lambda: not node.getdatabaseinfo("indexes/txindex")["indexes/txindex"]["compaction"]["running"])
+        compaction = node.getdatabaseinfo("indexes/txindex")["indexes/txindex"]["compaction"]
+        assert_greater_than_or_equal(compaction["duration_ms"], 0)
+        node.compactdatabase("chainstate")
+        self.wait_until(lambda: "duration_ms" in node.getdatabaseinfo("chainstate")["chainstate"]["compaction"])
+        assert_greater_than(node.getdatabaseinfo("chainstate")["chainstate"]["approximate_size"], 0)
+
+        self.stop_node(0)
+        self.nodes[0].assert_start_raises_init_error(["-dboption=chainstate:blockcache=101"], "Error: Invalid value in -dboption 'chainstate:blockcache=101', blockcache is a percentage of the cache")
+        self.start_node(0)
+
 
 if __name__ == '__main__':
     RpcMiscTest().main()
@@ -6,6 +6,7 @@
 
 Test the following RPCs:
    - getrawtransaction
+   - getrawtransactions
    - createrawtransaction
    - signrawtransactionwithwallet
    - sendrawtransaction
@@ -80,6 +81,7 @@ class RawTransactionsTest(GarikcoinTestFramework):
         self.generate(self.nodes[0], COINBASE_MATURITY + 1)
 
         self.getrawtransaction_tests()
+        self.getrawtransactions_tests()
         self.createrawtransaction_tests()
         self.sendrawtransaction_tests()
         self.sendrawtransaction_testmempoolaccept_tests()
@@ -170,6 +172,53 @@ class RawTransactionsTest(GarikcoinTestFramework):
         block = self.nodes[0].getblock(self.nodes[0].getblockhash(0))
         assert_raises_rpc_error(-5, "The genesis block coinbase is not considered an ordinary transaction", self.nodes[0].getrawtransaction, block['merkleroot'])
 
+    def getrawtransactions_tests(self):
+        self.log.info("Test getrawtransactions")
+        # Spread the transactions over some blocks, and leave the last one in the mempool
+        txs = []
+        for _ in range(3):
+            txs += [self.wallet.send_self_transfer(from_node=self.nodes[0]) for _ in range(3)]
+            block = self.generate(self.nodes[0], 1)[0]
+        mempool_tx = self.wallet.send_self_transfer(from_node=self.nodes[0])
+        self.sync_mempools()
+        txs.append(mempool_tx)
+        # In reverse order, with a duplicate and an unknown transaction
+        txids = [tx['txid'] for tx in reversed(txs)] + [txs[0]['txid'], TXID]
+        hexes = [tx['hex'] for tx in reversed(txs)] + [txs[0]['hex'], None]
+
+        def tx_cache():
+            return self.nodes[0].getindexinfo("txindex")["txindex"]["tx_cache"]
+        cache_before = tx_cache()
+        assert_equal(self.nodes[0].getrawtransactions(txids), hexes)
+        cache_after = tx_cache()
+        # The mempool transaction isn't looked up in the index, the others are cached once read
+        assert_equal(cache_after["entries"], cache_before["entries"] + 9)
+        assert_equal(cache_after["misses"], cache_before["misses"] + 11)
+        assert_equal(cache_after["hits"], cache_before["hits"])
+        assert_equal(self.nodes[0].getrawtransactions(txids), hexes)
+        assert_equal(tx_cache()["hits"], cache_after["hits"] + 10)
+        assert_equal(tx_cache()["misses"], cache_after["misses"] + 1)
+
+        verbose = self.nodes[0].getrawtransactions(txids, True)
+        assert_equal([tx['hex'] if tx else None for tx in verbose], hexes)
+        assert_equal(verbose[-1], None)
+        assert 'blockhash' not in verbose[0]
+        assert_equal(verbose[1]['blockhash'], block)
+        assert_equal(verbose[1]['confirmations'], 1)
+        assert_equal(verbose[-3]['confirmations'], 3)
+        for tx, txid in zip(verbose[:-1], txids[:-1]):
+            assert_equal(tx['txid'], txid)
+
+        self.log.info("Test getrawtransactions without -txindex only returns mempool transactions")
+        assert_equal(self.nodes[2].getrawtransactions(txids), [mempool_tx['hex']] + [None] * (len(txids) - 1))
+        assert_equal(self.nodes[2].getrawtransactions([]), [])
+
+        self.log.info("Test getrawtransactions with invalid parameters")
+        assert_raises_rpc_error(-3, "not of expected type array", self.nodes[0].getrawtransactions, TXID)
+        assert_raises_rpc_error(-8, "txids[1] must be of length 64 (not 6, for 'foobar')", self.nodes[0].getrawtransactions, [TXID, "foobar"])
+        assert_raises_rpc_error(-3, "not of expected type bool", self.nodes[0].getrawtransactions, [TXID], "True")
+        self.generate(self.nodes[0], 1)
+
     def createrawtransaction_tests(self):
         self.log.info("Test createrawtransaction")
         # Test `createrawtransaction` required parameters
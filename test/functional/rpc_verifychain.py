@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+# Copyright (c) 2022 The Garikcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test verifychain, in the foreground and in the background.
+
+A background verification waits for the initial block download to finish,
+reports its progress through getverifychaininfo and continues after a
+restart.
+"""
+from test_framework.test_framework import GarikcoinTestFramework
+from test_framework.util import assert_equal
+
+CHAIN_HEIGHT = 200
+
+
+class VerifyChainTest(GarikcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+        self.extra_args = [["-checkthreads=3"]]
+
+    def wait_for_verification(self, node):
+        self.wait_until(lambda: not node.getverifychaininfo()['running'])
+        return node.getverifychaininfo()
+
+    def run_test(self):
+        node = self.nodes[0]
+        assert_equal(node.getblockcount(), CHAIN_HEIGHT)
+        assert_equal(node.getverifychaininfo(), {'running': False})
+
+        self.log.info("Test verifychain in the foreground at every level")
+        for level in range(5):
+            assert node.verifychain(level, 0)
+        with node.assert_debug_log([f"No coin database inconsistencies in last {CHAIN_HEIGHT} blocks"]):
+            self.restart_node(0, extra_args=self.extra_args[0] + ["-checkblocks=0", "-checklevel=4"])
+
+        self.log.info("Test verifychain in the background")
+        for level in [2, 4]:
+            with node.assert_debug_log([f"Background chain verification of {CHAIN_HEIGHT} blocks at level {level} found no errors"]):
+                assert node.verifychain(level, 0, True)
+                info = self.wait_for_verification(node)
+            assert_equal(info, {
+                'running': False,
+                'checklevel': level,
+                'blocks': CHAIN_HEIGHT,
+                'target': CHAIN_HEIGHT,
+                'progress': 1,
+                'verified': True,
+            })
+        assert node.verifychain(1, 50, True)
+        assert_equal(self.wait_for_verification(node)['blocks'], 50)
+
+        self.log.info("Test that a background verification waits for the initial block download and resumes after a restart")
+        # Consider the tip too old to leave the initial block download
+        tip_time = node.getblockheader(node.getbestblockhash())['time']
+        self.restart_node(0, extra_args=self.extra_args[0] + [f"-mocktime={tip_time + 10 * 24 * 60 * 60}"])
+        assert node.getblockchaininfo()['initialblockdownload']
+        assert node.verifychain(2, 0, True)
+        assert not node.verifychain(2, 0, True)
+        info = node.getverifychaininfo()
+        assert_equal(info['running'], True)
+        assert_equal(info['paused'], True)
+        assert_equal(info['blocks'], 0)
+        with node.assert_debug_log([
+            "Resuming background chain verification at level 2, 0 of 200 blocks checked",
+            "Background chain verification of 200 blocks at level 2 found no errors",
+        ]):
+            self.restart_node(0)
+            assert_equal(self.wait_for_verification(node)['verified'], True)
+        # A finished verification isn't resumed
+        with node.assert_debug_log([], unexpected_msgs=["Resuming background chain verification"]):
+            self.restart_node(0)
+
+        self.log.info("Test that bad undo data is found")
+        self.stop_node(0)
+        with open(node.chain_path / 'blocks' / 'rev00000.dat', 'r+b') as f:
+            f.seek(1000)
+            byte = f.read(1)
+            f.seek(1000)
+            f.write(bytes([byte[0] ^ 1]))
+        self.start_node(0)
+        with node.assert_debug_log(["Background chain verification: *** found bad undo data"]):
+            assert node.verifychain(2, 0, True)
+            assert_equal(self.wait_for_verification(node)['verified'], False)
+        assert not node.verifychain(2, 0)
+
+
+if __name__ == '__main__':
+    VerifyChainTest().main()
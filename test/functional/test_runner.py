@@ -83,6 +83,7 @@ EXTENDED_SCRIPTS = [
     'feature_pruning.py',
     'feature_dbcrash.py',
     'feature_index_prune.py',
+    'feature_prune_plan.py',
 ]
 
 BASE_SCRIPTS = [
@@ -132,6 +133,7 @@ BASE_SCRIPTS = [
     'p2p_feefilter.py',
     'rpc_packages.py',
     'feature_reindex.py',
+    'feature_reindex_parallel.py',
     'feature_abortnode.py',
     # vv Tests less than 30s vv
     'wallet_keypool_topup.py --legacy-wallet',
@@ -189,6 +191,7 @@ BASE_SCRIPTS = [
     'p2p_headers_sync_with_minchainwork.py',
     'rpc_rawtransaction.py --legacy-wallet',
     'wallet_groups.py --legacy-wallet',
+    'wallet_fast_rescan.py --descriptors',
     'wallet_transactiontime_rescan.py --descriptors',
     'wallet_transactiontime_rescan.py --legacy-wallet',
     'p2p_addrv2_relay.py',
@@ -219,6 +222,7 @@ BASE_SCRIPTS = [
     'p2p_invalid_messages.py',
     'p2p_invalid_tx.py',
     'feature_assumevalid.py',
+    'feature_assumeutxo.py',
     'example_test.py',
     'wallet_txn_doublespend.py --legacy-wallet',
     'wallet_multisig_descriptor_psbt.py',
@@ -231,6 +235,7 @@ BASE_SCRIPTS = [
     'rpc_getblockfrompeer.py',
     'rpc_invalidateblock.py',
     'feature_utxo_set_hash.py',
+    'feature_utxostats.py',
     'feature_rbf.py',
     'mempool_packages.py',
     'mempool_package_onemore.py',
@@ -277,6 +282,7 @@ BASE_SCRIPTS = [
     'feature_dersig.py',
     'feature_cltv.py',
     'rpc_uptime.py',
+    'rpc_verifychain.py',
     'wallet_resendwallettransactions.py --legacy-wallet',
     'wallet_resendwallettransactions.py --descriptors',
     'wallet_fallbackfee.py --legacy-wallet',
@@ -316,6 +322,7 @@ BASE_SCRIPTS = [
     'rpc_deriveaddresses.py',
     'rpc_deriveaddresses.py --usecli',
     'p2p_ping.py',
+    'rpc_scanblocks.py',
     'rpc_scantxoutset.py',
     'feature_txindex_compatibility.py',
     'feature_unsupported_utxo_db.py',
@@ -328,6 +335,8 @@ BASE_SCRIPTS = [
     'p2p_node_network_limited.py',
     'p2p_permissions.py',
     'feature_blocksdir.py',
+    'feature_blockindex_snapshot.py',
+    'feature_blockcompression.py',
     'wallet_startup.py',
     'p2p_i2p_ports.py',
     'p2p_i2p_sessions.py',